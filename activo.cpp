@@ -1,22 +1,46 @@
 #include "activo.h"
 #include "exceptions.h"
+#include "resultado.h"
+#include "tasas_cambio.h"
 
-Activo::Activo(TipoActivo tipo, double cantidad) : tipo(tipo), cantidad(cantidad) {
-    if (cantidad < 0) {
+Activo::Activo(TipoActivo tipo, double cantidad) : Activo(tipo, Monto::desdeUnidades(cantidad)) {
+}
+
+Activo::Activo(TipoActivo tipo, Monto cantidad) : tipo(tipo), cantidad(cantidad) {
+    if (cantidad.esNegativo()) {
         throw DatosInvalidosException("La cantidad de activo no puede ser negativa");
     }
 }
 
+Resultado<Activo> Activo::intentarCrear(TipoActivo tipo, double cantidad) {
+    Resultado<Monto> monto = Monto::intentarDesdeUnidades(cantidad);
+    if (!monto) {
+        return monto.getError();
+    }
+    if (monto.valor().esNegativo()) {
+        return ErrorBoveda(CodigoError::DATOS_INVALIDOS, "La cantidad de activo no puede ser negativa");
+    }
+    return Activo(tipo, monto.valor());
+}
+
 TipoActivo Activo::getTipo() const {
     return tipo;
 }
 
-double Activo::getCantidad() const {
+Monto Activo::getMonto() const {
     return cantidad;
 }
 
+double Activo::getCantidad() const {
+    return cantidad.aDouble();
+}
+
 void Activo::setCantidad(double cantidad) {
-    if (cantidad < 0) {
+    setMonto(Monto::desdeUnidades(cantidad));
+}
+
+void Activo::setMonto(Monto cantidad) {
+    if (cantidad.esNegativo()) {
         throw DatosInvalidosException("La cantidad de activo no puede ser negativa");
     }
     this->cantidad = cantidad;
@@ -42,6 +66,14 @@ TipoActivo Activo::stringToTipoActivo(const std::string& str) {
     throw DatosInvalidosException("Tipo de activo desconocido: " + str);
 }
 
+std::size_t Activo::indice(TipoActivo tipo) {
+    return static_cast<std::size_t>(tipo);
+}
+
+double Activo::getTasaADolares(TipoActivo tipo) {
+    return ProveedorTasas::getGlobal().getActuales()->getTasa(tipo);
+}
+
 Activo Activo::operator+(const Activo& otro) const {
     if (tipo != otro.tipo) {
         throw OperacionInvalidaException("No se pueden sumar activos de diferentes tipos");
@@ -1,6 +1,8 @@
 #ifndef ACTIVO_H
 #define ACTIVO_H
 
+#include "monto.h"
+#include <cstddef>
 #include <string>
 
 enum class TipoActivo {
@@ -9,21 +11,35 @@ enum class TipoActivo {
     JOYAS
 };
 
+// Cantidad de tipos de activo; permite usar TipoActivo como índice de arreglos
+constexpr std::size_t NUM_TIPOS_ACTIVO = 3;
+
 class Activo {
 private:
     TipoActivo tipo;
-    double cantidad;
+    Monto cantidad;
 
 public:
     Activo(TipoActivo tipo, double cantidad);
+    Activo(TipoActivo tipo, Monto cantidad);
+    // Mismas reglas que Activo(tipo, cantidad), sin lanzar: DATOS_INVALIDOS
+    // si la cantidad está fuera de rango o es negativa
+    static Resultado<Activo> intentarCrear(TipoActivo tipo, double cantidad);
     
     TipoActivo getTipo() const;
-    double getCantidad() const;
+    Monto getMonto() const;
+    double getCantidad() const; // Solo para mostrar; los cálculos usan getMonto()
     void setCantidad(double cantidad);
+    void setMonto(Monto cantidad);
     
     std::string getTipoString() const;
     static std::string tipoActivoToString(TipoActivo tipo);
     static TipoActivo stringToTipoActivo(const std::string& str);
+    static std::size_t indice(TipoActivo tipo);
+    
+    // Tasa vigente en el proveedor global (ver tasas_cambio.h). Para valuar
+    // varios tipos con la misma época conviene tomar getActuales() una vez.
+    static double getTasaADolares(TipoActivo tipo);
     
     // Operadores para facilitar el manejo
     Activo operator+(const Activo& otro) const;
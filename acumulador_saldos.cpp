@@ -0,0 +1,99 @@
+#include "acumulador_saldos.h"
+#include "exceptions.h"
+#include "tasas_cambio.h"
+
+namespace {
+
+// fetch_add con desborde comprobado; false (sin tocar el total) si no cabe
+bool sumarSinDesborde(std::atomic<std::int64_t>& total, std::int64_t delta) {
+    std::int64_t actual = total.load(std::memory_order_relaxed);
+    std::int64_t nuevo;
+    do {
+        if (__builtin_add_overflow(actual, delta, &nuevo)) {
+            return false;
+        }
+    } while (!total.compare_exchange_weak(actual, nuevo, std::memory_order_relaxed));
+    return true;
+}
+
+} // namespace
+
+AcumuladorSaldos::AcumuladorSaldos() : padre(nullptr) {
+    for (auto& fragmento : fragmentos) {
+        for (auto& total : fragmento.totales) {
+            total.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+std::size_t AcumuladorSaldos::fragmentoDelHilo() {
+    // Cada hilo recibe un fragmento fijo al usar un acumulador por primera vez
+    static std::atomic<std::size_t> siguiente{0};
+    thread_local std::size_t fragmento = siguiente.fetch_add(1, std::memory_order_relaxed) % NUM_FRAGMENTOS;
+    return fragmento;
+}
+
+void AcumuladorSaldos::setPadre(AcumuladorSaldos* padre) {
+    SaldosBoveda actuales = getTotales();
+    if (this->padre) {
+        this->padre->restar(actuales);
+    }
+    this->padre = padre;
+    if (this->padre) {
+        this->padre->sumar(actuales);
+    }
+}
+
+void AcumuladorSaldos::aplicar(TipoActivo tipo, Monto delta) {
+    std::size_t i = Activo::indice(tipo);
+    std::size_t f = fragmentoDelHilo();
+    std::int64_t centesimas = delta.getCentesimas();
+    for (AcumuladorSaldos* nivel = this; nivel; nivel = nivel->padre) {
+        if (!sumarSinDesborde(nivel->fragmentos[f].totales[i], centesimas)) {
+            // Se deshace lo aplicado en los niveles de abajo antes de rechazar
+            for (AcumuladorSaldos* hecho = this; hecho != nivel; hecho = hecho->padre) {
+                hecho->fragmentos[f].totales[i].fetch_sub(centesimas, std::memory_order_relaxed);
+            }
+            throw DatosInvalidosException("El total acumulado de " + Activo::tipoActivoToString(tipo) + " se desbordaría");
+        }
+    }
+}
+
+void AcumuladorSaldos::sumar(const SaldosBoveda& saldos) {
+    for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+        aplicar(static_cast<TipoActivo>(i), saldos[i]);
+    }
+}
+
+void AcumuladorSaldos::restar(const SaldosBoveda& saldos) {
+    for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+        aplicar(static_cast<TipoActivo>(i), -saldos[i]);
+    }
+}
+
+Monto AcumuladorSaldos::getTotal(TipoActivo tipo) const {
+    std::size_t i = Activo::indice(tipo);
+    // Los fragmentos pueden tener signos distintos: se suman módulo 2^64 y el
+    // resultado es exacto siempre que el total quepa en 64 bits
+    std::uint64_t total = 0;
+    for (const auto& fragmento : fragmentos) {
+        total += static_cast<std::uint64_t>(fragmento.totales[i].load(std::memory_order_relaxed));
+    }
+    return Monto::desdeCentesimas(static_cast<std::int64_t>(total));
+}
+
+SaldosBoveda AcumuladorSaldos::getTotales() const {
+    SaldosBoveda totales;
+    for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+        totales[i] = getTotal(static_cast<TipoActivo>(i));
+    }
+    return totales;
+}
+
+double AcumuladorSaldos::getValorEnDolares() const {
+    return ProveedorTasas::getGlobal().getActuales()->valuar(getTotales());
+}
+
+bool AcumuladorSaldos::valuar(ValuacionSaldos& valuacion, const TasasCambio& tasas) const {
+    return valuacion.actualizar(getTotales(), tasas);
+}
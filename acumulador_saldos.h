@@ -0,0 +1,54 @@
+#ifndef ACUMULADOR_SALDOS_H
+#define ACUMULADOR_SALDOS_H
+
+#include "boveda.h"
+#include <atomic>
+#include <cstdint>
+
+class ValuacionSaldos;
+struct TasasCambio;
+
+// Totales acumulados por tipo de activo que se mantienen al día con deltas.
+// Cada bóveda reporta sus movimientos al acumulador de su banco y este los
+// propaga al del sistema, así que leer un total es O(1) sin importar la
+// cantidad de bóvedas.
+//
+// Es seguro para varios hilos: los deltas se suman atómicamente en un
+// fragmento elegido por hilo (cada uno en su propia línea de caché) para que
+// transferencias concurrentes en bóvedas distintas no compitan por el mismo
+// contador. La lectura suma los fragmentos.
+class AcumuladorSaldos {
+private:
+    static constexpr std::size_t NUM_FRAGMENTOS = 16;
+    
+    struct alignas(64) Fragmento {
+        std::array<std::atomic<std::int64_t>, NUM_TIPOS_ACTIVO> totales;
+    };
+    
+    std::array<Fragmento, NUM_FRAGMENTOS> fragmentos;
+    AcumuladorSaldos* padre;
+    
+    static std::size_t fragmentoDelHilo();
+
+public:
+    AcumuladorSaldos();
+    AcumuladorSaldos(const AcumuladorSaldos&) = delete;
+    AcumuladorSaldos& operator=(const AcumuladorSaldos&) = delete;
+    
+    // Encadena este acumulador a otro; sus totales actuales se trasladan.
+    // No debe llamarse mientras haya movimientos concurrentes.
+    void setPadre(AcumuladorSaldos* padre);
+    
+    // Aplica un delta (positivo o negativo) aquí y en toda la cadena de padres
+    void aplicar(TipoActivo tipo, Monto delta);
+    void sumar(const SaldosBoveda& saldos);
+    void restar(const SaldosBoveda& saldos);
+    
+    Monto getTotal(TipoActivo tipo) const;
+    SaldosBoveda getTotales() const;
+    double getValorEnDolares() const;
+    // Pone 'valuacion' al día con los totales actuales y 'tasas' (ver ValuacionSaldos)
+    bool valuar(ValuacionSaldos& valuacion, const TasasCambio& tasas) const;
+};
+
+#endif // ACUMULADOR_SALDOS_H
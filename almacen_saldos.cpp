@@ -0,0 +1,69 @@
+#include "almacen_saldos.h"
+#include "exceptions.h"
+#include "tasas_cambio.h"
+
+AlmacenSaldos::TotalesBanco::TotalesBanco() {
+    for (auto& total : centesimas) {
+        total.store(0, std::memory_order_relaxed);
+    }
+}
+
+void AlmacenSaldos::agregarBoveda(HandleBoveda handle, HandleBanco banco) {
+    if (handle != bancoDeBoveda.size()) {
+        throw ErrorInternoSistemaException("Las bóvedas deben agregarse al almacén en orden de handle");
+    }
+    for (auto& columna : columnas) {
+        columna.emplace_back(0);
+    }
+    bancoDeBoveda.push_back(banco);
+    while (totalesPorBanco.size() <= banco) {
+        totalesPorBanco.emplace_back();
+    }
+}
+
+std::size_t AlmacenSaldos::getCantidadBovedas() const {
+    return bancoDeBoveda.size();
+}
+
+Monto AlmacenSaldos::getSaldo(HandleBoveda handle, TipoActivo tipo) const {
+    return Monto::desdeCentesimas(columnas[Activo::indice(tipo)][handle].load(std::memory_order_relaxed));
+}
+
+void AlmacenSaldos::aplicarMovimiento(HandleBoveda handle, TipoActivo tipo, Monto delta) {
+    std::size_t i = Activo::indice(tipo);
+    // Solo el dueño de la fila escribe (con su mutex): no hace falta un fetch_add
+    std::atomic<std::int64_t>& celda = columnas[i][handle];
+    celda.store(celda.load(std::memory_order_relaxed) + delta.getCentesimas(), std::memory_order_relaxed);
+    totalesPorBanco[bancoDeBoveda[handle]].centesimas[i].fetch_add(delta.getCentesimas(), std::memory_order_relaxed);
+}
+
+Monto AlmacenSaldos::getTotalPorTipo(TipoActivo tipo) const {
+    std::int64_t total = 0;
+    for (const auto& celda : columnas[Activo::indice(tipo)]) {
+        total += celda.load(std::memory_order_relaxed);
+    }
+    return Monto::desdeCentesimas(total);
+}
+
+Monto AlmacenSaldos::getTotalPorTipo(TipoActivo tipo, HandleBanco banco) const {
+    if (banco >= totalesPorBanco.size()) {
+        return Monto();
+    }
+    return Monto::desdeCentesimas(totalesPorBanco[banco].centesimas[Activo::indice(tipo)].load(std::memory_order_relaxed));
+}
+
+double AlmacenSaldos::getValorTotalEnDolares() const {
+    SaldosBoveda totales;
+    for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+        totales[i] = getTotalPorTipo(static_cast<TipoActivo>(i));
+    }
+    return ProveedorTasas::getGlobal().getActuales()->valuar(totales);
+}
+
+double AlmacenSaldos::getValorBancoEnDolares(HandleBanco banco) const {
+    SaldosBoveda totales;
+    for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+        totales[i] = getTotalPorTipo(static_cast<TipoActivo>(i), banco);
+    }
+    return ProveedorTasas::getGlobal().getActuales()->valuar(totales);
+}
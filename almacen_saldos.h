@@ -0,0 +1,54 @@
+#ifndef ALMACEN_SALDOS_H
+#define ALMACEN_SALDOS_H
+
+#include "activo.h"
+#include "handles.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Almacén columnar (estructura de arreglos) de los saldos de todas las
+// bóvedas del sistema. Cada tipo de activo es una columna indexada por
+// HandleBoveda, de modo que el total del sistema por tipo de activo es una
+// reducción lineal. Los totales por banco se mantienen aparte al aplicar
+// cada movimiento, así que consultarlos no recorre las bóvedas.
+// Es un espejo: la bóveda conectada (Boveda::conectarAlmacen) sigue siendo
+// la dueña de sus saldos y le envía cada movimiento con su mutex tomado.
+// Las celdas son atómicas (accesos relajados) porque las lecturas no toman
+// esos mutex: leer con movimientos en curso es seguro, pero una reducción
+// solo es una foto consistente si no hay ninguno.
+class AlmacenSaldos {
+private:
+    struct TotalesBanco {
+        alignas(64) std::array<std::atomic<std::int64_t>, NUM_TIPOS_ACTIVO> centesimas;
+        TotalesBanco();
+    };
+    
+    // Columnas en centésimas; deque porque un atómico no se puede mover
+    std::array<std::deque<std::atomic<std::int64_t>>, NUM_TIPOS_ACTIVO> columnas;
+    std::vector<HandleBanco> bancoDeBoveda;
+    std::deque<TotalesBanco> totalesPorBanco; // Indexado por HandleBanco; no mueve sus elementos
+
+public:
+    // Reserva la fila de la bóveda (los handles deben agregarse en orden).
+    // No debe haber movimientos en curso.
+    void agregarBoveda(HandleBoveda handle, HandleBanco banco);
+    std::size_t getCantidadBovedas() const;
+    
+    // Acceso por fila
+    Monto getSaldo(HandleBoveda handle, TipoActivo tipo) const;
+    
+    // Refleja un movimiento de la bóveda. Dos movimientos de la misma bóveda
+    // no deben aplicarse a la vez; los de bóvedas distintas sí.
+    void aplicarMovimiento(HandleBoveda handle, TipoActivo tipo, Monto delta);
+    
+    // Reducciones
+    Monto getTotalPorTipo(TipoActivo tipo) const;
+    Monto getTotalPorTipo(TipoActivo tipo, HandleBanco banco) const; // O(1)
+    double getValorTotalEnDolares() const;
+    double getValorBancoEnDolares(HandleBanco banco) const;
+};
+
+#endif // ALMACEN_SALDOS_H
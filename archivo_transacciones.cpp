@@ -0,0 +1,252 @@
+#include "archivo_transacciones.h"
+#include "disco.h"
+#include "exceptions.h"
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+
+namespace {
+
+const char MAGIA[4] = {'B', 'V', 'D', 'A'};
+
+struct CabeceraArchivo {
+    char magia[4];
+    std::uint32_t version;
+    std::uint64_t finDatos;
+    std::uint64_t cantidadPorEstado[NUM_ESTADOS_TRANSACCION];
+};
+
+// Parte fija de cada registro; le siguen las seis cadenas en el orden de 'longitudes'
+struct RegistroFijo {
+    std::uint64_t numero;
+    std::int64_t centesimas;
+    double porcentajeComision;
+    double tasaADolares;
+    std::int64_t fechaCreacion;
+    std::int64_t fechaCompletada;
+    std::uint16_t longitudes[6];
+    std::uint8_t tipoActivo;
+    std::uint8_t estado;
+    std::uint8_t reservado[2];
+};
+
+void abrir(std::fstream& archivo, const std::string& ruta) {
+    // fstream no crea el archivo en modo lectura/escritura
+    if (!std::filesystem::exists(ruta)) {
+        std::ofstream(ruta, std::ios::binary);
+    }
+    archivo.open(ruta, std::ios::in | std::ios::out | std::ios::binary);
+    if (!archivo) {
+        throw ConfiguracionInvalidaException("No se pudo abrir el archivo de transacciones: " + ruta);
+    }
+}
+
+const std::string* cadenasDe(const TransaccionArchivada& t, std::size_t i) {
+    const std::string* cadenas[6] = {&t.bancoOrigenCodigo, &t.bovedaOrigenId, &t.bancoDestinoCodigo,
+                                     &t.bovedaDestinoId, &t.transportadora, &t.observaciones};
+    return cadenas[i];
+}
+
+std::string* cadenasDe(TransaccionArchivada& t, std::size_t i) {
+    return const_cast<std::string*>(cadenasDe(static_cast<const TransaccionArchivada&>(t), i));
+}
+
+} // namespace
+
+ArchivoTransacciones::ArchivoTransacciones(const std::string& ruta)
+    : ruta(ruta), finDatos(sizeof(CabeceraArchivo)), cantidadPorEstado{} {
+    bool creado = !std::filesystem::exists(ruta) || !std::filesystem::exists(ruta + ".idx");
+    abrir(datos, ruta);
+    abrir(indice, ruta + ".idx");
+    // La creación de los archivos tiene que sobrevivir a una caída antes de
+    // que se suelte de memoria algo que solo esté en ellos
+    if (creado && !sincronizarDirectorioDe(ruta)) {
+        throw ErrorInternoSistemaException("No se pudo crear el archivo de transacciones: " + ruta);
+    }
+
+    std::uintmax_t tamano = std::filesystem::file_size(ruta);
+    if (tamano == 0) {
+        escribirCabecera();
+        datos.flush();
+        if (!datos || !sincronizarArchivo(ruta)) {
+            throw ErrorInternoSistemaException("No se pudo crear el archivo de transacciones: " + ruta);
+        }
+        return;
+    }
+
+    CabeceraArchivo cabecera{};
+    datos.seekg(0);
+    if (!datos.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera)) ||
+        std::memcmp(cabecera.magia, MAGIA, sizeof(MAGIA)) != 0) {
+        throw ConfiguracionInvalidaException("El archivo no es un archivo de transacciones: " + ruta);
+    }
+    if (cabecera.version != VERSION) {
+        throw ConfiguracionInvalidaException("Versión de archivo de transacciones no soportada: " +
+                                             std::to_string(cabecera.version));
+    }
+    if (cabecera.finDatos < sizeof(CabeceraArchivo) || cabecera.finDatos > tamano) {
+        throw ConfiguracionInvalidaException("Archivo de transacciones corrupto: " + ruta);
+    }
+    finDatos = cabecera.finDatos;
+    std::copy(std::begin(cabecera.cantidadPorEstado), std::end(cabecera.cantidadPorEstado), cantidadPorEstado.begin());
+
+    // Registros de una pasada que no llegó a sincronizarse
+    if (tamano > finDatos) {
+        datos.close();
+        std::filesystem::resize_file(ruta, finDatos);
+        abrir(datos, ruta);
+    }
+}
+
+void ArchivoTransacciones::escribirCabecera() {
+    CabeceraArchivo cabecera{};
+    std::memcpy(cabecera.magia, MAGIA, sizeof(MAGIA));
+    cabecera.version = VERSION;
+    cabecera.finDatos = finDatos;
+    std::copy(cantidadPorEstado.begin(), cantidadPorEstado.end(), cabecera.cantidadPorEstado);
+    datos.seekp(0);
+    datos.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+}
+
+std::uint64_t ArchivoTransacciones::desplazamientoDe(std::uint64_t numero) const {
+    if (numero == 0) {
+        return 0;
+    }
+    std::uint64_t desplazamiento = 0;
+    indice.clear();
+    indice.seekg(static_cast<std::streamoff>((numero - 1) * sizeof(std::uint64_t)));
+    if (!indice.read(reinterpret_cast<char*>(&desplazamiento), sizeof(desplazamiento))) {
+        indice.clear();
+        return 0;
+    }
+    // El índice puede tener entradas de una pasada descartada: las que
+    // apuntan más allá de los datos o a un lugar ya reescrito por otro registro
+    if (desplazamiento < sizeof(CabeceraArchivo) || desplazamiento + sizeof(RegistroFijo) > finDatos) {
+        return 0;
+    }
+    std::uint64_t guardado = 0;
+    datos.clear();
+    datos.seekg(static_cast<std::streamoff>(desplazamiento + offsetof(RegistroFijo, numero)));
+    if (!datos.read(reinterpret_cast<char*>(&guardado), sizeof(guardado))) {
+        datos.clear();
+        return 0;
+    }
+    return guardado == numero ? desplazamiento : 0;
+}
+
+bool ArchivoTransacciones::agregar(const TransaccionArchivada& transaccion) {
+    if (transaccion.numero == 0) {
+        throw DatosInvalidosException("Número de transacción inválido para archivar");
+    }
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    if (desplazamientoDe(transaccion.numero) != 0) {
+        return false;
+    }
+
+    RegistroFijo fijo{};
+    fijo.numero = transaccion.numero;
+    fijo.centesimas = transaccion.centesimas;
+    fijo.porcentajeComision = transaccion.porcentajeComision;
+    fijo.tasaADolares = transaccion.tasaADolares;
+    fijo.fechaCreacion = transaccion.fechaCreacion;
+    fijo.fechaCompletada = transaccion.fechaCompletada;
+    fijo.tipoActivo = static_cast<std::uint8_t>(transaccion.tipoActivo);
+    fijo.estado = static_cast<std::uint8_t>(transaccion.estado);
+    std::string cadenas;
+    for (std::size_t i = 0; i < 6; ++i) {
+        const std::string& cadena = *cadenasDe(transaccion, i);
+        // Recortarla cambiaría lo archivado sin avisar; se rechaza antes de escribir nada
+        if (cadena.size() > UINT16_MAX) {
+            throw DatosInvalidosException("Cadena demasiado larga para archivar la transacción " +
+                                          std::to_string(transaccion.numero) + " (" + std::to_string(cadena.size()) +
+                                          " bytes, máximo " + std::to_string(UINT16_MAX) + ")");
+        }
+        fijo.longitudes[i] = static_cast<std::uint16_t>(cadena.size());
+        cadenas.append(cadena);
+    }
+
+    std::uint64_t desplazamiento = finDatos;
+    datos.clear();
+    datos.seekp(static_cast<std::streamoff>(desplazamiento));
+    datos.write(reinterpret_cast<const char*>(&fijo), sizeof(fijo));
+    datos.write(cadenas.data(), static_cast<std::streamsize>(cadenas.size()));
+    indice.clear();
+    indice.seekp(static_cast<std::streamoff>((transaccion.numero - 1) * sizeof(std::uint64_t)));
+    indice.write(reinterpret_cast<const char*>(&desplazamiento), sizeof(desplazamiento));
+    if (!datos || !indice) {
+        throw ErrorInternoSistemaException("No se pudo escribir en el archivo de transacciones: " + ruta);
+    }
+
+    finDatos += sizeof(fijo) + cadenas.size();
+    ++cantidadPorEstado[static_cast<std::size_t>(transaccion.estado)];
+    return true;
+}
+
+bool ArchivoTransacciones::contiene(std::uint64_t numero) const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    return desplazamientoDe(numero) != 0;
+}
+
+bool ArchivoTransacciones::leer(std::uint64_t numero, TransaccionArchivada& destino) const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    std::uint64_t desplazamiento = desplazamientoDe(numero);
+    if (desplazamiento == 0) {
+        return false;
+    }
+
+    RegistroFijo fijo{};
+    datos.clear();
+    datos.seekg(static_cast<std::streamoff>(desplazamiento));
+    if (!datos.read(reinterpret_cast<char*>(&fijo), sizeof(fijo)) || fijo.numero != numero ||
+        fijo.tipoActivo >= NUM_TIPOS_ACTIVO || fijo.estado >= NUM_ESTADOS_TRANSACCION) {
+        throw ConfiguracionInvalidaException("Archivo de transacciones corrupto en la transacción " + std::to_string(numero));
+    }
+    destino.numero = fijo.numero;
+    destino.centesimas = fijo.centesimas;
+    destino.porcentajeComision = fijo.porcentajeComision;
+    destino.tasaADolares = fijo.tasaADolares;
+    destino.fechaCreacion = fijo.fechaCreacion;
+    destino.fechaCompletada = fijo.fechaCompletada;
+    destino.tipoActivo = static_cast<TipoActivo>(fijo.tipoActivo);
+    destino.estado = static_cast<EstadoTransaccion>(fijo.estado);
+    for (std::size_t i = 0; i < 6; ++i) {
+        std::string& cadena = *cadenasDe(destino, i);
+        cadena.resize(fijo.longitudes[i]);
+        if (!datos.read(&cadena[0], fijo.longitudes[i])) {
+            throw ConfiguracionInvalidaException("Archivo de transacciones corrupto en la transacción " + std::to_string(numero));
+        }
+    }
+    return true;
+}
+
+void ArchivoTransacciones::sincronizar() {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    // Primero los registros y el índice en disco, después la cabecera que los
+    // confirma: al volver, el llamador puede soltar de memoria lo archivado
+    datos.flush();
+    indice.flush();
+    if (!datos || !indice || !sincronizarArchivo(ruta) || !sincronizarArchivo(ruta + ".idx")) {
+        throw ErrorInternoSistemaException("No se pudo sincronizar el archivo de transacciones: " + ruta);
+    }
+    datos.clear();
+    escribirCabecera();
+    datos.flush();
+    if (!datos || !sincronizarArchivo(ruta)) {
+        throw ErrorInternoSistemaException("No se pudo sincronizar el archivo de transacciones: " + ruta);
+    }
+}
+
+std::uint64_t ArchivoTransacciones::getCantidad() const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    return std::accumulate(cantidadPorEstado.begin(), cantidadPorEstado.end(), std::uint64_t(0));
+}
+
+std::uint64_t ArchivoTransacciones::getCantidad(EstadoTransaccion estado) const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    return cantidadPorEstado[static_cast<std::size_t>(estado)];
+}
+
+const std::string& ArchivoTransacciones::getRuta() const {
+    return ruta;
+}
@@ -0,0 +1,74 @@
+#ifndef ARCHIVO_TRANSACCIONES_H
+#define ARCHIVO_TRANSACCIONES_H
+
+#include "transaccion.h"
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+// Transacción terminada tal como se guarda en el archivo
+struct TransaccionArchivada {
+    std::uint64_t numero = 0;
+    std::string bancoOrigenCodigo;
+    std::string bovedaOrigenId;
+    std::string bancoDestinoCodigo;
+    std::string bovedaDestinoId;
+    std::string transportadora;
+    std::string observaciones;
+    TipoActivo tipoActivo = TipoActivo::SOLES;
+    std::int64_t centesimas = 0;
+    double porcentajeComision = 0;
+    double tasaADolares = 0;          // La congelada en la transacción
+    std::int64_t fechaCreacion = 0;   // Nanosegundos desde la época de system_clock
+    std::int64_t fechaCompletada = 0;
+    EstadoTransaccion estado = EstadoTransaccion::COMPLETADA;
+};
+
+// Archivo en disco de transacciones terminadas, consultable por número.
+// Son dos archivos: 'ruta' guarda los registros uno tras otro (parte fija +
+// cadenas) y 'ruta.idx' el desplazamiento de cada uno en la posición
+// numero - 1, así que una consulta son dos lecturas y no hace falta ningún
+// índice en memoria. La cabecera de 'ruta' dice hasta dónde llegan los datos
+// confirmados por el último sincronizar(), que deja los dos archivos en disco
+// antes de volver; lo que haya después (una pasada interrumpida) se descarta
+// al abrir y se vuelve a escribir. Cada consulta comprueba el número guardado
+// en el registro, así que el índice puede conservar entradas de esa pasada.
+// Las cadenas de más de 65535 bytes se rechazan (no se recortan).
+// Los métodos pueden llamarse desde varios hilos.
+class ArchivoTransacciones {
+private:
+    mutable std::mutex mutex;
+    std::string ruta;
+    mutable std::fstream datos;
+    mutable std::fstream indice;
+    std::uint64_t finDatos; // Fin de los registros escritos (confirmados o no)
+    std::array<std::uint64_t, NUM_ESTADOS_TRANSACCION> cantidadPorEstado;
+
+    std::uint64_t desplazamientoDe(std::uint64_t numero) const;
+    void escribirCabecera();
+
+public:
+    // 2: tasa congelada de cada transacción
+    static constexpr std::uint32_t VERSION = 2;
+
+    explicit ArchivoTransacciones(const std::string& ruta);
+
+    ArchivoTransacciones(const ArchivoTransacciones&) = delete;
+    ArchivoTransacciones& operator=(const ArchivoTransacciones&) = delete;
+
+    // Devuelve false si la transacción ya estaba archivada
+    bool agregar(const TransaccionArchivada& transaccion);
+    bool contiene(std::uint64_t numero) const;
+    // Devuelve false si el número no está archivado
+    bool leer(std::uint64_t numero, TransaccionArchivada& destino) const;
+    // Confirma lo agregado hasta ahora
+    void sincronizar();
+
+    std::uint64_t getCantidad() const;
+    std::uint64_t getCantidad(EstadoTransaccion estado) const;
+    const std::string& getRuta() const;
+};
+
+#endif // ARCHIVO_TRANSACCIONES_H
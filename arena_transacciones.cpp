@@ -0,0 +1,84 @@
+#include "arena_transacciones.h"
+#include "exceptions.h"
+#include <algorithm>
+#include <new>
+
+ArenaTransacciones::ArenaTransacciones()
+    : bloques(new std::atomic<Bloque*>[MAX_BLOQUES]), tamano(0), bloquesLiberados(0) {
+    for (std::size_t i = 0; i < MAX_BLOQUES; ++i) {
+        bloques[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ArenaTransacciones::~ArenaTransacciones() {
+    // Un bloque puede existir sin transacciones si el constructor lanzó al estrenarlo
+    std::size_t usados = (tamano.load(std::memory_order_relaxed) + TAM_BLOQUE - 1) >> BITS_BLOQUE;
+    for (std::size_t b = bloquesLiberados; b < MAX_BLOQUES; ++b) {
+        if (b >= usados && !bloques[b].load(std::memory_order_relaxed)) {
+            break;
+        }
+        liberarBloque(b);
+    }
+}
+
+void ArenaTransacciones::liberarBloque(std::size_t b) {
+    Bloque* bloque = bloques[b].exchange(nullptr, std::memory_order_acq_rel);
+    if (!bloque) {
+        return;
+    }
+    std::size_t total = tamano.load(std::memory_order_relaxed);
+    std::size_t inicio = b << BITS_BLOQUE;
+    for (std::size_t i = inicio; i < total && i < inicio + TAM_BLOQUE; ++i) {
+        bloque->calientes[i - inicio].~Transaccion();
+    }
+    std::allocator<Transaccion>().deallocate(bloque->calientes, TAM_BLOQUE);
+    delete bloque;
+}
+
+void ArenaTransacciones::liberarHasta(std::size_t limite) {
+    std::size_t completos = std::min(limite, tamano.load(std::memory_order_relaxed)) >> BITS_BLOQUE;
+    for (; bloquesLiberados < completos; ++bloquesLiberados) {
+        liberarBloque(bloquesLiberados);
+    }
+}
+
+void ArenaTransacciones::descartarDesde(std::size_t inicio) {
+    std::size_t total = tamano.load(std::memory_order_relaxed);
+    for (std::size_t i = inicio; i < total; ++i) {
+        Bloque* bloque = bloques[i >> BITS_BLOQUE].load(std::memory_order_relaxed);
+        bloque->calientes[i & (TAM_BLOQUE - 1)].~Transaccion();
+    }
+    if (inicio < total) {
+        tamano.store(inicio, std::memory_order_release);
+    }
+}
+
+Transaccion* ArenaTransacciones::crear(const std::string& id,
+                                       std::string_view bancoOrigenCodigo,
+                                       std::string_view bovedaOrigenId,
+                                       std::string_view bancoDestinoCodigo,
+                                       std::string_view bovedaDestinoId,
+                                       const Activo& activo,
+                                       std::string_view transportadora,
+                                       double porcentajeComision) {
+    std::size_t i = tamano.load(std::memory_order_relaxed);
+    std::size_t b = i >> BITS_BLOQUE;
+    if (b >= MAX_BLOQUES) {
+        throw ErrorInternoSistemaException("Se alcanzó la capacidad máxima de transacciones");
+    }
+    Bloque* bloque = bloques[b].load(std::memory_order_relaxed);
+    if (!bloque) {
+        auto nuevo = std::make_unique<Bloque>();
+        nuevo->frios = std::make_unique<DatosFriosTransaccion[]>(TAM_BLOQUE);
+        nuevo->calientes = std::allocator<Transaccion>().allocate(TAM_BLOQUE);
+        bloque = nuevo.release();
+        bloques[b].store(bloque, std::memory_order_release);
+    }
+
+    std::size_t posicion = i & (TAM_BLOQUE - 1);
+    Transaccion* transaccion = new (bloque->calientes + posicion) Transaccion(
+        bloque->frios[posicion], id, bancoOrigenCodigo, bovedaOrigenId,
+        bancoDestinoCodigo, bovedaDestinoId, activo, transportadora, porcentajeComision);
+    tamano.store(i + 1, std::memory_order_release);
+    return transaccion;
+}
@@ -0,0 +1,72 @@
+#ifndef ARENA_TRANSACCIONES_H
+#define ARENA_TRANSACCIONES_H
+
+#include "transaccion.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Almacén de transacciones por bloques (slabs) de tamaño fijo. Cada bloque
+// reserva de una vez el espacio de TAM_BLOQUE transacciones (solo los datos
+// calientes, contiguos) y una tabla paralela con sus datos fríos, así que
+// crear una transacción no pide memoria al sistema y recorrerlas en orden
+// lee memoria contigua. Las transacciones nunca se mueven: el puntero y la
+// posición sirven de handle estable.
+// Como VectorSegmentado: un único escritor a la vez (el llamador serializa
+// crear()) y lecturas sin bloqueos de cualquier posición menor a size().
+class ArenaTransacciones {
+private:
+    static constexpr std::size_t BITS_BLOQUE = 12;
+    static constexpr std::size_t TAM_BLOQUE = std::size_t(1) << BITS_BLOQUE;
+    static constexpr std::size_t MAX_BLOQUES = std::size_t(1) << 14;
+
+    struct Bloque {
+        Transaccion* calientes; // Memoria sin construir; se construye al crear
+        std::unique_ptr<DatosFriosTransaccion[]> frios;
+    };
+
+    std::unique_ptr<std::atomic<Bloque*>[]> bloques;
+    std::atomic<std::size_t> tamano;
+    std::size_t bloquesLiberados;
+
+    void liberarBloque(std::size_t b);
+
+public:
+    ArenaTransacciones();
+    ~ArenaTransacciones();
+
+    ArenaTransacciones(const ArenaTransacciones&) = delete;
+    ArenaTransacciones& operator=(const ArenaTransacciones&) = delete;
+
+    // Construye la transacción en la siguiente posición; si el constructor
+    // lanza, la posición queda libre. Solo un escritor a la vez.
+    Transaccion* crear(const std::string& id,
+                       std::string_view bancoOrigenCodigo,
+                       std::string_view bovedaOrigenId,
+                       std::string_view bancoDestinoCodigo,
+                       std::string_view bovedaDestinoId,
+                       const Activo& activo,
+                       std::string_view transportadora,
+                       double porcentajeComision);
+
+    Transaccion* operator[](std::size_t i) const {
+        return bloques[i >> BITS_BLOQUE].load(std::memory_order_acquire)->calientes + (i & (TAM_BLOQUE - 1));
+    }
+
+    std::size_t size() const {
+        return tamano.load(std::memory_order_acquire);
+    }
+
+    // Destruye las transacciones desde la posición 'inicio' en adelante y la
+    // deja como la siguiente libre. Solo para deshacer altas que todavía no
+    // se publicaron a ningún lector; un escritor a la vez, como crear().
+    void descartarDesde(std::size_t inicio);
+    
+    // Destruye las transacciones de los bloques que quedan enteros por debajo
+    // de 'limite' y devuelve su memoria. No debe haber lectores en curso.
+    void liberarHasta(std::size_t limite);
+};
+
+#endif // ARENA_TRANSACCIONES_H
@@ -1,10 +1,11 @@
 #include "banco.h"
+#include "almacen_saldos.h"
 #include "exceptions.h"
 #include <sstream>
 #include <iomanip>
 
 Banco::Banco(const std::string& nombre, const std::string& codigo) 
-    : nombre(nombre), codigo(codigo) {
+    : nombre(nombre), codigo(codigo), observador(nullptr), almacen(nullptr), handle(0), bovedasEnAlmacen(0) {
 }
 
 std::string Banco::getNombre() const {
@@ -25,41 +26,89 @@ void Banco::agregarBoveda(std::unique_ptr<Boveda> boveda) {
     }
     
     // Verificar que no existe una bóveda con el mismo ID
-    for (const auto& b : bovedas) {
-        if (b->getId() == boveda->getId()) {
-            throw OperacionInvalidaException("Ya existe una bóveda con ID: " + boveda->getId());
-        }
+    auto [it, insertado] = indiceBovedas.emplace(boveda->getId(), boveda.get());
+    if (!insertado) {
+        throw OperacionInvalidaException("Ya existe una bóveda con ID: " + boveda->getId());
     }
     
+    boveda->setCodigoBanco(codigo);
+    boveda->setAcumulador(&totales);
+    boveda->setObservador(observador);
     bovedas.push_back(std::move(boveda));
 }
 
 Boveda* Banco::buscarBoveda(const std::string& idBoveda) {
+    return intentarBuscarBoveda(idBoveda).valor();
+}
+
+const Boveda* Banco::buscarBoveda(const std::string& idBoveda) const {
+    return intentarBuscarBoveda(idBoveda).valor();
+}
+
+Resultado<Boveda*> Banco::intentarBuscarBoveda(const std::string& idBoveda) {
+    auto it = indiceBovedas.find(idBoveda);
+    if (it == indiceBovedas.end()) {
+        return ErrorBoveda(CodigoError::BOVEDA_NO_ENCONTRADA, idBoveda);
+    }
+    return it->second;
+}
+
+Resultado<const Boveda*> Banco::intentarBuscarBoveda(const std::string& idBoveda) const {
+    auto it = indiceBovedas.find(idBoveda);
+    if (it == indiceBovedas.end()) {
+        return ErrorBoveda(CodigoError::BOVEDA_NO_ENCONTRADA, idBoveda);
+    }
+    return static_cast<const Boveda*>(it->second);
+}
+
+void Banco::setObservador(ObservadorBoveda* observador) {
+    this->observador = observador;
     for (auto& boveda : bovedas) {
-        if (boveda->getId() == idBoveda) {
-            return boveda.get();
-        }
+        boveda->setObservador(observador);
     }
-    throw BovedaNoEncontradaException("Bóveda no encontrada: " + idBoveda);
 }
 
-const Boveda* Banco::buscarBoveda(const std::string& idBoveda) const {
+void Banco::conectarAlmacen(AlmacenSaldos* almacen, HandleBanco handle) {
+    this->almacen = almacen;
+    this->handle = handle;
+    
+    bovedasEnAlmacen = 0;
     for (const auto& boveda : bovedas) {
-        if (boveda->getId() == idBoveda) {
-            return boveda.get();
+        if (almacen && boveda->getAlmacen() == almacen) {
+            ++bovedasEnAlmacen;
         }
     }
-    throw BovedaNoEncontradaException("Bóveda no encontrada: " + idBoveda);
 }
 
-double Banco::getActivosTotales() const {
-    double total = 0.0;
+Monto Banco::getTotalPorTipo(TipoActivo tipo) const {
+    return totales.getTotal(tipo);
+}
+
+AcumuladorSaldos& Banco::getAcumulador() {
+    return totales;
+}
+
+Monto Banco::recalcularTotalPorTipo(TipoActivo tipo) const {
+    // Si una bóveda se agregó después de conectar, se recorre el banco completo
+    if (almacen && bovedasEnAlmacen == bovedas.size()) {
+        return almacen->getTotalPorTipo(tipo, handle);
+    }
+    
+    Monto total;
     for (const auto& boveda : bovedas) {
-        total += boveda->getValorTotalEnDolares();
+        total += boveda->getSaldo(tipo);
     }
     return total;
 }
 
+double Banco::getActivosTotales() const {
+    return totales.getValorEnDolares();
+}
+
+bool Banco::valuar(ValuacionSaldos& valuacion, const TasasCambio& tasas) const {
+    return totales.valuar(valuacion, tasas);
+}
+
 std::string Banco::getResumen() const {
     std::stringstream ss;
     ss << std::fixed << std::setprecision(2);
@@ -77,19 +126,31 @@ std::string Banco::getResumen() const {
 void Banco::transferirEntreBovedas(const std::string& bovedaOrigenId, 
                                   const std::string& bovedaDestinoId, 
                                   const Activo& activo) {
+    intentarTransferirEntreBovedas(bovedaOrigenId, bovedaDestinoId, activo).valor();
+}
+
+Resultado<void> Banco::intentarTransferirEntreBovedas(const std::string& bovedaOrigenId,
+                                                      const std::string& bovedaDestinoId,
+                                                      const Activo& activo) {
     if (bovedaOrigenId == bovedaDestinoId) {
-        throw OperacionInvalidaException("La bóveda de origen no puede ser la misma que la de destino");
+        return ErrorBoveda(CodigoError::OPERACION_INVALIDA, "La bóveda de origen no puede ser la misma que la de destino");
     }
     
-    Boveda* origen = buscarBoveda(bovedaOrigenId);
-    Boveda* destino = buscarBoveda(bovedaDestinoId);
+    Resultado<Boveda*> origen = intentarBuscarBoveda(bovedaOrigenId);
+    if (!origen) {
+        return origen.getError();
+    }
+    Resultado<Boveda*> destino = intentarBuscarBoveda(bovedaDestinoId);
+    if (!destino) {
+        return destino.getError();
+    }
     
     // Verificar que la bóveda de origen tiene suficientes activos
-    if (!origen->tieneActivo(activo)) {
-        throw SaldoInsuficienteException("Bóveda de origen no tiene suficientes activos");
+    if (!origen.valor()->tieneActivo(activo)) {
+        return ErrorBoveda(CodigoError::SALDO_INSUFICIENTE, "Bóveda de origen no tiene suficientes activos");
     }
     
-    // Realizar la transferencia
-    origen->retirarActivo(activo);
-    destino->agregarActivo(activo);
+    // Realizar la transferencia (ambas bóvedas bloqueadas en orden global;
+    // el saldo se vuelve a verificar dentro del bloqueo)
+    return Boveda::intentarTransferir(*origen.valor(), *destino.valor(), activo);
 }
@@ -1,16 +1,26 @@
 #ifndef BANCO_H
 #define BANCO_H
 
+#include "acumulador_saldos.h"
 #include "boveda.h"
 #include <vector>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 class Banco {
 private:
     std::string nombre;
     std::string codigo;
     std::vector<std::unique_ptr<Boveda>> bovedas;
+    std::unordered_map<std::string, Boveda*> indiceBovedas;
+    AcumuladorSaldos totales; // Se actualiza con cada movimiento de sus bóvedas
+    ObservadorBoveda* observador; // Se asigna a cada bóveda agregada
+    
+    // Almacén columnar (opcional); solo se usa si todas las bóvedas están conectadas
+    AlmacenSaldos* almacen;
+    HandleBanco handle;
+    std::size_t bovedasEnAlmacen;
 
 public:
     Banco(const std::string& nombre, const std::string& codigo);
@@ -25,15 +35,35 @@ public:
     void agregarBoveda(std::unique_ptr<Boveda> boveda);
     Boveda* buscarBoveda(const std::string& idBoveda);
     const Boveda* buscarBoveda(const std::string& idBoveda) const;
+    Resultado<Boveda*> intentarBuscarBoveda(const std::string& idBoveda);
+    Resultado<const Boveda*> intentarBuscarBoveda(const std::string& idBoveda) const;
+    
+    // Observador de movimientos para todas las bóvedas, actuales y futuras
+    void setObservador(ObservadorBoveda* observador);
+    
+    // Almacén columnar: las bóvedas deben conectarse antes que el banco
+    void conectarAlmacen(AlmacenSaldos* almacen, HandleBanco handle);
     
-    // Cálculos
+    // Cálculos (O(1): leen los totales incrementales)
+    Monto getTotalPorTipo(TipoActivo tipo) const;
     double getActivosTotales() const;
+    // Pone 'valuacion' al día con los totales del banco y 'tasas' (ver ValuacionSaldos)
+    bool valuar(ValuacionSaldos& valuacion, const TasasCambio& tasas) const;
+    
+    // Totales del banco; el sistema encadena aquí su propio acumulador
+    AcumuladorSaldos& getAcumulador();
+    
+    // Suma exacta desde los saldos de cada bóveda, para verificar los totales
+    Monto recalcularTotalPorTipo(TipoActivo tipo) const;
     std::string getResumen() const;
     
     // Operaciones
     void transferirEntreBovedas(const std::string& bovedaOrigenId, 
                                const std::string& bovedaDestinoId, 
                                const Activo& activo);
+    Resultado<void> intentarTransferirEntreBovedas(const std::string& bovedaOrigenId,
+                                                   const std::string& bovedaDestinoId,
+                                                   const Activo& activo);
 };
 
 #endif // BANCO_H
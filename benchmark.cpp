@@ -0,0 +1,459 @@
+// Micro-benchmarks de las operaciones del núcleo. Cada caso se mide sobre
+// una topología sintética (bancos x bóvedas por banco) con un historial
+// inicial de transacciones, para cada combinación de tamaños pedida. El
+// resultado sale en JSON con claves estables ("id") para que un script de
+// regresión pueda comparar dos commits.
+
+#include "sistema_bovedas.h"
+#include "generador_topologia.h"
+#include "exceptions.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef BOVEDAS_TIPO_COMPILACION
+#define BOVEDAS_TIPO_COMPILACION ""
+#endif
+
+namespace {
+
+using Reloj = std::chrono::steady_clock;
+
+struct ConfiguracionBenchmark {
+    std::vector<std::size_t> bancos = {2, 16};
+    std::vector<std::size_t> bovedasPorBanco = {4, 64};
+    std::vector<std::size_t> historial = {1000, 100000};
+    double tiempoMinimo = 0.1; // Segundos por repetición
+    std::size_t repeticiones = 5;
+    std::string filtro;        // Solo los casos cuyo nombre lo contiene
+    std::string rutaSalida;    // Vacía: salida estándar
+    std::uint32_t semilla = 42;
+};
+
+struct ExtremoBenchmark {
+    Banco* banco;
+    std::string codigoBanco;
+    std::string idBoveda;
+    Boveda* boveda;
+};
+
+// Sistema con la topología y el historial de una combinación de tamaños
+struct Escenario {
+    std::size_t bancos;
+    std::size_t bovedasPorBanco;
+    std::size_t historial;
+    std::unique_ptr<SistemaBovedas> sistema;
+    std::vector<ExtremoBenchmark> extremos;
+    std::vector<std::string> ids;        // Transacciones del historial inicial
+    std::vector<std::string> pendientes; // Creadas y sin procesar, para procesarTransaccion
+    std::mt19937 generador;
+};
+
+// Evita que el compilador descarte los resultados medidos
+volatile std::size_t sumidero = 0;
+
+// Salida de reportes que solo cuenta los bytes: mide el formateo, no la E/S
+class SalidaDescartada : public SalidaReporte {
+public:
+    std::size_t bytes = 0;
+    void escribir(const char*, std::size_t longitud) override { bytes += longitud; }
+};
+
+// Mide 'iteraciones' operaciones y devuelve los nanosegundos que tomaron;
+// la preparación (fuera del cronómetro) es responsabilidad del caso
+using FuncionMedicion = std::function<std::int64_t(Escenario&, std::size_t iteraciones)>;
+
+struct CasoBenchmark {
+    std::string nombre;
+    bool dependeDelHistorial; // Si no, se mide solo con el primer tamaño de historial
+    FuncionMedicion medir;
+};
+
+struct ResultadoBenchmark {
+    std::string nombre;
+    std::size_t bancos;
+    std::size_t bovedasPorBanco;
+    std::size_t historial;
+    std::size_t iteraciones;
+    double nsMediana;
+    double nsMinimo;
+    double nsMaximo;
+};
+
+std::int64_t nanosDesde(Reloj::time_point inicio) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Reloj::now() - inicio).count();
+}
+
+std::vector<std::size_t> leerLista(const std::string& texto) {
+    std::vector<std::size_t> valores;
+    std::stringstream ss(texto);
+    std::string parte;
+    while (std::getline(ss, parte, ',')) {
+        valores.push_back(std::stoull(parte));
+    }
+    if (valores.empty()) {
+        throw std::invalid_argument("lista vacía");
+    }
+    return valores;
+}
+
+std::size_t indiceAleatorio(std::mt19937& generador, std::size_t cantidad) {
+    return std::uniform_int_distribution<std::size_t>(0, cantidad - 1)(generador);
+}
+
+std::pair<const ExtremoBenchmark*, const ExtremoBenchmark*> parAleatorio(Escenario& escenario) {
+    std::size_t origen = indiceAleatorio(escenario.generador, escenario.extremos.size());
+    std::size_t destino = indiceAleatorio(escenario.generador, escenario.extremos.size() - 1);
+    if (destino >= origen) {
+        ++destino; // Distinto del origen
+    }
+    return {&escenario.extremos[origen], &escenario.extremos[destino]};
+}
+
+// Crea 'cantidad' transacciones en lotes; las devuelve sin procesar
+std::vector<std::string> crearTransacciones(Escenario& escenario, std::size_t cantidad) {
+    constexpr std::size_t TAMANO_LOTE = 10000;
+    std::vector<std::string> creadas;
+    creadas.reserve(cantidad);
+    while (creadas.size() < cantidad) {
+        std::vector<SolicitudTransferencia> lote;
+        std::size_t enLote = std::min(TAMANO_LOTE, cantidad - creadas.size());
+        lote.reserve(enLote);
+        for (std::size_t i = 0; i < enLote; ++i) {
+            auto [origen, destino] = parAleatorio(escenario);
+            lote.push_back({origen->codigoBanco, origen->idBoveda, destino->codigoBanco, destino->idBoveda,
+                            static_cast<TipoActivo>(i % NUM_TIPOS_ACTIVO), 1.0});
+        }
+        for (ResultadoTransferencia& resultado : escenario.sistema->iniciarTransferenciasLote(lote)) {
+            creadas.push_back(std::move(resultado.transaccionId));
+        }
+    }
+    return creadas;
+}
+
+Escenario crearEscenario(std::size_t bancos, std::size_t bovedasPorBanco, std::size_t historial, std::uint32_t semilla) {
+    Escenario escenario{bancos, bovedasPorBanco, historial, std::make_unique<SistemaBovedas>(), {}, {}, {},
+                        std::mt19937(semilla)};
+    // Saldo de sobra para que ninguna transferencia se rechace
+    ConfiguracionTopologia topologia;
+    topologia.bancos = bancos;
+    topologia.bovedasPorBanco = bovedasPorBanco;
+    topologia.semilla = semilla;
+    topologia.valorMinimoBanco = 1e9 * static_cast<double>(bovedasPorBanco);
+    topologia.valorMaximoBanco = topologia.valorMinimoBanco;
+    GeneradorTopologia(topologia).generar(*escenario.sistema);
+    for (const auto& [codigo, banco] : escenario.sistema->getBancos()) {
+        for (const auto& boveda : banco->getBovedas()) {
+            escenario.extremos.push_back({banco.get(), codigo, boveda->getId(), boveda.get()});
+        }
+    }
+
+    // Historial con estados mezclados: se completa una de cada dos
+    escenario.ids = crearTransacciones(escenario, historial);
+    for (std::size_t i = 0; i < escenario.ids.size(); i += 2) {
+        escenario.sistema->procesarTransaccion(escenario.ids[i]);
+    }
+    return escenario;
+}
+
+std::vector<CasoBenchmark> crearCasos() {
+    std::vector<CasoBenchmark> casos;
+
+    casos.push_back({"SistemaBovedas::buscarTransaccion", true, [](Escenario& escenario, std::size_t iteraciones) {
+        if (escenario.ids.empty()) {
+            return std::int64_t(-1); // Sin historial no hay qué buscar
+        }
+        std::vector<const std::string*> ids;
+        ids.reserve(iteraciones);
+        for (std::size_t i = 0; i < iteraciones; ++i) {
+            ids.push_back(&escenario.ids[indiceAleatorio(escenario.generador, escenario.ids.size())]);
+        }
+        std::size_t suma = 0;
+        Reloj::time_point inicio = Reloj::now();
+        for (const std::string* id : ids) {
+            suma += static_cast<std::size_t>(escenario.sistema->buscarTransaccion(*id)->getEstado());
+        }
+        std::int64_t nanos = nanosDesde(inicio);
+        sumidero = sumidero + suma;
+        return nanos;
+    }});
+
+    casos.push_back({"Banco::buscarBoveda", false, [](Escenario& escenario, std::size_t iteraciones) {
+        std::vector<const ExtremoBenchmark*> extremos;
+        extremos.reserve(iteraciones);
+        for (std::size_t i = 0; i < iteraciones; ++i) {
+            extremos.push_back(&escenario.extremos[indiceAleatorio(escenario.generador, escenario.extremos.size())]);
+        }
+        std::size_t suma = 0;
+        Reloj::time_point inicio = Reloj::now();
+        for (const ExtremoBenchmark* extremo : extremos) {
+            suma += reinterpret_cast<std::uintptr_t>(extremo->banco->buscarBoveda(extremo->idBoveda));
+        }
+        std::int64_t nanos = nanosDesde(inicio);
+        sumidero = sumidero + suma;
+        return nanos;
+    }});
+
+    casos.push_back({"Boveda::getValorTotalEnDolares", false, [](Escenario& escenario, std::size_t iteraciones) {
+        double suma = 0.0;
+        std::size_t cantidad = escenario.extremos.size();
+        Reloj::time_point inicio = Reloj::now();
+        for (std::size_t i = 0; i < iteraciones; ++i) {
+            suma += escenario.extremos[i % cantidad].boveda->getValorTotalEnDolares();
+        }
+        std::int64_t nanos = nanosDesde(inicio);
+        sumidero = sumidero + static_cast<std::size_t>(suma);
+        return nanos;
+    }});
+
+    casos.push_back({"SistemaBovedas::getEstadoBancos", false, [](Escenario& escenario, std::size_t iteraciones) {
+        std::size_t suma = 0;
+        Reloj::time_point inicio = Reloj::now();
+        for (std::size_t i = 0; i < iteraciones; ++i) {
+            suma += escenario.sistema->getEstadoBancos().size();
+        }
+        std::int64_t nanos = nanosDesde(inicio);
+        sumidero = sumidero + suma;
+        return nanos;
+    }});
+
+    casos.push_back({"SistemaBovedas::getEstadoTransacciones", true, [](Escenario& escenario, std::size_t iteraciones) {
+        std::size_t suma = 0;
+        Reloj::time_point inicio = Reloj::now();
+        for (std::size_t i = 0; i < iteraciones; ++i) {
+            suma += escenario.sistema->getEstadoTransacciones().size();
+        }
+        std::int64_t nanos = nanosDesde(inicio);
+        sumidero = sumidero + suma;
+        return nanos;
+    }});
+
+    casos.push_back({"SistemaBovedas::escribirEstadoTransacciones", true, [](Escenario& escenario, std::size_t iteraciones) {
+        SalidaDescartada salida;
+        Reloj::time_point inicio = Reloj::now();
+        for (std::size_t i = 0; i < iteraciones; ++i) {
+            EscritorReporte escritor(salida, FormatoReporte::JSON);
+            escenario.sistema->escribirEstadoTransacciones(escritor);
+            escritor.terminar();
+        }
+        std::int64_t nanos = nanosDesde(inicio);
+        sumidero = sumidero + salida.bytes;
+        return nanos;
+    }});
+
+    // Las que modifican el sistema van al final: agregan transacciones al
+    // historial y los casos anteriores ya se midieron con el tamaño nominal
+    casos.push_back({"SistemaBovedas::iniciarTransferencia", true, [](Escenario& escenario, std::size_t iteraciones) {
+        std::vector<std::pair<const ExtremoBenchmark*, const ExtremoBenchmark*>> pares;
+        pares.reserve(iteraciones);
+        for (std::size_t i = 0; i < iteraciones; ++i) {
+            pares.push_back(parAleatorio(escenario));
+        }
+        std::vector<std::string> creadas;
+        creadas.reserve(iteraciones);
+        Reloj::time_point inicio = Reloj::now();
+        for (std::size_t i = 0; i < iteraciones; ++i) {
+            creadas.push_back(escenario.sistema->iniciarTransferencia(
+                pares[i].first->codigoBanco, pares[i].first->idBoveda,
+                pares[i].second->codigoBanco, pares[i].second->idBoveda,
+                static_cast<TipoActivo>(i % NUM_TIPOS_ACTIVO), 1.0));
+        }
+        std::int64_t nanos = nanosDesde(inicio);
+        // Quedan para procesarTransaccion
+        escenario.pendientes.insert(escenario.pendientes.end(), creadas.begin(), creadas.end());
+        return nanos;
+    }});
+
+    casos.push_back({"SistemaBovedas::procesarTransaccion", true, [](Escenario& escenario, std::size_t iteraciones) {
+        if (escenario.pendientes.size() < iteraciones) {
+            std::vector<std::string> nuevas = crearTransacciones(escenario, iteraciones - escenario.pendientes.size());
+            escenario.pendientes.insert(escenario.pendientes.end(), nuevas.begin(), nuevas.end());
+        }
+        std::vector<std::string> aProcesar(escenario.pendientes.end() - static_cast<std::ptrdiff_t>(iteraciones),
+                                           escenario.pendientes.end());
+        escenario.pendientes.resize(escenario.pendientes.size() - iteraciones);
+        Reloj::time_point inicio = Reloj::now();
+        for (const std::string& id : aProcesar) {
+            escenario.sistema->procesarTransaccion(id);
+        }
+        return nanosDesde(inicio);
+    }});
+
+    return casos;
+}
+
+// Calibra las iteraciones para que cada repetición dure al menos
+// tiempoMinimo y devuelve la mediana, el mínimo y el máximo por operación.
+// Devuelve false si el caso no aplica al escenario.
+bool medirCaso(const CasoBenchmark& caso, Escenario& escenario, const ConfiguracionBenchmark& configuracion,
+               ResultadoBenchmark& resultado) {
+    const std::int64_t objetivo = static_cast<std::int64_t>(configuracion.tiempoMinimo * 1e9);
+    std::size_t iteraciones = 1;
+    while (true) {
+        std::int64_t nanos = caso.medir(escenario, iteraciones);
+        if (nanos < 0) {
+            return false;
+        }
+        if (nanos >= objetivo) {
+            break;
+        }
+        // Se estima cuántas hacen falta, sin crecer más de 100 veces por paso
+        double factor = nanos > 0 ? 1.2 * static_cast<double>(objetivo) / static_cast<double>(nanos) : 100.0;
+        iteraciones = static_cast<std::size_t>(static_cast<double>(iteraciones) * std::clamp(factor, 2.0, 100.0));
+    }
+
+    std::vector<double> porOperacion;
+    for (std::size_t r = 0; r < configuracion.repeticiones; ++r) {
+        porOperacion.push_back(static_cast<double>(caso.medir(escenario, iteraciones)) / static_cast<double>(iteraciones));
+    }
+    std::sort(porOperacion.begin(), porOperacion.end());
+
+    resultado = {caso.nombre, escenario.bancos, escenario.bovedasPorBanco, escenario.historial, iteraciones,
+                 porOperacion[porOperacion.size() / 2], porOperacion.front(), porOperacion.back()};
+    return true;
+}
+
+std::string idDe(const ResultadoBenchmark& resultado) {
+    return resultado.nombre + "/bancos=" + std::to_string(resultado.bancos) +
+           "/bovedas=" + std::to_string(resultado.bovedasPorBanco) +
+           "/historial=" + std::to_string(resultado.historial);
+}
+
+void escribirJson(std::ostream& salida, const ConfiguracionBenchmark& configuracion,
+                  const std::vector<ResultadoBenchmark>& resultados) {
+    char numero[64];
+    auto decimal = [&](double valor) {
+        std::snprintf(numero, sizeof(numero), "%.2f", valor);
+        return std::string(numero);
+    };
+
+    salida << "{\n";
+    salida << "  \"suite\": \"bovedas\",\n";
+    salida << "  \"tipo_compilacion\": \"" << BOVEDAS_TIPO_COMPILACION << "\",\n";
+    salida << "  \"tiempo_minimo_s\": " << configuracion.tiempoMinimo << ",\n";
+    salida << "  \"repeticiones\": " << configuracion.repeticiones << ",\n";
+    salida << "  \"resultados\": [";
+    for (std::size_t i = 0; i < resultados.size(); ++i) {
+        const ResultadoBenchmark& r = resultados[i];
+        salida << (i == 0 ? "\n" : ",\n");
+        salida << "    {\"id\": \"" << idDe(r) << "\", \"nombre\": \"" << r.nombre << "\""
+               << ", \"bancos\": " << r.bancos
+               << ", \"bovedas_por_banco\": " << r.bovedasPorBanco
+               << ", \"historial\": " << r.historial
+               << ", \"iteraciones\": " << r.iteraciones
+               << ", \"ns_por_op\": " << decimal(r.nsMediana)
+               << ", \"ns_min\": " << decimal(r.nsMinimo)
+               << ", \"ns_max\": " << decimal(r.nsMaximo) << "}";
+    }
+    salida << "\n  ]\n}\n";
+}
+
+void mostrarUso(const char* programa) {
+    std::cerr << "Uso: " << programa << " [opciones]\n"
+              << "  --bancos N,N,...      Cantidades de bancos (2,16)\n"
+              << "  --bovedas N,N,...     Bóvedas por banco (4,64)\n"
+              << "  --historial N,N,...   Transacciones previas a la medición (1000,100000)\n"
+              << "  --tiempo-min S        Segundos mínimos por repetición (0.1)\n"
+              << "  --repeticiones N      Repeticiones por caso; se reporta la mediana (5)\n"
+              << "  --filtro TEXTO        Solo los casos cuyo nombre contiene TEXTO\n"
+              << "  --salida RUTA         Escribe el JSON en RUTA en lugar de la salida estándar\n"
+              << "  --semilla N           Semilla de la topología y las cargas (42)\n";
+}
+
+bool leerArgumentos(int argc, char* argv[], ConfiguracionBenchmark& configuracion) {
+    for (int i = 1; i < argc; ++i) {
+        std::string opcion = argv[i];
+        if (opcion == "--ayuda" || opcion == "-h" || i + 1 >= argc) {
+            return false;
+        }
+        std::string valor = argv[++i];
+        try {
+            if (opcion == "--bancos") {
+                configuracion.bancos = leerLista(valor);
+            } else if (opcion == "--bovedas") {
+                configuracion.bovedasPorBanco = leerLista(valor);
+            } else if (opcion == "--historial") {
+                configuracion.historial = leerLista(valor);
+            } else if (opcion == "--tiempo-min") {
+                configuracion.tiempoMinimo = std::stod(valor);
+            } else if (opcion == "--repeticiones") {
+                configuracion.repeticiones = std::max<std::size_t>(1, std::stoull(valor));
+            } else if (opcion == "--filtro") {
+                configuracion.filtro = valor;
+            } else if (opcion == "--salida") {
+                configuracion.rutaSalida = valor;
+            } else if (opcion == "--semilla") {
+                configuracion.semilla = static_cast<std::uint32_t>(std::stoul(valor));
+            } else {
+                std::cerr << "Opción desconocida: " << opcion << "\n";
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Valor inválido para " << opcion << ": " << valor << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ConfiguracionBenchmark configuracion;
+    if (!leerArgumentos(argc, argv, configuracion)) {
+        mostrarUso(argv[0]);
+        return 1;
+    }
+
+    std::vector<CasoBenchmark> casos = crearCasos();
+    std::vector<ResultadoBenchmark> resultados;
+    try {
+        for (std::size_t bancos : configuracion.bancos) {
+            for (std::size_t bovedas : configuracion.bovedasPorBanco) {
+                if (bancos * bovedas < 2) {
+                    continue; // Hace falta un origen y un destino distintos
+                }
+                for (std::size_t h = 0; h < configuracion.historial.size(); ++h) {
+                    std::size_t historial = configuracion.historial[h];
+                    // Cada combinación parte de un sistema nuevo
+                    Escenario escenario = crearEscenario(bancos, bovedas, historial, configuracion.semilla);
+                    for (const CasoBenchmark& caso : casos) {
+                        if (caso.nombre.find(configuracion.filtro) == std::string::npos ||
+                            (!caso.dependeDelHistorial && h > 0)) {
+                            continue;
+                        }
+                        ResultadoBenchmark resultado;
+                        if (medirCaso(caso, escenario, configuracion, resultado)) {
+                            std::cerr << idDe(resultado) << ": " << resultado.nsMediana << " ns/op\n";
+                            resultados.push_back(resultado);
+                        }
+                    }
+                }
+            }
+        }
+    } catch (const BovedaException& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    if (configuracion.rutaSalida.empty()) {
+        escribirJson(std::cout, configuracion, resultados);
+    } else {
+        std::ofstream salida(configuracion.rutaSalida);
+        if (!salida) {
+            std::cerr << "No se pudo escribir " << configuracion.rutaSalida << "\n";
+            return 1;
+        }
+        escribirJson(salida, configuracion, resultados);
+    }
+    return 0;
+}
@@ -1,14 +1,15 @@
 #include "boveda.h"
+#include "acumulador_saldos.h"
+#include "almacen_saldos.h"
 #include "exceptions.h"
+#include "tasas_cambio.h"
 #include <sstream>
 #include <iomanip>
+#include <functional>
 
 Boveda::Boveda(const std::string& id, const std::string& ubicacion) 
-    : id(id), ubicacion(ubicacion) {
-    // Inicializar todos los tipos de activos en 0
-    activos[TipoActivo::SOLES] = 0.0;
-    activos[TipoActivo::DOLARES] = 0.0;
-    activos[TipoActivo::JOYAS] = 0.0;
+    : activos{}, id(id), ubicacion(ubicacion), almacen(nullptr), handle(0), acumulador(nullptr), observador(nullptr) {
+    // Todos los tipos de activos comienzan en 0
 }
 
 std::string Boveda::getId() const {
@@ -19,62 +20,182 @@ std::string Boveda::getUbicacion() const {
     return ubicacion;
 }
 
-double Boveda::getSaldo(TipoActivo tipo) const {
-    auto it = activos.find(tipo);
-    return (it != activos.end()) ? it->second : 0.0;
+std::string Boveda::getCodigoBanco() const {
+    return codigoBanco;
 }
 
-std::map<TipoActivo, double> Boveda::getTodosLosActivos() const {
+void Boveda::setCodigoBanco(const std::string& codigoBanco) {
+    this->codigoBanco = codigoBanco;
+}
+
+Monto Boveda::getSaldo(TipoActivo tipo) const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    return activos[Activo::indice(tipo)];
+}
+
+const SaldosBoveda& Boveda::getTodosLosActivos() const {
+    return activos;
+}
+
+SaldosBoveda Boveda::getCopiaActivos() const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
     return activos;
 }
 
+void Boveda::aplicarMovimiento(TipoActivo tipo, Monto delta) {
+    // Todo lo que puede rechazar el movimiento va antes de modificar nada
+    Monto& saldo = activos[Activo::indice(tipo)];
+    std::int64_t nuevo;
+    if (__builtin_add_overflow(saldo.getCentesimas(), delta.getCentesimas(), &nuevo)) {
+        throw DatosInvalidosException("El saldo de " + Activo::tipoActivoToString(tipo) + " de la bóveda " + id +
+                                      " se desbordaría");
+    }
+    if (acumulador) {
+        acumulador->aplicar(tipo, delta);
+    }
+    saldo = Monto::desdeCentesimas(nuevo);
+    if (almacen) {
+        almacen->aplicarMovimiento(handle, tipo, delta);
+    }
+    if (observador) {
+        observador->saldoModificado(*this, tipo, delta);
+    }
+}
+
 void Boveda::agregarActivo(const Activo& activo) {
-    if (activo.getCantidad() <= 0) {
-        throw DatosInvalidosException("No se puede agregar una cantidad negativa o cero");
+    intentarAgregar(activo).valor();
+}
+
+Resultado<void> Boveda::intentarAgregar(const Activo& activo) {
+    if (!activo.getMonto().esPositivo()) {
+        return ErrorBoveda(CodigoError::DATOS_INVALIDOS, "No se puede agregar una cantidad negativa o cero");
     }
-    activos[activo.getTipo()] += activo.getCantidad();
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    agregarSinBloqueo(activo);
+    return {};
+}
+
+void Boveda::agregarSinBloqueo(const Activo& activo) {
+    aplicarMovimiento(activo.getTipo(), activo.getMonto());
 }
 
 void Boveda::retirarActivo(const Activo& activo) {
-    if (activo.getCantidad() <= 0) {
-        throw DatosInvalidosException("No se puede retirar una cantidad negativa o cero");
+    intentarRetirar(activo).valor();
+}
+
+Resultado<void> Boveda::intentarRetirar(const Activo& activo) {
+    if (!activo.getMonto().esPositivo()) {
+        return ErrorBoveda(CodigoError::DATOS_INVALIDOS, "No se puede retirar una cantidad negativa o cero");
     }
-    
-    double saldoActual = getSaldo(activo.getTipo());
-    if (saldoActual < activo.getCantidad()) {
-        throw SaldoInsuficienteException("Saldo insuficiente de " + activo.getTipoString() + 
-                                        " en bóveda " + id + ". Disponible: " + 
-                                        std::to_string(saldoActual) + ", Solicitado: " + 
-                                        std::to_string(activo.getCantidad()));
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    return retirarSinBloqueo(activo);
+}
+
+Resultado<void> Boveda::retirarSinBloqueo(const Activo& activo) {
+    Monto saldoActual = activos[Activo::indice(activo.getTipo())];
+    if (saldoActual < activo.getMonto()) {
+        // El mensaje se arma solo si alguien lo pide
+        return ErrorBoveda::saldoInsuficiente(id, activo.getTipo(), saldoActual, activo.getMonto());
     }
     
-    activos[activo.getTipo()] -= activo.getCantidad();
+    aplicarMovimiento(activo.getTipo(), -activo.getMonto());
+    return {};
 }
 
 bool Boveda::tieneActivo(const Activo& activo) const {
-    return getSaldo(activo.getTipo()) >= activo.getCantidad();
+    return getSaldo(activo.getTipo()) >= activo.getMonto();
 }
 
-double Boveda::getValorTotalEnDolares() const {
-    // Tasas de conversión aproximadas (en un sistema real vendrían de una API)
-    const double tasaSolesToDolares = 0.27; // 1 sol ≈ 0.27 USD
-    const double tasaJoyasToDolares = 50.0;  // 1 unidad de joya ≈ 50 USD
+void Boveda::transferir(Boveda& origen, Boveda& destino, const Activo& activo) {
+    intentarTransferir(origen, destino, activo).valor();
+}
+
+Resultado<void> Boveda::intentarTransferir(Boveda& origen, Boveda& destino, const Activo& activo) {
+    if (&origen == &destino) {
+        return ErrorBoveda(CodigoError::OPERACION_INVALIDA, "La bóveda de origen no puede ser la misma que la de destino");
+    }
+    if (!activo.getMonto().esPositivo()) {
+        return ErrorBoveda(CodigoError::DATOS_INVALIDOS, "No se puede transferir una cantidad negativa o cero");
+    }
+    
+    // Orden global por dirección: dos transferencias opuestas toman los
+    // mutex en el mismo orden y no pueden bloquearse mutuamente
+    bool origenPrimero = std::less<const Boveda*>()(&origen, &destino);
+    std::lock_guard<std::mutex> primero(origenPrimero ? origen.mutex : destino.mutex);
+    std::lock_guard<std::mutex> segundo(origenPrimero ? destino.mutex : origen.mutex);
+    
+    Resultado<void> retiro = origen.retirarSinBloqueo(activo);
+    if (retiro.ok()) {
+        try {
+            destino.agregarSinBloqueo(activo);
+        } catch (const DatosInvalidosException&) {
+            // El saldo del destino se desbordaría: se devuelve lo retirado
+            origen.aplicarMovimiento(activo.getTipo(), activo.getMonto());
+            throw;
+        }
+    }
+    return retiro;
+}
+
+void Boveda::setAcumulador(AcumuladorSaldos* acumulador) {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    if (this->acumulador) {
+        this->acumulador->restar(activos);
+    }
+    this->acumulador = acumulador;
+    if (this->acumulador) {
+        this->acumulador->sumar(activos);
+    }
+}
+
+void Boveda::setObservador(ObservadorBoveda* observador) {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    this->observador = observador;
+    if (observador) {
+        observador->observacionIniciada(*this, activos);
+    }
+}
+
+void Boveda::conectarAlmacen(AlmacenSaldos* almacen, HandleBoveda handle) {
+    if (!almacen || handle >= almacen->getCantidadBovedas()) {
+        throw ErrorInternoSistemaException("Fila de almacén inválida para la bóveda " + id);
+    }
     
-    double total = 0.0;
-    total += getSaldo(TipoActivo::DOLARES);
-    total += getSaldo(TipoActivo::SOLES) * tasaSolesToDolares;
-    total += getSaldo(TipoActivo::JOYAS) * tasaJoyasToDolares;
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    if (this->almacen) {
+        throw ErrorInternoSistemaException("La bóveda " + id + " ya está conectada a un almacén");
+    }
     
-    return total;
+    // La fila parte en cero: los saldos actuales entran como un movimiento
+    for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+        if (!activos[i].esCero()) {
+            almacen->aplicarMovimiento(handle, static_cast<TipoActivo>(i), activos[i]);
+        }
+    }
+    this->almacen = almacen;
+    this->handle = handle;
+}
+
+const AlmacenSaldos* Boveda::getAlmacen() const {
+    return almacen;
+}
+
+double Boveda::getValorTotalEnDolares() const {
+    return ProveedorTasas::getGlobal().getActuales()->valuar(getCopiaActivos());
+}
+
+bool Boveda::valuar(ValuacionSaldos& valuacion, const TasasCambio& tasas) const {
+    return valuacion.actualizar(getCopiaActivos(), tasas);
 }
 
 std::string Boveda::getResumen() const {
     std::stringstream ss;
     ss << std::fixed << std::setprecision(2);
     ss << "Bóveda: " << id << " (" << ubicacion << ")\n";
-    ss << "  Soles: S/ " << getSaldo(TipoActivo::SOLES) << "\n";
-    ss << "  Dólares: $ " << getSaldo(TipoActivo::DOLARES) << "\n";
-    ss << "  Joyas: " << getSaldo(TipoActivo::JOYAS) << " unidades\n";
+    SaldosBoveda saldos = getCopiaActivos();
+    ss << "  Soles: S/ " << saldos[Activo::indice(TipoActivo::SOLES)].toString() << "\n";
+    ss << "  Dólares: $ " << saldos[Activo::indice(TipoActivo::DOLARES)].toString() << "\n";
+    ss << "  Joyas: " << saldos[Activo::indice(TipoActivo::JOYAS)].toString() << " unidades\n";
     ss << "  Valor total: $ " << getValorTotalEnDolares();
     return ss.str();
 }
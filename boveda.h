@@ -2,14 +2,63 @@
 #define BOVEDA_H
 
 #include "activo.h"
-#include <map>
+#include "handles.h"
+#include "resultado.h"
+#include <array>
+#include <mutex>
 #include <string>
 
+class AcumuladorSaldos;
+class AlmacenSaldos;
+class Boveda;
+class ValuacionSaldos;
+struct TasasCambio;
+
+// Saldos de una bóveda indexados por TipoActivo (ver Activo::indice)
+using SaldosBoveda = std::array<Monto, NUM_TIPOS_ACTIVO>;
+
+// Recibe cada movimiento de saldo de las bóvedas que observa. Se invoca con
+// el mutex de la bóveda tomado, así que los movimientos de una misma bóveda
+// llegan en el orden en que se aplicaron; no debe volver a llamar a la bóveda.
+class ObservadorBoveda {
+public:
+    virtual ~ObservadorBoveda() = default;
+    virtual void saldoModificado(const Boveda& boveda, TipoActivo tipo, Monto delta) = 0;
+    // Se invoca (también con el mutex tomado) al asignar el observador, con
+    // los saldos desde los que parten los movimientos que recibirá
+    virtual void observacionIniciada(const Boveda& boveda, const SaldosBoveda& saldos) {
+        (void)boveda;
+        (void)saldos;
+    }
+};
+
 class Boveda {
 private:
+    // Los saldos van primero y alineados a una línea de caché: son lo que
+    // se lee en cada valuación y transferencia
+    alignas(64) SaldosBoveda activos;
     std::string id;
     std::string ubicacion;
-    std::map<TipoActivo, double> activos;
+    std::string codigoBanco; // Lo asigna el banco al agregar la bóveda
+    
+    // Si está conectada, cada movimiento se refleja en la fila 'handle' del
+    // almacén columnar; los saldos de la bóveda siguen siendo los de 'activos'
+    AlmacenSaldos* almacen;
+    HandleBoveda handle;
+    
+    // Totales del banco al que pertenece; recibe cada movimiento como delta
+    AcumuladorSaldos* acumulador;
+    ObservadorBoveda* observador;
+    
+    // Protege los saldos. Para operar sobre dos bóvedas se bloquean en orden
+    // de dirección (ver transferir) y así no hay interbloqueos.
+    mutable std::mutex mutex;
+    
+    // Variantes que asumen el mutex ya tomado. aplicarMovimiento lanza
+    // DatosInvalidosException (sin aplicar nada) si un saldo se desbordaría.
+    void aplicarMovimiento(TipoActivo tipo, Monto delta);
+    void agregarSinBloqueo(const Activo& activo);
+    Resultado<void> retirarSinBloqueo(const Activo& activo);
 
 public:
     Boveda(const std::string& id, const std::string& ubicacion);
@@ -17,16 +66,39 @@ public:
     // Getters
     std::string getId() const;
     std::string getUbicacion() const;
-    double getSaldo(TipoActivo tipo) const;
-    std::map<TipoActivo, double> getTodosLosActivos() const;
+    std::string getCodigoBanco() const;
+    void setCodigoBanco(const std::string& codigoBanco);
+    Monto getSaldo(TipoActivo tipo) const;
+    const SaldosBoveda& getTodosLosActivos() const; // Vista sin copia; sin movimientos concurrentes
+    SaldosBoveda getCopiaActivos() const; // Tomada con el mutex, para leer durante movimientos
     
     // Operaciones con activos
     void agregarActivo(const Activo& activo);
     void retirarActivo(const Activo& activo);
     bool tieneActivo(const Activo& activo) const;
     
+    // Retira de 'origen' y deposita en 'destino' de forma atómica
+    static void transferir(Boveda& origen, Boveda& destino, const Activo& activo);
+    
+    // Variantes sin excepciones para los rechazos habituales (ver resultado.h)
+    Resultado<void> intentarAgregar(const Activo& activo);
+    Resultado<void> intentarRetirar(const Activo& activo);
+    static Resultado<void> intentarTransferir(Boveda& origen, Boveda& destino, const Activo& activo);
+    
+    // Totales incrementales: los saldos actuales se trasladan al nuevo acumulador
+    void setAcumulador(AcumuladorSaldos* acumulador);
+    
+    // Notificación de movimientos (diario, historial, etc.)
+    void setObservador(ObservadorBoveda* observador);
+    
+    // Almacén columnar
+    void conectarAlmacen(AlmacenSaldos* almacen, HandleBoveda handle);
+    const AlmacenSaldos* getAlmacen() const;
+    
     // Cálculo del valor total en dólares (asumiendo conversiones)
     double getValorTotalEnDolares() const;
+    // Pone 'valuacion' al día con los saldos actuales y 'tasas' (ver ValuacionSaldos)
+    bool valuar(ValuacionSaldos& valuacion, const TasasCambio& tasas) const;
     
     // Información para mostrar
     std::string getResumen() const;
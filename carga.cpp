@@ -0,0 +1,459 @@
+// Generador de carga sin interfaz gráfica: lanza transferencias entre
+// bóvedas elegidas al azar y reporta el throughput y los percentiles de
+// latencia de cada operación. Sirve para pruebas de capacidad en servidores.
+
+#include "sistema_bovedas.h"
+#include "generador_topologia.h"
+#include "pipeline_transacciones.h"
+#include "exceptions.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Reloj = std::chrono::steady_clock;
+
+enum class ModoCarga {
+    DIRECTO, // Cada hilo inicia y procesa sus transferencias de principio a fin
+    PIPELINE // Se inician en el hilo principal y se procesan en el pipeline por etapas
+};
+
+struct ConfiguracionCarga {
+    std::size_t transferencias = 100000;
+    std::size_t hilos = 4;
+    ModoCarga modo = ModoCarga::DIRECTO;
+    double cantidad = 1.0;
+    std::string rutaDiario; // Vacía: sin diario
+    ModoDurabilidad durabilidad = ModoDurabilidad::DIFERIDO;
+    std::uint32_t semilla = 42;
+    // Topología generada (ver generador_topologia.h); con 0 bancos se usan
+    // los tres bancos iniciales
+    std::size_t bancos = 0;
+    std::size_t bovedasPorBanco = 10;
+    std::string rutaReporte; // Vacía: sin reporte final
+    FormatoReporte formatoReporte = FormatoReporte::TEXTO;
+};
+
+struct ExtremoCarga {
+    std::string codigoBanco;
+    std::string idBoveda;
+};
+
+// Latencias de una operación en nanosegundos
+struct MuestraLatencias {
+    std::string operacion;
+    std::vector<std::int64_t> nanos;
+};
+
+void mostrarUso(const char* programa) {
+    std::cerr << "Uso: " << programa << " [opciones]\n"
+              << "  --transferencias N    Cantidad de transferencias (100000)\n"
+              << "  --hilos N             Hilos cliente, o por etapa en modo pipeline (4)\n"
+              << "  --modo directo|pipeline\n"
+              << "  --cantidad X          Monto de cada transferencia (1.0)\n"
+              << "  --diario RUTA         Registra las operaciones en un diario\n"
+              << "  --durabilidad sincrono|diferido   Modo del diario (diferido)\n"
+              << "  --semilla N           Semilla de la topología y de las cargas (42)\n"
+              << "  --bancos N            Genera N bancos sintéticos en lugar de los tres iniciales\n"
+              << "  --bovedas N           Bóvedas por banco generado (10)\n"
+              << "  --reporte RUTA        Al terminar escribe el estado del sistema en RUTA\n"
+              << "  --formato texto|csv|json        Formato del reporte (texto)\n";
+}
+
+bool leerArgumentos(int argc, char* argv[], ConfiguracionCarga& configuracion) {
+    for (int i = 1; i < argc; ++i) {
+        std::string opcion = argv[i];
+        if (opcion == "--ayuda" || opcion == "-h") {
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Falta el valor de " << opcion << "\n";
+            return false;
+        }
+        std::string valor = argv[++i];
+        try {
+            if (opcion == "--transferencias") {
+                configuracion.transferencias = std::stoull(valor);
+            } else if (opcion == "--hilos") {
+                configuracion.hilos = std::max<std::size_t>(1, std::stoull(valor));
+            } else if (opcion == "--modo") {
+                if (valor == "directo") {
+                    configuracion.modo = ModoCarga::DIRECTO;
+                } else if (valor == "pipeline") {
+                    configuracion.modo = ModoCarga::PIPELINE;
+                } else {
+                    std::cerr << "Modo desconocido: " << valor << "\n";
+                    return false;
+                }
+            } else if (opcion == "--cantidad") {
+                configuracion.cantidad = std::stod(valor);
+            } else if (opcion == "--diario") {
+                configuracion.rutaDiario = valor;
+            } else if (opcion == "--durabilidad") {
+                if (valor == "sincrono") {
+                    configuracion.durabilidad = ModoDurabilidad::SINCRONO;
+                } else if (valor == "diferido") {
+                    configuracion.durabilidad = ModoDurabilidad::DIFERIDO;
+                } else {
+                    std::cerr << "Durabilidad desconocida: " << valor << "\n";
+                    return false;
+                }
+            } else if (opcion == "--semilla") {
+                configuracion.semilla = static_cast<std::uint32_t>(std::stoul(valor));
+            } else if (opcion == "--bancos") {
+                configuracion.bancos = std::stoull(valor);
+            } else if (opcion == "--bovedas") {
+                configuracion.bovedasPorBanco = std::stoull(valor);
+            } else if (opcion == "--reporte") {
+                configuracion.rutaReporte = valor;
+            } else if (opcion == "--formato") {
+                if (valor == "texto") {
+                    configuracion.formatoReporte = FormatoReporte::TEXTO;
+                } else if (valor == "csv") {
+                    configuracion.formatoReporte = FormatoReporte::CSV;
+                } else if (valor == "json") {
+                    configuracion.formatoReporte = FormatoReporte::JSON;
+                } else {
+                    std::cerr << "Formato desconocido: " << valor << "\n";
+                    return false;
+                }
+            } else {
+                std::cerr << "Opción desconocida: " << opcion << "\n";
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Valor inválido para " << opcion << ": " << valor << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<ExtremoCarga> listarBovedas(const SistemaBovedas& sistema) {
+    std::vector<ExtremoCarga> extremos;
+    for (const auto& [codigo, banco] : sistema.getBancos()) {
+        for (const auto& boveda : banco->getBovedas()) {
+            extremos.push_back({codigo, boveda->getId()});
+        }
+    }
+    return extremos;
+}
+
+// Origen y destino distintos, y un tipo de activo, al azar
+template <typename Generador>
+SolicitudTransferencia solicitudAleatoria(const std::vector<ExtremoCarga>& extremos, double cantidad,
+                                          Generador& generador) {
+    std::uniform_int_distribution<std::size_t> distribBoveda(0, extremos.size() - 1);
+    std::uniform_int_distribution<std::size_t> distribTipo(0, NUM_TIPOS_ACTIVO - 1);
+    std::size_t origen = distribBoveda(generador);
+    std::size_t destino = distribBoveda(generador);
+    while (destino == origen) {
+        destino = distribBoveda(generador);
+    }
+    return {extremos[origen].codigoBanco, extremos[origen].idBoveda,
+            extremos[destino].codigoBanco, extremos[destino].idBoveda,
+            static_cast<TipoActivo>(distribTipo(generador)), cantidad};
+}
+
+std::int64_t nanosDesde(Reloj::time_point inicio, Reloj::time_point fin) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(fin - inicio).count();
+}
+
+struct ResumenCarga {
+    std::size_t completadas = 0;
+    std::size_t rechazadas = 0;
+    double segundos = 0.0;
+    std::vector<MuestraLatencias> latencias;
+};
+
+ResumenCarga ejecutarDirecto(SistemaBovedas& sistema, const std::vector<ExtremoCarga>& extremos,
+                             const ConfiguracionCarga& configuracion) {
+    struct ResultadoHilo {
+        std::vector<std::int64_t> iniciar;
+        std::vector<std::int64_t> procesar;
+        std::size_t rechazadas = 0;
+    };
+    std::vector<ResultadoHilo> resultados(configuracion.hilos);
+    std::vector<std::thread> hilos;
+
+    Reloj::time_point inicio = Reloj::now();
+    for (std::size_t h = 0; h < configuracion.hilos; ++h) {
+        // Reparto parejo: los primeros hilos absorben el resto de la división
+        std::size_t cuota = configuracion.transferencias / configuracion.hilos +
+                            (h < configuracion.transferencias % configuracion.hilos ? 1 : 0);
+        hilos.emplace_back([&, h, cuota] {
+            std::mt19937 generador(configuracion.semilla + static_cast<std::uint32_t>(h));
+            ResultadoHilo& resultado = resultados[h];
+            resultado.iniciar.reserve(cuota);
+            resultado.procesar.reserve(cuota);
+            for (std::size_t i = 0; i < cuota; ++i) {
+                SolicitudTransferencia solicitud = solicitudAleatoria(extremos, configuracion.cantidad, generador);
+                Reloj::time_point t0 = Reloj::now();
+                Resultado<std::string> creada = sistema.intentarIniciarTransferencia(
+                    solicitud.bancoOrigenCodigo, solicitud.bovedaOrigenId,
+                    solicitud.bancoDestinoCodigo, solicitud.bovedaDestinoId,
+                    solicitud.tipoActivo, solicitud.cantidad);
+                Reloj::time_point t1 = Reloj::now();
+                resultado.iniciar.push_back(nanosDesde(t0, t1));
+                if (!creada) {
+                    ++resultado.rechazadas;
+                    continue;
+                }
+                Resultado<void> procesada = sistema.intentarProcesarTransaccion(creada.valor());
+                resultado.procesar.push_back(nanosDesde(t1, Reloj::now()));
+                if (!procesada) {
+                    ++resultado.rechazadas;
+                }
+            }
+        });
+    }
+    for (auto& hilo : hilos) {
+        hilo.join();
+    }
+
+    ResumenCarga resumen;
+    resumen.segundos = std::chrono::duration<double>(Reloj::now() - inicio).count();
+    MuestraLatencias iniciar{"iniciar", {}};
+    MuestraLatencias procesar{"procesar", {}};
+    for (ResultadoHilo& resultado : resultados) {
+        resumen.rechazadas += resultado.rechazadas;
+        iniciar.nanos.insert(iniciar.nanos.end(), resultado.iniciar.begin(), resultado.iniciar.end());
+        procesar.nanos.insert(procesar.nanos.end(), resultado.procesar.begin(), resultado.procesar.end());
+    }
+    resumen.completadas = configuracion.transferencias - resumen.rechazadas;
+    resumen.latencias.push_back(std::move(iniciar));
+    resumen.latencias.push_back(std::move(procesar));
+    return resumen;
+}
+
+ResumenCarga ejecutarPipeline(SistemaBovedas& sistema, const std::vector<ExtremoCarga>& extremos,
+                              const ConfiguracionCarga& configuracion) {
+    // Instante de envío y latencia de extremo a extremo, por posición
+    // (número de transacción - primer número de la carga)
+    std::size_t primerNumero = sistema.getCantidadTransacciones() + 1;
+    std::vector<Reloj::time_point> enviadas(configuracion.transferencias);
+    std::vector<std::int64_t> extremoAExtremo(configuracion.transferencias, -1);
+    std::atomic<std::size_t> fallidas(0);
+
+    PipelineTransacciones pipeline(sistema, configuracion.hilos);
+    pipeline.setAvisoFin([&](const std::string& transaccionId, bool exito, const std::string&) {
+        Reloj::time_point fin = Reloj::now();
+        std::size_t numero = 0;
+        if (SistemaBovedas::extraerNumeroTransaccion(transaccionId, numero) && numero >= primerNumero &&
+            numero - primerNumero < enviadas.size()) {
+            extremoAExtremo[numero - primerNumero] = nanosDesde(enviadas[numero - primerNumero], fin);
+        }
+        if (!exito) {
+            fallidas.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    pipeline.iniciar();
+
+    std::mt19937 generador(configuracion.semilla);
+    MuestraLatencias iniciar{"iniciar", {}};
+    iniciar.nanos.reserve(configuracion.transferencias);
+    std::size_t rechazadas = 0;
+
+    Reloj::time_point inicio = Reloj::now();
+    for (std::size_t i = 0; i < configuracion.transferencias; ++i) {
+        SolicitudTransferencia solicitud = solicitudAleatoria(extremos, configuracion.cantidad, generador);
+        Reloj::time_point t0 = Reloj::now();
+        Resultado<std::string> creada = sistema.intentarIniciarTransferencia(
+            solicitud.bancoOrigenCodigo, solicitud.bovedaOrigenId,
+            solicitud.bancoDestinoCodigo, solicitud.bovedaDestinoId,
+            solicitud.tipoActivo, solicitud.cantidad);
+        Reloj::time_point t1 = Reloj::now();
+        iniciar.nanos.push_back(nanosDesde(t0, t1));
+        if (!creada) {
+            ++rechazadas;
+            continue;
+        }
+        std::size_t numero = 0;
+        SistemaBovedas::extraerNumeroTransaccion(creada.valor(), numero);
+        enviadas[numero - primerNumero] = t1;
+        pipeline.enviar(creada.valor());
+    }
+    pipeline.esperarVacio();
+
+    ResumenCarga resumen;
+    resumen.segundos = std::chrono::duration<double>(Reloj::now() - inicio).count();
+    pipeline.detener();
+
+    MuestraLatencias completa{"extremo a extremo", {}};
+    for (std::int64_t nanos : extremoAExtremo) {
+        if (nanos >= 0) {
+            completa.nanos.push_back(nanos);
+        }
+    }
+    resumen.rechazadas = rechazadas + fallidas.load();
+    resumen.completadas = configuracion.transferencias - resumen.rechazadas;
+    resumen.latencias.push_back(std::move(iniciar));
+    resumen.latencias.push_back(std::move(completa));
+
+    std::cout << "Etapas del pipeline:\n";
+    for (const EstadisticasEtapa& etapa : pipeline.getEstadisticas()) {
+        std::printf("  %-12s procesadas %10llu  fallidas %8llu\n", etapa.nombre.c_str(),
+                    static_cast<unsigned long long>(etapa.procesadas),
+                    static_cast<unsigned long long>(etapa.fallidas));
+    }
+    return resumen;
+}
+
+// Percentil por rango más cercano sobre las muestras ya ordenadas
+std::int64_t percentil(const std::vector<std::int64_t>& ordenadas, double p) {
+    if (ordenadas.empty()) {
+        return 0;
+    }
+    std::size_t rango = static_cast<std::size_t>(p * ordenadas.size() + 0.999999);
+    return ordenadas[std::min(ordenadas.size(), std::max<std::size_t>(rango, 1)) - 1];
+}
+
+void reportar(const ConfiguracionCarga& configuracion, std::size_t bovedas, ResumenCarga& resumen) {
+    std::printf("Modo: %s | Hilos: %zu | Bóvedas: %zu | Transferencias: %zu\n",
+                configuracion.modo == ModoCarga::DIRECTO ? "directo" : "pipeline",
+                configuracion.hilos, bovedas, configuracion.transferencias);
+    std::printf("Completadas: %zu | Rechazadas: %zu\n", resumen.completadas, resumen.rechazadas);
+    double porSegundo = resumen.segundos > 0 ? configuracion.transferencias / resumen.segundos : 0.0;
+    std::printf("Duración: %.3f s | Throughput: %.0f transferencias/s\n", resumen.segundos, porSegundo);
+
+    std::printf("Latencia (us)            %10s %10s %10s %10s %10s %10s\n",
+                "p50", "p90", "p99", "p99.9", "máx", "muestras");
+    for (MuestraLatencias& muestra : resumen.latencias) {
+        std::sort(muestra.nanos.begin(), muestra.nanos.end());
+        auto micros = [&](double p) { return percentil(muestra.nanos, p) / 1000.0; };
+        std::printf("  %-22s %10.1f %10.1f %10.1f %10.1f %10.1f %10zu\n", muestra.operacion.c_str(),
+                    micros(0.50), micros(0.90), micros(0.99), micros(0.999), micros(1.0), muestra.nanos.size());
+    }
+}
+
+// Lo que midió el propio núcleo (ver metricas.h), visto desde adentro
+void reportarMetricas(const SistemaBovedas& sistema) {
+    ResumenMetricas metricas = sistema.getMetricas();
+    if (!metricas.habilitadas) {
+        return;
+    }
+    std::printf("Núcleo (us)              %10s %10s %10s %10s %10s %10s\n",
+                "p50", "p99", "máx", "llamadas", "rechazos", "por s");
+    for (const EstadisticasOperacion& operacion : metricas.operaciones) {
+        if (operacion.cantidad == 0) {
+            continue;
+        }
+        auto micros = [&](double p) { return operacion.latencias.percentil(p) / 1000.0; };
+        std::printf("  %-22s %10.1f %10.1f %10.1f %10llu %10llu %10.0f\n", operacion.nombre.c_str(),
+                    micros(0.50), micros(0.99), operacion.latencias.getMaximo() / 1000.0,
+                    static_cast<unsigned long long>(operacion.cantidad),
+                    static_cast<unsigned long long>(operacion.rechazadas), operacion.porSegundo);
+    }
+    for (std::size_t i = 0; i < NUM_TIPOS_EXCEPCION; ++i) {
+        if (metricas.excepciones[i] > 0) {
+            std::printf("  %-38s %10llu\n", MetricasNucleo::excepcionToString(static_cast<TipoExcepcion>(i)).c_str(),
+                        static_cast<unsigned long long>(metricas.excepciones[i]));
+        }
+    }
+}
+
+class SalidaArchivo : public SalidaReporte {
+private:
+    std::ofstream archivo;
+
+public:
+    explicit SalidaArchivo(const std::string& ruta) : archivo(ruta, std::ios::binary | std::ios::trunc) {
+        if (!archivo) {
+            throw ConfiguracionInvalidaException("No se pudo crear el reporte: " + ruta);
+        }
+    }
+
+    void escribir(const char* datos, std::size_t longitud) override {
+        if (!archivo.write(datos, static_cast<std::streamsize>(longitud))) {
+            throw ErrorInternoSistemaException("Error al escribir el reporte");
+        }
+    }
+};
+
+// Estado final completo, registro por registro: con historiales grandes no
+// se arma en memoria
+void escribirReporte(const SistemaBovedas& sistema, const ConfiguracionCarga& configuracion) {
+    Reloj::time_point inicio = Reloj::now();
+    SalidaArchivo salida(configuracion.rutaReporte);
+    EscritorReporte escritor(salida, configuracion.formatoReporte);
+    sistema.escribirReporte(escritor);
+    escritor.terminar();
+    std::printf("Reporte: %s escrito en %.3f s\n", configuracion.rutaReporte.c_str(),
+                std::chrono::duration<double>(Reloj::now() - inicio).count());
+}
+
+void inicializar(SistemaBovedas& sistema, const ConfiguracionCarga& configuracion) {
+    if (configuracion.bancos == 0) {
+        if (configuracion.rutaDiario.empty()) {
+            sistema.inicializarSistema();
+        } else {
+            sistema.inicializarSistema(configuracion.rutaDiario, configuracion.durabilidad);
+        }
+        return;
+    }
+
+    ConfiguracionTopologia topologia;
+    topologia.bancos = configuracion.bancos;
+    topologia.bovedasPorBanco = configuracion.bovedasPorBanco;
+    topologia.semilla = configuracion.semilla;
+    GeneradorTopologia generador(topologia);
+
+    Reloj::time_point inicio = Reloj::now();
+    generador.crearBancos(sistema);
+    // Igual que inicializarSistema(ruta): los depósitos también van al diario
+    if (configuracion.rutaDiario.empty() ||
+        !sistema.habilitarDiario(configuracion.rutaDiario, configuracion.durabilidad)) {
+        generador.asignarActivos(sistema);
+    }
+    std::printf("Topología: %zu bancos x %zu bóvedas generados en %.3f s\n", configuracion.bancos,
+                configuracion.bovedasPorBanco,
+                std::chrono::duration<double>(Reloj::now() - inicio).count());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ConfiguracionCarga configuracion;
+    if (!leerArgumentos(argc, argv, configuracion)) {
+        mostrarUso(argv[0]);
+        return 1;
+    }
+
+    try {
+        SistemaBovedas sistema;
+        inicializar(sistema, configuracion);
+
+        std::vector<ExtremoCarga> extremos = listarBovedas(sistema);
+        if (extremos.size() < 2) {
+            std::cerr << "Se necesitan al menos dos bóvedas para generar carga\n";
+            return 1;
+        }
+
+        ResumenCarga resumen = configuracion.modo == ModoCarga::DIRECTO
+                                   ? ejecutarDirecto(sistema, extremos, configuracion)
+                                   : ejecutarPipeline(sistema, extremos, configuracion);
+        reportar(configuracion, extremos.size(), resumen);
+        reportarMetricas(sistema);
+        if (!configuracion.rutaReporte.empty()) {
+            escribirReporte(sistema, configuracion);
+        }
+
+        if (!sistema.verificarTotales()) {
+            std::cerr << "Los totales incrementales no coinciden con el recálculo\n";
+            return 2;
+        }
+    } catch (const BovedaException& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+#ifndef COLA_ACOTADA_H
+#define COLA_ACOTADA_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// Cola FIFO de capacidad fija para varios productores y consumidores.
+// agregar() bloquea mientras está llena (contrapresión hacia quien produce)
+// y extraer() mientras está vacía. Después de cerrar() no se aceptan
+// elementos nuevos y los consumidores terminan de vaciar lo pendiente.
+template <typename T>
+class ColaAcotada {
+private:
+    mutable std::mutex mutex;
+    std::condition_variable hayEspacio;
+    std::condition_variable hayElementos;
+    std::deque<T> elementos;
+    std::size_t capacidad;
+    bool cerrada;
+
+public:
+    explicit ColaAcotada(std::size_t capacidad) : capacidad(capacidad > 0 ? capacidad : 1), cerrada(false) {}
+
+    ColaAcotada(const ColaAcotada&) = delete;
+    ColaAcotada& operator=(const ColaAcotada&) = delete;
+
+    // Devuelve false si la cola se cerró
+    bool agregar(T valor) {
+        std::unique_lock<std::mutex> bloqueo(mutex);
+        hayEspacio.wait(bloqueo, [&] { return elementos.size() < capacidad || cerrada; });
+        if (cerrada) {
+            return false;
+        }
+        elementos.push_back(std::move(valor));
+        bloqueo.unlock();
+        hayElementos.notify_one();
+        return true;
+    }
+
+    // Devuelve false cuando la cola está cerrada y vacía
+    bool extraer(T& valor) {
+        std::unique_lock<std::mutex> bloqueo(mutex);
+        hayElementos.wait(bloqueo, [&] { return !elementos.empty() || cerrada; });
+        if (elementos.empty()) {
+            return false;
+        }
+        valor = std::move(elementos.front());
+        elementos.pop_front();
+        bloqueo.unlock();
+        hayEspacio.notify_one();
+        return true;
+    }
+
+    void cerrar() {
+        {
+            std::lock_guard<std::mutex> bloqueo(mutex);
+            cerrada = true;
+        }
+        hayEspacio.notify_all();
+        hayElementos.notify_all();
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        return elementos.size();
+    }
+
+    std::size_t getCapacidad() const {
+        return capacidad;
+    }
+};
+
+#endif // COLA_ACOTADA_H
@@ -0,0 +1,57 @@
+#ifndef CONJUNTO_DENSO_H
+#define CONJUNTO_DENSO_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+// Conjunto con alta, baja y pertenencia en O(1) cuyos elementos están en un
+// arreglo contiguo: recorrerlo cuesta lo que tiene, no lo que tuvo. La baja
+// mueve el último elemento al hueco, así que el orden no se conserva.
+// No es seguro entre hilos; el llamador lo protege.
+template <typename T>
+class ConjuntoDenso {
+private:
+    std::vector<T> elementos;
+    std::unordered_map<T, std::size_t> posiciones;
+
+public:
+    // Devuelve false si ya estaba
+    bool agregar(const T& valor) {
+        auto [it, insertado] = posiciones.emplace(valor, elementos.size());
+        if (insertado) {
+            elementos.push_back(valor);
+        }
+        return insertado;
+    }
+
+    // Devuelve false si no estaba
+    bool quitar(const T& valor) {
+        auto it = posiciones.find(valor);
+        if (it == posiciones.end()) {
+            return false;
+        }
+        std::size_t hueco = it->second;
+        posiciones.erase(it);
+        if (hueco + 1 != elementos.size()) {
+            elementos[hueco] = elementos.back();
+            posiciones[elementos[hueco]] = hueco;
+        }
+        elementos.pop_back();
+        return true;
+    }
+
+    bool contiene(const T& valor) const {
+        return posiciones.count(valor) > 0;
+    }
+
+    std::size_t size() const {
+        return elementos.size();
+    }
+
+    const std::vector<T>& getElementos() const {
+        return elementos;
+    }
+};
+
+#endif // CONJUNTO_DENSO_H
@@ -0,0 +1,412 @@
+#include "diario.h"
+#include "disco.h"
+#include "exceptions.h"
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+
+namespace {
+
+const char MAGIA[4] = {'B', 'V', 'D', 'J'};
+
+std::uint32_t crc32(const char* datos, std::size_t longitud) {
+    static const std::array<std::uint32_t, 256> tabla = [] {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < longitud; ++i) {
+        crc = tabla[(crc ^ static_cast<unsigned char>(datos[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Los enteros se escriben en el orden de bytes del host
+template <typename T>
+void escribir(std::vector<char>& destino, T valor) {
+    const char* bytes = reinterpret_cast<const char*>(&valor);
+    destino.insert(destino.end(), bytes, bytes + sizeof(T));
+}
+
+void escribirCadena(std::vector<char>& destino, const std::string& cadena) {
+    if (cadena.size() > Diario::LONGITUD_MAXIMA_TEXTO) {
+        throw DatosInvalidosException("Texto demasiado largo para el diario (" + std::to_string(cadena.size()) +
+                                      " bytes, máximo " + std::to_string(Diario::LONGITUD_MAXIMA_TEXTO) + ")");
+    }
+    escribir<std::uint16_t>(destino, static_cast<std::uint16_t>(cadena.size()));
+    destino.insert(destino.end(), cadena.begin(), cadena.end());
+}
+
+class Lector {
+private:
+    const char* datos;
+    std::size_t longitud;
+    std::size_t posicion;
+
+public:
+    Lector(const char* datos, std::size_t longitud) : datos(datos), longitud(longitud), posicion(0) {}
+    
+    template <typename T>
+    bool leer(T& valor) {
+        if (longitud - posicion < sizeof(T)) return false;
+        std::memcpy(&valor, datos + posicion, sizeof(T));
+        posicion += sizeof(T);
+        return true;
+    }
+    
+    bool leerCadena(std::string& cadena) {
+        std::uint16_t tamano = 0;
+        if (!leer(tamano) || longitud - posicion < tamano) return false;
+        cadena.assign(datos + posicion, tamano);
+        posicion += tamano;
+        return true;
+    }
+    
+    bool alFinal() const { return posicion == longitud; }
+};
+
+void serializarRegistro(const RegistroDiario& registro, std::vector<char>& destino) {
+    escribir<std::uint8_t>(destino, static_cast<std::uint8_t>(registro.tipo));
+    switch (registro.tipo) {
+        case TipoRegistroDiario::INICIAR:
+            escribir<std::uint64_t>(destino, registro.numeroTransaccion);
+            escribirCadena(destino, registro.bancoOrigenCodigo);
+            escribirCadena(destino, registro.bovedaOrigenId);
+            escribirCadena(destino, registro.bancoDestinoCodigo);
+            escribirCadena(destino, registro.bovedaDestinoId);
+            escribirCadena(destino, registro.transportadora);
+            escribir<double>(destino, registro.porcentajeComision);
+            escribir<double>(destino, registro.tasaADolares);
+            escribir<std::uint8_t>(destino, static_cast<std::uint8_t>(registro.tipoActivo));
+            escribir<std::int64_t>(destino, registro.centesimas);
+            break;
+        case TipoRegistroDiario::AVANZAR:
+            escribir<std::uint64_t>(destino, registro.numeroTransaccion);
+            escribir<std::int64_t>(destino, registro.instante);
+            break;
+        case TipoRegistroDiario::CANCELAR:
+            escribir<std::uint64_t>(destino, registro.numeroTransaccion);
+            escribirCadena(destino, registro.razon);
+            escribir<std::int64_t>(destino, registro.instante);
+            break;
+        case TipoRegistroDiario::FORZAR_AVANCE:
+            escribir<std::uint64_t>(destino, registro.numeroTransaccion);
+            break;
+        case TipoRegistroDiario::MOVIMIENTO:
+            escribirCadena(destino, registro.codigoBanco);
+            escribirCadena(destino, registro.idBoveda);
+            escribir<std::uint8_t>(destino, static_cast<std::uint8_t>(registro.tipoActivo));
+            escribir<std::int64_t>(destino, registro.centesimas);
+            escribir<std::int64_t>(destino, registro.instante);
+            break;
+        case TipoRegistroDiario::LOTE:
+            // Un solo registro con un solo CRC: tras una caída el lote está entero o no está
+            escribir<std::uint32_t>(destino, static_cast<std::uint32_t>(registro.lote.size()));
+            for (const RegistroDiario& iniciar : registro.lote) {
+                if (iniciar.tipo != TipoRegistroDiario::INICIAR) {
+                    throw ErrorInternoSistemaException("Un lote del diario solo puede contener registros INICIAR");
+                }
+                serializarRegistro(iniciar, destino);
+            }
+            break;
+    }
+}
+
+bool deserializarRegistro(Lector& lector, RegistroDiario& registro, bool dentroDeLote) {
+    std::uint8_t tipo = 0;
+    std::uint8_t tipoActivo = 0;
+    if (!lector.leer(tipo)) return false;
+    
+    registro = RegistroDiario();
+    registro.tipo = static_cast<TipoRegistroDiario>(tipo);
+    if (dentroDeLote && registro.tipo != TipoRegistroDiario::INICIAR) return false;
+    bool ok = false;
+    switch (registro.tipo) {
+        case TipoRegistroDiario::INICIAR:
+            ok = lector.leer(registro.numeroTransaccion) &&
+                 lector.leerCadena(registro.bancoOrigenCodigo) &&
+                 lector.leerCadena(registro.bovedaOrigenId) &&
+                 lector.leerCadena(registro.bancoDestinoCodigo) &&
+                 lector.leerCadena(registro.bovedaDestinoId) &&
+                 lector.leerCadena(registro.transportadora) &&
+                 lector.leer(registro.porcentajeComision) &&
+                 lector.leer(registro.tasaADolares) &&
+                 lector.leer(tipoActivo) &&
+                 lector.leer(registro.centesimas);
+            break;
+        case TipoRegistroDiario::AVANZAR:
+            ok = lector.leer(registro.numeroTransaccion) && lector.leer(registro.instante);
+            break;
+        case TipoRegistroDiario::CANCELAR:
+            ok = lector.leer(registro.numeroTransaccion) &&
+                 lector.leerCadena(registro.razon) &&
+                 lector.leer(registro.instante);
+            break;
+        case TipoRegistroDiario::FORZAR_AVANCE:
+            ok = lector.leer(registro.numeroTransaccion);
+            break;
+        case TipoRegistroDiario::MOVIMIENTO:
+            ok = lector.leerCadena(registro.codigoBanco) &&
+                 lector.leerCadena(registro.idBoveda) &&
+                 lector.leer(tipoActivo) &&
+                 lector.leer(registro.centesimas) &&
+                 lector.leer(registro.instante);
+            break;
+        case TipoRegistroDiario::LOTE: {
+            std::uint32_t cantidad = 0;
+            ok = lector.leer(cantidad);
+            for (std::uint32_t i = 0; ok && i < cantidad; ++i) {
+                RegistroDiario iniciar;
+                ok = deserializarRegistro(lector, iniciar, true);
+                registro.lote.push_back(std::move(iniciar));
+            }
+            break;
+        }
+    }
+    if (tipoActivo >= NUM_TIPOS_ACTIVO) return false;
+    registro.tipoActivo = static_cast<TipoActivo>(tipoActivo);
+    return ok;
+}
+
+} // namespace
+
+Diario::Diario(const std::string& ruta, ModoDurabilidad modo, std::uint64_t ultimoLsn)
+    : ruta(ruta), descriptor(-1), modo(modo), ultimoLsn(ultimoLsn), lsnDurable(ultimoLsn), cerrando(false) {
+    descriptor = abrirParaAnexar(ruta);
+    if (descriptor < 0) {
+        throw ConfiguracionInvalidaException("No se pudo abrir el diario: " + ruta + " (" + std::strerror(errno) + ")");
+    }
+    
+    struct stat info;
+    if (::fstat(descriptor, &info) == 0 && info.st_size == 0) {
+        std::vector<char> cabecera = cabeceraSegmento(ultimoLsn);
+        if (!escribirTodo(descriptor, cabecera.data(), cabecera.size()) || !sincronizarDescriptor(descriptor) ||
+            !sincronizarDirectorioDe(ruta)) {
+            cerrarDescriptor(descriptor);
+            throw ConfiguracionInvalidaException("No se pudo inicializar el diario: " + ruta);
+        }
+    }
+    
+    escritor = std::thread(&Diario::bucleEscritor, this);
+}
+
+Diario::~Diario() {
+    {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        cerrando = true;
+    }
+    hayPendientes.notify_one();
+    escritor.join();
+    if (descriptor >= 0) {
+        cerrarDescriptor(descriptor);
+    }
+}
+
+std::uint64_t Diario::agregar(const RegistroDiario& registro) {
+    // La serialización se hace fuera del mutex; dentro solo se copia al búfer
+    // de una vez, así que un registro nunca queda a medias en los pendientes
+    std::vector<char> contenido;
+    contenido.reserve(72);
+    enmarcar(registro, contenido);
+    
+    std::uint64_t lsn;
+    {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        if (!error.empty()) {
+            throw ErrorInternoSistemaException("Error al escribir el diario: " + error);
+        }
+        pendientes.insert(pendientes.end(), contenido.begin(), contenido.end());
+        lsn = ++ultimoLsn;
+    }
+    hayPendientes.notify_one();
+    return lsn;
+}
+
+std::uint64_t Diario::getUltimoLsn() {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    return ultimoLsn;
+}
+
+void Diario::esperarDurable(std::uint64_t lsn) {
+    std::unique_lock<std::mutex> bloqueo(mutex);
+    // En modo diferido no se espera, pero un error del escritor se informa igual
+    if (modo == ModoDurabilidad::SINCRONO) {
+        hayDurables.wait(bloqueo, [&] { return lsnDurable >= lsn || !error.empty(); });
+    }
+    if (lsnDurable < lsn) {
+        throw ErrorInternoSistemaException("Error al escribir el diario: " + error);
+    }
+}
+
+void Diario::rotar() {
+    std::unique_lock<std::mutex> bloqueo(mutex);
+    // Con el escritor quieto y todo en disco se puede cambiar el descriptor
+    hayDurables.wait(bloqueo, [&] { return (pendientes.empty() && lsnDurable == ultimoLsn) || !error.empty(); });
+    if (!error.empty()) {
+        throw ErrorInternoSistemaException("Error al escribir el diario: " + error);
+    }
+    
+    // El segmento nuevo se arma completo al lado y reemplaza al anterior con
+    // un rename: una caída deja uno de los dos, nunca un diario sin cabecera
+    const std::string temporal = ruta + ".tmp";
+    int nuevo = crearParaEscribir(temporal);
+    if (nuevo < 0) {
+        throw ErrorInternoSistemaException("No se pudo crear el segmento nuevo del diario: " + temporal + " (" +
+                                           std::strerror(errno) + ")");
+    }
+    std::vector<char> cabecera = cabeceraSegmento(ultimoLsn);
+    bool ok = escribirTodo(nuevo, cabecera.data(), cabecera.size()) && sincronizarDescriptor(nuevo);
+    cerrarDescriptor(nuevo);
+    if (!ok) {
+        std::remove(temporal.c_str());
+        throw ErrorInternoSistemaException("No se pudo escribir el segmento nuevo del diario: " + temporal);
+    }
+    
+    cerrarDescriptor(descriptor);
+    ok = reemplazarArchivo(temporal, ruta);
+    std::string mensaje = ok ? std::string() : std::strerror(errno);
+    // Si el reemplazo falló se sigue anexando al segmento anterior
+    descriptor = abrirParaAnexar(ruta);
+    if (descriptor < 0) {
+        error = std::strerror(errno);
+        throw ErrorInternoSistemaException("No se pudo reabrir el diario: " + ruta + " (" + error + ")");
+    }
+    if (!ok) {
+        std::remove(temporal.c_str());
+        throw ErrorInternoSistemaException("No se pudo rotar el diario: " + ruta + " (" + mensaje + ")");
+    }
+}
+
+void Diario::bucleEscritor() {
+    std::vector<char> lote;
+    std::unique_lock<std::mutex> bloqueo(mutex);
+    while (true) {
+        hayPendientes.wait(bloqueo, [&] { return !pendientes.empty() || cerrando; });
+        if (pendientes.empty()) {
+            break; // Cerrando y sin nada pendiente
+        }
+        
+        // Todo lo acumulado hasta ahora forma un grupo con una sola sincronización
+        lote.swap(pendientes);
+        std::uint64_t lsnLote = ultimoLsn;
+        bloqueo.unlock();
+        
+        bool ok = escribirTodo(descriptor, lote.data(), lote.size()) && sincronizarDescriptor(descriptor);
+        std::string mensaje = ok ? std::string() : std::strerror(errno);
+        lote.clear();
+        
+        bloqueo.lock();
+        if (!ok) {
+            // El primer error es definitivo: una escritura parcial deja un marco
+            // corrupto donde la recuperación se detiene, así que nada de lo que
+            // venga después puede darse por durable. Se deja de escribir y
+            // agregar()/esperarDurable() lanzan desde ahora.
+            error = mensaje;
+            pendientes.clear();
+            hayDurables.notify_all();
+            return;
+        }
+        lsnDurable = lsnLote;
+        hayDurables.notify_all();
+    }
+}
+
+void Diario::serializar(const RegistroDiario& registro, std::vector<char>& destino) {
+    serializarRegistro(registro, destino);
+}
+
+bool Diario::deserializar(const char* datos, std::size_t longitud, RegistroDiario& registro) {
+    Lector lector(datos, longitud);
+    return deserializarRegistro(lector, registro, false) && lector.alFinal();
+}
+
+std::vector<char> Diario::cabeceraSegmento(std::uint64_t base) {
+    std::vector<char> cabecera;
+    cabecera.reserve(sizeof(MAGIA) + sizeof(std::uint32_t) + sizeof(std::uint64_t));
+    cabecera.insert(cabecera.end(), MAGIA, MAGIA + sizeof(MAGIA));
+    escribir<std::uint32_t>(cabecera, VERSION);
+    escribir<std::uint64_t>(cabecera, base);
+    return cabecera;
+}
+
+void Diario::enmarcar(const RegistroDiario& registro, std::vector<char>& destino) {
+    // [longitud][crc][contenido]; la longitud y el CRC se completan al final
+    std::size_t inicio = destino.size();
+    destino.resize(inicio + 2 * sizeof(std::uint32_t));
+    serializar(registro, destino);
+    
+    std::size_t longitudContenido = destino.size() - inicio - 2 * sizeof(std::uint32_t);
+    std::uint32_t longitud = static_cast<std::uint32_t>(longitudContenido);
+    std::uint32_t crc = crc32(destino.data() + inicio + 2 * sizeof(std::uint32_t), longitudContenido);
+    std::memcpy(destino.data() + inicio, &longitud, sizeof(longitud));
+    std::memcpy(destino.data() + inicio + sizeof(longitud), &crc, sizeof(crc));
+}
+
+std::uint64_t Diario::leer(const std::string& ruta, const std::function<void(const RegistroDiario&)>& visitar,
+                          std::uint64_t desde) {
+    std::ifstream archivo(ruta, std::ios::binary);
+    if (!archivo) {
+        return 0; // Todavía no existe: no hay nada que recuperar
+    }
+    std::vector<char> datos((std::istreambuf_iterator<char>(archivo)), std::istreambuf_iterator<char>());
+    archivo.close();
+    
+    if (datos.empty()) {
+        return 0;
+    }
+    const std::size_t tamCabecera = cabeceraSegmento(0).size();
+    std::uint32_t version = 0;
+    std::uint64_t base = 0;
+    if (datos.size() >= tamCabecera) {
+        std::memcpy(&version, datos.data() + sizeof(MAGIA), sizeof(version));
+        std::memcpy(&base, datos.data() + sizeof(MAGIA) + sizeof(version), sizeof(base));
+    }
+    if (datos.size() < tamCabecera || std::memcmp(datos.data(), MAGIA, sizeof(MAGIA)) != 0 || version != VERSION) {
+        throw ConfiguracionInvalidaException("El archivo no es un diario válido: " + ruta);
+    }
+    if (base > desde) {
+        throw ConfiguracionInvalidaException("El diario " + ruta + " empieza en el registro " +
+                                             std::to_string(base + 1) + "; faltan los anteriores desde el " +
+                                             std::to_string(desde + 1));
+    }
+    
+    std::size_t posicion = tamCabecera;
+    std::uint64_t lsn = base;
+    RegistroDiario registro;
+    while (datos.size() - posicion >= 2 * sizeof(std::uint32_t)) {
+        std::uint32_t longitud = 0;
+        std::uint32_t crc = 0;
+        std::memcpy(&longitud, datos.data() + posicion, sizeof(longitud));
+        std::memcpy(&crc, datos.data() + posicion + sizeof(longitud), sizeof(crc));
+        const char* contenido = datos.data() + posicion + 2 * sizeof(std::uint32_t);
+        
+        if (datos.size() - posicion - 2 * sizeof(std::uint32_t) < longitud ||
+            crc32(contenido, longitud) != crc ||
+            !deserializar(contenido, longitud, registro)) {
+            break;
+        }
+        
+        if (++lsn > desde) {
+            visitar(registro);
+        }
+        posicion += 2 * sizeof(std::uint32_t) + longitud;
+    }
+    
+    // Descartar un registro final incompleto para anexar a continuación del último válido
+    if (posicion < datos.size() && !truncarArchivo(ruta, posicion)) {
+        throw ConfiguracionInvalidaException("No se pudo truncar el final corrupto del diario: " + ruta);
+    }
+    return lsn;
+}
@@ -0,0 +1,132 @@
+#ifndef DIARIO_H
+#define DIARIO_H
+
+#include "activo.h"
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Tipos de registro del diario (el valor se escribe en disco: no reordenar)
+// Los movimientos de saldo que provoca una transacción no tienen registro
+// propio: van implícitos en su AVANZAR o CANCELAR, así que cada paso es un
+// solo registro y una caída no puede separar el paso de sus efectos.
+enum class TipoRegistroDiario : std::uint8_t {
+    INICIAR = 1,      // Nueva transacción
+    AVANZAR = 2,      // Avance de una etapa: retira del origen al salir de PREPARACION y abona el neto al completar
+    CANCELAR = 3,     // Cancelación: devuelve al origen lo que ya se había retirado
+    MOVIMIENTO = 4,   // Abono (delta positivo) o cargo (delta negativo) directo en una bóveda
+    LOTE = 5,         // Varias transacciones nuevas (INICIAR) que se crean juntas o ninguna
+    FORZAR_AVANCE = 6 // Avance de estado sin efectos en los saldos (avanzarEstadoTransaccion)
+};
+
+// Forma decodificada de un registro; cada tipo usa solo sus campos
+struct RegistroDiario {
+    TipoRegistroDiario tipo = TipoRegistroDiario::MOVIMIENTO;
+    std::uint64_t numeroTransaccion = 0;      // INICIAR, AVANZAR, CANCELAR, FORZAR_AVANCE
+    std::string bancoOrigenCodigo;            // INICIAR
+    std::string bovedaOrigenId;               // INICIAR
+    std::string bancoDestinoCodigo;           // INICIAR
+    std::string bovedaDestinoId;              // INICIAR
+    std::string transportadora;               // INICIAR
+    double porcentajeComision = 0.0;          // INICIAR
+    double tasaADolares = 0.0;                // INICIAR: la congelada en la transacción
+    std::string razon;                        // CANCELAR
+    std::string codigoBanco;                  // MOVIMIENTO
+    std::string idBoveda;                     // MOVIMIENTO
+    TipoActivo tipoActivo = TipoActivo::SOLES; // INICIAR, MOVIMIENTO
+    std::int64_t centesimas = 0;              // INICIAR (cantidad), MOVIMIENTO (delta)
+    std::int64_t instante = 0;                // AVANZAR, CANCELAR, MOVIMIENTO: nanosegundos desde la época de system_clock
+    std::vector<RegistroDiario> lote;         // LOTE: los INICIAR, en orden de número
+};
+
+enum class ModoDurabilidad {
+    SINCRONO, // esperarDurable() bloquea hasta que el registro está en disco
+    DIFERIDO  // esperarDurable() no bloquea; los grupos se sincronizan en segundo plano
+};
+
+// Diario binario de solo anexado (write-ahead log) con commit en grupo.
+// Los registros se serializan en un búfer en memoria; un hilo escritor
+// vacía el búfer con un solo write + fdatasync, así que todas las
+// operaciones que llegan mientras se sincroniza el grupo anterior
+// comparten la siguiente sincronización.
+//
+// Formato: cabecera "BVDJ" + versión (uint32) + LSN base (uint64), luego
+// registros [longitud uint32][crc32 uint32][contenido]. Los LSN son
+// absolutos: el primer registro del archivo es base + 1. Al leer, un
+// registro truncado o con CRC inválido marca el final del diario (escritura
+// interrumpida por una caída).
+//
+// Después de guardar una instantánea el diario se rota (rotar()): el
+// archivo se reemplaza por un segmento vacío cuya base es el último LSN, así
+// que no crece sin límite ni se reaplica lo que la instantánea ya incluye.
+class Diario {
+private:
+    // 2: los movimientos llevan su instante; 3: lotes; 4: los efectos en los
+    // saldos de una transacción van en su AVANZAR o CANCELAR; 5: LSN base en
+    // la cabecera (segmentos rotados); 6: INICIAR lleva la tasa congelada
+    static constexpr std::uint32_t VERSION = 6;
+    
+    std::string ruta;
+    int descriptor;
+    ModoDurabilidad modo;
+    
+    std::mutex mutex;
+    std::condition_variable hayPendientes;
+    std::condition_variable hayDurables;
+    std::vector<char> pendientes;
+    std::uint64_t ultimoLsn;
+    std::uint64_t lsnDurable;
+    bool cerrando;
+    std::string error; // Primer error de E/S; a partir de él no se escribe más
+    std::thread escritor;
+    
+    void bucleEscritor();
+    static void serializar(const RegistroDiario& registro, std::vector<char>& destino);
+    static bool deserializar(const char* datos, std::size_t longitud, RegistroDiario& registro);
+    static void enmarcar(const RegistroDiario& registro, std::vector<char>& destino);
+    static std::vector<char> cabeceraSegmento(std::uint64_t base);
+
+public:
+    // Los textos se guardan con longitud de 16 bits: agregar() rechaza con
+    // DatosInvalidosException un registro con un texto más largo
+    static constexpr std::size_t LONGITUD_MAXIMA_TEXTO = 0xFFFF;
+    
+    // Abre (o crea) el diario para anexar. Si tiene registros previos deben
+    // leerse con leer() antes de abrirlo (el final corrupto se descarta) y
+    // pasar aquí el último LSN que devolvió; un diario nuevo empieza en él.
+    Diario(const std::string& ruta, ModoDurabilidad modo = ModoDurabilidad::SINCRONO, std::uint64_t ultimoLsn = 0);
+    ~Diario();
+    
+    Diario(const Diario&) = delete;
+    Diario& operator=(const Diario&) = delete;
+    
+    // Agrega un registro y devuelve su número de secuencia (LSN). Si lanza
+    // (por ejemplo al serializarlo) el diario queda como estaba. Tras un
+    // error de E/S del escritor lanza ErrorInternoSistemaException.
+    std::uint64_t agregar(const RegistroDiario& registro);
+    std::uint64_t getUltimoLsn();
+    
+    // Espera hasta que el registro 'lsn' (y todos los anteriores) estén en
+    // disco. Lanza ErrorInternoSistemaException si el escritor falló antes de
+    // hacerlo durable; en modo DIFERIDO no espera pero también lanza.
+    void esperarDurable(std::uint64_t lsn);
+    
+    // Espera a que todo lo agregado esté en disco y reemplaza el archivo por
+    // un segmento vacío que empieza en getUltimoLsn(). Solo debe llamarse con
+    // lo anterior ya guardado en otra parte (una instantánea) y sin agregar
+    // registros en paralelo.
+    void rotar();
+    
+    // Lee los registros válidos del archivo en orden y devuelve el LSN del
+    // último (0 si no existe); solo visita los posteriores a 'desde'. Lanza
+    // ConfiguracionInvalidaException si el archivo empieza después de 'desde'
+    // (faltan registros). Trunca el archivo justo después del último válido.
+    static std::uint64_t leer(const std::string& ruta, const std::function<void(const RegistroDiario&)>& visitar,
+                              std::uint64_t desde = 0);
+};
+
+#endif // DIARIO_H
@@ -0,0 +1,120 @@
+#include "disco.h"
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+int abrirParaAnexar(const std::string& ruta) {
+#ifdef _WIN32
+    return ::_open(ruta.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(ruta.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+#endif
+}
+
+int crearParaEscribir(const std::string& ruta) {
+#ifdef _WIN32
+    return ::_open(ruta.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(ruta.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+}
+
+void cerrarDescriptor(int descriptor) {
+#ifdef _WIN32
+    ::_close(descriptor);
+#else
+    ::close(descriptor);
+#endif
+}
+
+bool escribirTodo(int descriptor, const char* datos, std::size_t longitud) {
+    while (longitud > 0) {
+#ifdef _WIN32
+        int escritos = ::_write(descriptor, datos, static_cast<unsigned int>(longitud));
+#else
+        ssize_t escritos = ::write(descriptor, datos, longitud);
+#endif
+        if (escritos < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        datos += escritos;
+        longitud -= static_cast<std::size_t>(escritos);
+    }
+    return true;
+}
+
+bool sincronizarDescriptor(int descriptor) {
+#ifdef _WIN32
+    return ::_commit(descriptor) == 0;
+#elif defined(__APPLE__)
+    return ::fsync(descriptor) == 0;
+#else
+    return ::fdatasync(descriptor) == 0;
+#endif
+}
+
+bool sincronizarArchivo(const std::string& ruta) {
+#ifdef _WIN32
+    int descriptor = ::_open(ruta.c_str(), _O_RDWR | _O_BINARY);
+#else
+    int descriptor = ::open(ruta.c_str(), O_RDONLY);
+#endif
+    if (descriptor < 0) {
+        return false;
+    }
+    bool ok = sincronizarDescriptor(descriptor);
+    int causa = errno;
+    cerrarDescriptor(descriptor);
+    errno = causa;
+    return ok;
+}
+
+bool sincronizarDirectorioDe(const std::string& ruta) {
+#ifdef _WIN32
+    (void)ruta;
+    return true;
+#else
+    std::string::size_type separador = ruta.find_last_of('/');
+    std::string directorio = separador == std::string::npos ? "." : separador == 0 ? "/" : ruta.substr(0, separador);
+    int descriptor = ::open(directorio.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    bool ok = ::fsync(descriptor) == 0;
+    int causa = errno;
+    ::close(descriptor);
+    errno = causa;
+    return ok;
+#endif
+}
+
+bool truncarArchivo(const std::string& ruta, std::size_t longitud) {
+#ifdef _WIN32
+    int descriptor = ::_open(ruta.c_str(), _O_WRONLY | _O_BINARY);
+    if (descriptor < 0) return false;
+    bool ok = ::_chsize_s(descriptor, static_cast<long long>(longitud)) == 0;
+    ::_close(descriptor);
+    return ok;
+#else
+    return ::truncate(ruta.c_str(), static_cast<off_t>(longitud)) == 0;
+#endif
+}
+
+bool reemplazarArchivo(const std::string& temporal, const std::string& ruta) {
+#ifdef _WIN32
+    std::remove(ruta.c_str());
+#endif
+    if (std::rename(temporal.c_str(), ruta.c_str()) != 0) {
+        return false;
+    }
+    return sincronizarDirectorioDe(ruta);
+}
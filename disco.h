@@ -0,0 +1,32 @@
+#ifndef DISCO_H
+#define DISCO_H
+
+#include <cstddef>
+#include <string>
+
+// Envoltorios mínimos de E/S para POSIX y Windows que comparten el diario,
+// las instantáneas y el archivo de transacciones. Los que devuelven bool
+// dejan errno con la causa cuando fallan.
+
+// Abre (o crea) el archivo para escribir siempre al final; -1 si falla
+int abrirParaAnexar(const std::string& ruta);
+// Crea el archivo vacío (o vacía el existente) para escribirlo; -1 si falla
+int crearParaEscribir(const std::string& ruta);
+void cerrarDescriptor(int descriptor);
+
+bool escribirTodo(int descriptor, const char* datos, std::size_t longitud);
+// Lleva a disco los datos del descriptor (fdatasync)
+bool sincronizarDescriptor(int descriptor);
+// Igual, para un archivo escrito con otro flujo (por ejemplo un fstream ya vaciado)
+bool sincronizarArchivo(const std::string& ruta);
+// Hace durable la creación o el renombre de 'ruta' en su directorio. En
+// Windows no hace nada: NTFS registra los cambios de nombre por su cuenta.
+bool sincronizarDirectorioDe(const std::string& ruta);
+bool truncarArchivo(const std::string& ruta, std::size_t longitud);
+
+// Reemplaza 'ruta' por 'temporal' (ya sincronizado) de forma atómica y deja
+// el cambio en disco: después de una caída se ve el archivo anterior o el
+// nuevo completo, nunca uno a medias
+bool reemplazarArchivo(const std::string& temporal, const std::string& ruta);
+
+#endif // DISCO_H
@@ -0,0 +1,178 @@
+#include "generador_topologia.h"
+#include "sistema_bovedas.h"
+#include "exceptions.h"
+#include "tasas_cambio.h"
+#include <algorithm>
+#include <exception>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Flujos independientes por banco: uno para la estructura y otro para los
+// activos, así asignarActivos da lo mismo sobre bancos creados de otra forma
+enum FlujoGenerador : std::uint64_t {
+    FLUJO_ESTRUCTURA = 1,
+    FLUJO_ACTIVOS = 2
+};
+
+const char* const UBICACIONES[] = {
+    "Lima Centro", "San Isidro", "Miraflores", "San Borja", "La Molina", "Surco",
+    "Callao", "Arequipa", "Trujillo", "Chiclayo", "Piura", "Cusco",
+    "Huancayo", "Iquitos", "Tacna", "Puno"
+};
+
+// Finalizador de splitmix64: semillas cercanas dan estados sin correlación
+std::uint64_t mezclar(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+std::mt19937_64 flujoDe(std::uint64_t semilla, FlujoGenerador flujo, std::size_t banco) {
+    return std::mt19937_64(mezclar(mezclar(semilla ^ flujo) + banco));
+}
+
+std::string conCeros(std::size_t numero, int ancho) {
+    std::ostringstream ss;
+    ss << std::setw(ancho) << std::setfill('0') << numero;
+    return ss.str();
+}
+
+// Llama a funcion(i) para i en [0, tareas) repartiendo bloques contiguos
+// entre 'hilos'; la primera excepción de cualquier hilo se relanza aquí
+template <typename Funcion>
+void enParalelo(std::size_t tareas, std::size_t hilos, Funcion funcion) {
+    if (hilos <= 1) {
+        for (std::size_t i = 0; i < tareas; ++i) {
+            funcion(i);
+        }
+        return;
+    }
+    std::size_t porHilo = (tareas + hilos - 1) / hilos;
+    std::vector<std::exception_ptr> errores(hilos);
+    std::vector<std::thread> trabajadores;
+    trabajadores.reserve(hilos);
+    for (std::size_t h = 0; h < hilos; ++h) {
+        trabajadores.emplace_back([&, h] {
+            try {
+                std::size_t fin = std::min(tareas, (h + 1) * porHilo);
+                for (std::size_t i = h * porHilo; i < fin; ++i) {
+                    funcion(i);
+                }
+            } catch (...) {
+                errores[h] = std::current_exception();
+            }
+        });
+    }
+    for (std::thread& trabajador : trabajadores) {
+        trabajador.join();
+    }
+    for (const std::exception_ptr& error : errores) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+} // namespace
+
+GeneradorTopologia::GeneradorTopologia(const ConfiguracionTopologia& configuracion)
+    : configuracion(configuracion) {
+    if (configuracion.valorMinimoBanco < 0 || configuracion.valorMaximoBanco < configuracion.valorMinimoBanco) {
+        throw ConfiguracionInvalidaException("Rango de valor por banco inválido");
+    }
+}
+
+std::size_t GeneradorTopologia::cantidadHilos(std::size_t tareas) const {
+    std::size_t hilos = configuracion.hilos;
+    if (hilos == 0) {
+        hilos = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return std::min(hilos, std::max<std::size_t>(tareas, 1));
+}
+
+void GeneradorTopologia::crearBancos(SistemaBovedas& sistema) const {
+    // Los bancos se arman en paralelo y se agregan en orden: el registro
+    // asigna handles secuenciales y agregarBanco es un cambio de estructura
+    std::vector<std::unique_ptr<Banco>> creados(configuracion.bancos);
+    enParalelo(configuracion.bancos, cantidadHilos(configuracion.bancos), [&](std::size_t b) {
+        std::mt19937_64 generador = flujoDe(configuracion.semilla, FLUJO_ESTRUCTURA, b);
+        std::uniform_int_distribution<std::size_t> distribUbicacion(0, std::size(UBICACIONES) - 1);
+        auto banco = std::make_unique<Banco>("Banco " + conCeros(b, 4), codigoBanco(b));
+        for (std::size_t v = 0; v < configuracion.bovedasPorBanco; ++v) {
+            banco->agregarBoveda(std::make_unique<Boveda>(idBoveda(b, v), UBICACIONES[distribUbicacion(generador)]));
+        }
+        creados[b] = std::move(banco);
+    });
+    for (auto& banco : creados) {
+        sistema.agregarBanco(std::move(banco));
+    }
+}
+
+void GeneradorTopologia::asignarActivos(SistemaBovedas& sistema) const {
+    std::vector<Banco*> bancos;
+    bancos.reserve(sistema.getBancos().size());
+    for (const auto& [codigo, banco] : sistema.getBancos()) {
+        bancos.push_back(banco.get());
+    }
+    // Todos los bancos se valúan con las mismas tasas aunque cambien en el medio
+    std::shared_ptr<const TasasCambio> tasas = ProveedorTasas::getGlobal().getActuales();
+
+    enParalelo(bancos.size(), cantidadHilos(bancos.size()), [&](std::size_t b) {
+        std::mt19937_64 generador = flujoDe(configuracion.semilla, FLUJO_ACTIVOS, b);
+        std::uniform_real_distribution<double> distribValorTotal(configuracion.valorMinimoBanco,
+                                                                 configuracion.valorMaximoBanco);
+        std::uniform_real_distribution<double> distribPorcentaje(0.0, 1.0);
+
+        double valorTotalBanco = distribValorTotal(generador);
+        const auto& bovedas = bancos[b]->getBovedas();
+        for (const auto& boveda : bovedas) {
+            // Cada bóveda recibe una porción igual del valor total del banco
+            double valorBoveda = valorTotalBanco / bovedas.size();
+
+            double porcentajeSoles = distribPorcentaje(generador) * 0.4;   // 0-40%
+            double porcentajeDolares = distribPorcentaje(generador) * 0.5; // 0-50%
+            double porcentajeJoyas = 1.0 - porcentajeSoles - porcentajeDolares;
+            if (porcentajeJoyas < 0) {
+                porcentajeJoyas = 0.1; // Mínimo 10% en joyas
+                porcentajeDolares = 0.9 - porcentajeSoles;
+            }
+
+            double cantidadSoles = (valorBoveda * porcentajeSoles) / tasas->getTasa(TipoActivo::SOLES);
+            double cantidadDolares = valorBoveda * porcentajeDolares;
+            double cantidadJoyas = (valorBoveda * porcentajeJoyas) / tasas->getTasa(TipoActivo::JOYAS);
+
+            if (cantidadSoles > 0) {
+                boveda->agregarActivo(Activo(TipoActivo::SOLES, cantidadSoles));
+            }
+            if (cantidadDolares > 0) {
+                boveda->agregarActivo(Activo(TipoActivo::DOLARES, cantidadDolares));
+            }
+            if (cantidadJoyas > 0) {
+                boveda->agregarActivo(Activo(TipoActivo::JOYAS, cantidadJoyas));
+            }
+        }
+    });
+}
+
+void GeneradorTopologia::generar(SistemaBovedas& sistema) const {
+    crearBancos(sistema);
+    asignarActivos(sistema);
+}
+
+const ConfiguracionTopologia& GeneradorTopologia::getConfiguracion() const {
+    return configuracion;
+}
+
+std::string GeneradorTopologia::codigoBanco(std::size_t banco) {
+    return "B" + conCeros(banco, 4);
+}
+
+std::string GeneradorTopologia::idBoveda(std::size_t banco, std::size_t boveda) {
+    return codigoBanco(banco) + "-" + conCeros(boveda, 4);
+}
@@ -0,0 +1,51 @@
+#ifndef GENERADOR_TOPOLOGIA_H
+#define GENERADOR_TOPOLOGIA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class SistemaBovedas;
+
+struct ConfiguracionTopologia {
+    std::size_t bancos = 3;
+    std::size_t bovedasPorBanco = 3;
+    std::uint64_t semilla = 42;
+    std::size_t hilos = 0; // 0: uno por núcleo
+    // Valor total de cada banco en dólares, repartido entre sus bóvedas
+    double valorMinimoBanco = 10000000.0;
+    double valorMaximoBanco = 100000000.0;
+};
+
+// Genera topologías sintéticas de N bancos con M bóvedas cada uno
+// (códigos "B0000", bóvedas "B0000-0000") y reparte activos entre ellas.
+//
+// Es reproducible: cada banco saca sus números de un flujo propio derivado
+// de la semilla y de su posición, así que con las mismas tasas de cambio el
+// resultado es el mismo con cualquier cantidad de hilos. Los hilos se
+// reparten bancos completos.
+class GeneradorTopologia {
+private:
+    ConfiguracionTopologia configuracion;
+
+    std::size_t cantidadHilos(std::size_t tareas) const;
+
+public:
+    explicit GeneradorTopologia(const ConfiguracionTopologia& configuracion);
+
+    // Crea los bancos y sus bóvedas, sin activos, y los agrega al sistema
+    void crearBancos(SistemaBovedas& sistema) const;
+    // Reparte activos entre las bóvedas de todos los bancos del sistema (el
+    // i-ésimo en orden de código usa el flujo i). Los depósitos pasan por el
+    // observador del sistema, así que quedan en el diario si está habilitado.
+    void asignarActivos(SistemaBovedas& sistema) const;
+    // crearBancos seguido de asignarActivos
+    void generar(SistemaBovedas& sistema) const;
+
+    const ConfiguracionTopologia& getConfiguracion() const;
+
+    static std::string codigoBanco(std::size_t banco);
+    static std::string idBoveda(std::size_t banco, std::size_t boveda);
+};
+
+#endif // GENERADOR_TOPOLOGIA_H
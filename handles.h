@@ -0,0 +1,11 @@
+#ifndef HANDLES_H
+#define HANDLES_H
+
+#include <cstdint>
+
+// Handles enteros densos: se asignan en orden de registro empezando en 0,
+// por lo que sirven directamente como índice en arreglos del sistema
+using HandleBanco = std::uint32_t;
+using HandleBoveda = std::uint32_t;
+
+#endif // HANDLES_H
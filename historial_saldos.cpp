@@ -0,0 +1,137 @@
+#include "historial_saldos.h"
+#include "exceptions.h"
+#include <algorithm>
+
+HistorialSaldos::HistorialSaldos(std::size_t eventosPorBoveda) : eventosPorBoveda(eventosPorBoveda) {
+    if (eventosPorBoveda < INTERVALO_PUNTOS_CONTROL) {
+        throw DatosInvalidosException("El historial debe conservar al menos " +
+                                      std::to_string(INTERVALO_PUNTOS_CONTROL) + " eventos por bóveda");
+    }
+}
+
+HistorialSaldos::Serie* HistorialSaldos::buscarSerie(const Boveda* boveda) const {
+    std::shared_lock<std::shared_mutex> bloqueo(mutex);
+    auto it = series.find(boveda);
+    return it == series.end() ? nullptr : it->second.get();
+}
+
+void HistorialSaldos::agregarEvento(Serie& serie, const Evento& evento) const {
+    serie.eventos.push_back(evento);
+    serie.actuales[Activo::indice(evento.tipo)] += Monto::desdeCentesimas(evento.delta);
+    if (serie.eventos.size() - serie.puntos.back().siguienteEvento >= INTERVALO_PUNTOS_CONTROL) {
+        serie.puntos.push_back({evento.instante, serie.eventos.size(), serie.actuales});
+    }
+
+    // Descartar el intervalo más antiguo: el segundo punto pasa a ser el inicio
+    while (serie.eventos.size() - serie.primerEvento > eventosPorBoveda && serie.puntos.size() > 1) {
+        serie.puntos.erase(serie.puntos.begin());
+        serie.primerEvento = serie.puntos.front().siguienteEvento;
+    }
+    // Los descartados se quitan del arreglo recién cuando son la mitad, así
+    // que mover los que quedan cuesta O(1) amortizado por evento
+    if (serie.primerEvento > 0 && serie.primerEvento * 2 >= serie.eventos.size()) {
+        serie.eventos.erase(serie.eventos.begin(), serie.eventos.begin() + static_cast<std::ptrdiff_t>(serie.primerEvento));
+        for (PuntoControl& punto : serie.puntos) {
+            punto.siguienteEvento -= serie.primerEvento;
+        }
+        serie.primerEvento = 0;
+    }
+}
+
+void HistorialSaldos::iniciarBoveda(const Boveda* boveda, const SaldosBoveda& saldos, std::int64_t instante) {
+    std::unique_lock<std::shared_mutex> bloqueo(mutex);
+    auto& serie = series[boveda];
+    if (serie) {
+        return;
+    }
+    serie = std::make_unique<Serie>();
+    serie->actuales = saldos;
+    serie->puntos.push_back({instante, 0, saldos});
+}
+
+void HistorialSaldos::registrarMovimiento(const Boveda* boveda, TipoActivo tipo, Monto delta, std::int64_t instante) {
+    Serie* serie = buscarSerie(boveda);
+    if (!serie) {
+        throw ErrorInternoSistemaException("La bóveda " + boveda->getId() + " no tiene historial");
+    }
+
+    std::lock_guard<std::mutex> bloqueo(serie->mutex);
+    const std::int64_t ultimo = serie->eventos.size() == serie->primerEvento ? serie->puntos.back().instante
+                                                                             : serie->eventos.back().instante;
+    agregarEvento(*serie, {std::max(instante, ultimo), delta.getCentesimas(), tipo});
+}
+
+bool HistorialSaldos::exportarSerie(const Boveda* boveda, SerieGuardada& destino) const {
+    Serie* serie = buscarSerie(boveda);
+    if (!serie) {
+        return false;
+    }
+    std::lock_guard<std::mutex> bloqueo(serie->mutex);
+    const PuntoControl& primero = serie->puntos.front();
+    destino.inicio = primero.instante;
+    destino.saldos = primero.saldos;
+    destino.eventos.assign(serie->eventos.begin() + static_cast<std::ptrdiff_t>(primero.siguienteEvento),
+                           serie->eventos.end());
+    return true;
+}
+
+SaldosBoveda HistorialSaldos::restaurarBoveda(const Boveda* boveda, const SerieGuardada& guardada) {
+    std::unique_lock<std::shared_mutex> bloqueo(mutex);
+    auto& serie = series[boveda];
+    if (serie) {
+        return serie->actuales;
+    }
+    auto nueva = std::make_unique<Serie>();
+    nueva->actuales = guardada.saldos;
+    nueva->puntos.push_back({guardada.inicio, 0, guardada.saldos});
+    nueva->eventos.reserve(std::min(guardada.eventos.size(), eventosPorBoveda));
+    std::int64_t ultimo = guardada.inicio;
+    for (const Evento& evento : guardada.eventos) {
+        ultimo = std::max(evento.instante, ultimo);
+        agregarEvento(*nueva, {ultimo, evento.delta, evento.tipo});
+    }
+    serie = std::move(nueva);
+    return serie->actuales;
+}
+
+SaldosBoveda HistorialSaldos::getSaldosEn(const Boveda* boveda, std::int64_t instante) const {
+    Serie* serie = buscarSerie(boveda);
+    if (!serie) {
+        throw OperacionInvalidaException("La bóveda " + boveda->getId() + " no tiene historial");
+    }
+
+    std::lock_guard<std::mutex> bloqueo(serie->mutex);
+    // Último punto de control con instante <= al pedido
+    auto punto = std::upper_bound(serie->puntos.begin(), serie->puntos.end(), instante,
+                                  [](std::int64_t valor, const PuntoControl& p) { return valor < p.instante; });
+    if (punto == serie->puntos.begin()) {
+        throw OperacionInvalidaException("No hay historial de la bóveda " + boveda->getId() +
+                                         " para un instante tan antiguo");
+    }
+    --punto;
+
+    SaldosBoveda saldos = punto->saldos;
+    for (std::size_t i = punto->siguienteEvento;
+         i < serie->eventos.size() && serie->eventos[i].instante <= instante; ++i) {
+        saldos[Activo::indice(serie->eventos[i].tipo)] += Monto::desdeCentesimas(serie->eventos[i].delta);
+    }
+    return saldos;
+}
+
+std::size_t HistorialSaldos::getCantidadEventos(const Boveda* boveda) const {
+    Serie* serie = buscarSerie(boveda);
+    if (!serie) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> bloqueo(serie->mutex);
+    return serie->eventos.size() - serie->primerEvento;
+}
+
+std::size_t HistorialSaldos::getCantidadBovedas() const {
+    std::shared_lock<std::shared_mutex> bloqueo(mutex);
+    return series.size();
+}
+
+std::size_t HistorialSaldos::getEventosPorBoveda() const {
+    return eventosPorBoveda;
+}
@@ -0,0 +1,95 @@
+#ifndef HISTORIAL_SALDOS_H
+#define HISTORIAL_SALDOS_H
+
+#include "boveda.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+// Registro de eventos de saldo por bóveda con puntos de control periódicos.
+// Cada bóveda guarda sus movimientos en orden de instante y, cada
+// INTERVALO_PUNTOS_CONTROL movimientos, una copia de sus saldos. El saldo en
+// un instante se reconstruye desde el último punto de control anterior, así
+// que el costo depende de los movimientos posteriores a ese punto y no de la
+// historia completa.
+//
+// Retención: cada bóveda conserva como mucho sus últimos 'eventosPorBoveda'
+// movimientos. Al pasarse se descarta el intervalo más antiguo (desde el
+// primer punto de control hasta el segundo), así que las consultas anteriores
+// al primer punto que queda lanzan igual que las anteriores al inicio.
+//
+// Los instantes son nanosegundos desde la época de system_clock; dentro de
+// una bóveda nunca retroceden (un reloj que retrocede se ajusta al último).
+class HistorialSaldos {
+public:
+    static constexpr std::size_t INTERVALO_PUNTOS_CONTROL = 256;
+    static constexpr std::size_t EVENTOS_POR_BOVEDA = 64 * INTERVALO_PUNTOS_CONTROL;
+
+    struct Evento {
+        std::int64_t instante;
+        std::int64_t delta; // Centésimas
+        TipoActivo tipo;
+    };
+
+    // Lo que se conserva de una bóveda, para guardarlo en una instantánea:
+    // sus saldos en 'inicio' y los eventos posteriores en orden
+    struct SerieGuardada {
+        std::int64_t inicio = 0;
+        SaldosBoveda saldos{};
+        std::vector<Evento> eventos;
+    };
+
+private:
+    struct PuntoControl {
+        std::int64_t instante;
+        std::size_t siguienteEvento; // Primer evento posterior al punto (posición en 'eventos')
+        SaldosBoveda saldos;
+    };
+
+    struct Serie {
+        mutable std::mutex mutex;
+        std::vector<Evento> eventos;
+        std::size_t primerEvento = 0; // Los anteriores ya se descartaron; se compactan de a muchos
+        std::vector<PuntoControl> puntos;
+        SaldosBoveda actuales;
+    };
+
+    // El mapa solo crece; cada serie tiene su propio mutex para que las
+    // bóvedas no compitan entre sí
+    mutable std::shared_mutex mutex;
+    std::unordered_map<const Boveda*, std::unique_ptr<Serie>> series;
+    std::size_t eventosPorBoveda;
+
+    Serie* buscarSerie(const Boveda* boveda) const;
+    void agregarEvento(Serie& serie, const Evento& evento) const;
+
+public:
+    // Lanza DatosInvalidosException si la retención no alcanza para un intervalo
+    explicit HistorialSaldos(std::size_t eventosPorBoveda = EVENTOS_POR_BOVEDA);
+
+    // Abre la serie de la bóveda con sus saldos en 'instante'. Si ya existe no
+    // hace nada: los movimientos registrados siguen siendo la referencia.
+    void iniciarBoveda(const Boveda* boveda, const SaldosBoveda& saldos, std::int64_t instante);
+    void registrarMovimiento(const Boveda* boveda, TipoActivo tipo, Monto delta, std::int64_t instante);
+
+    // Copia lo que se conserva de la serie; false si la bóveda no tiene historial
+    bool exportarSerie(const Boveda* boveda, SerieGuardada& destino) const;
+    // Abre la serie de la bóveda a partir de una guardada (con la retención
+    // de este historial) y devuelve los saldos a los que llega. Como
+    // iniciarBoveda, no hace nada si ya existe.
+    SaldosBoveda restaurarBoveda(const Boveda* boveda, const SerieGuardada& serie);
+
+    // Saldos de la bóveda al final del instante dado; lanza si es anterior al
+    // inicio de su serie o si la bóveda no tiene historial
+    SaldosBoveda getSaldosEn(const Boveda* boveda, std::int64_t instante) const;
+
+    // Eventos que se conservan
+    std::size_t getCantidadEventos(const Boveda* boveda) const;
+    std::size_t getCantidadBovedas() const;
+    std::size_t getEventosPorBoveda() const;
+};
+
+#endif // HISTORIAL_SALDOS_H
@@ -0,0 +1,159 @@
+#include "indices_transacciones.h"
+
+namespace {
+
+bool enCurso(EstadoTransaccion estado) {
+    return static_cast<std::size_t>(estado) < NUM_ESTADOS_EN_CURSO;
+}
+
+// Quita el número del conjunto de 'clave' y borra el conjunto si queda vacío
+template <typename Mapa, typename Clave>
+void quitarDe(Mapa& mapa, const Clave& clave, std::size_t numero) {
+    auto it = mapa.find(clave);
+    if (it == mapa.end()) {
+        return;
+    }
+    it->second.quitar(numero);
+    if (it->second.size() == 0) {
+        mapa.erase(it);
+    }
+}
+
+} // namespace
+
+IndicesTransacciones::IndicesTransacciones() {
+    for (auto& cantidad : conteo) {
+        cantidad.store(0, std::memory_order_relaxed);
+    }
+}
+
+void IndicesTransacciones::Fragmento::indexar(const ClaveIndice& clave, EstadoTransaccion estado) {
+    if (!enCurso(estado)) {
+        return;
+    }
+    porEstado[static_cast<std::size_t>(estado)].agregar(clave.numero);
+    porBoveda[clave.origen].agregar(clave.numero);
+    porBoveda[clave.destino].agregar(clave.numero);
+    porBanco[clave.bancoOrigen].agregar(clave.numero);
+    porBanco[clave.bancoDestino].agregar(clave.numero);
+    porTransportadora[std::string(clave.transportadora)].agregar(clave.numero);
+}
+
+void IndicesTransacciones::Fragmento::desindexar(const ClaveIndice& clave, EstadoTransaccion estado) {
+    if (!enCurso(estado)) {
+        return;
+    }
+    porEstado[static_cast<std::size_t>(estado)].quitar(clave.numero);
+    quitarDe(porBoveda, clave.origen, clave.numero);
+    quitarDe(porBoveda, clave.destino, clave.numero);
+    quitarDe(porBanco, clave.bancoOrigen, clave.numero);
+    quitarDe(porBanco, clave.bancoDestino, clave.numero);
+    quitarDe(porTransportadora, std::string(clave.transportadora), clave.numero);
+}
+
+IndicesTransacciones::Fragmento& IndicesTransacciones::fragmentoDe(std::size_t numero) {
+    return fragmentos[numero % NUM_FRAGMENTOS];
+}
+
+void IndicesTransacciones::agregar(const ClaveIndice& clave, EstadoTransaccion estado) {
+    Fragmento& fragmento = fragmentoDe(clave.numero);
+    {
+        std::lock_guard<std::mutex> bloqueo(fragmento.mutex);
+        fragmento.indexar(clave, estado);
+    }
+    conteo[static_cast<std::size_t>(estado)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void IndicesTransacciones::indexar(const ClaveIndice& clave, EstadoTransaccion estado) {
+    Fragmento& fragmento = fragmentoDe(clave.numero);
+    std::lock_guard<std::mutex> bloqueo(fragmento.mutex);
+    fragmento.indexar(clave, estado);
+}
+
+void IndicesTransacciones::cambiarEstado(const ClaveIndice& clave, EstadoTransaccion anterior, EstadoTransaccion nuevo) {
+    if (anterior == nuevo) {
+        return;
+    }
+    Fragmento& fragmento = fragmentoDe(clave.numero);
+    {
+        std::lock_guard<std::mutex> bloqueo(fragmento.mutex);
+        if (enCurso(anterior) && enCurso(nuevo)) {
+            // Sigue en las mismas bóvedas, banco y transportadora: solo cambia de estado
+            fragmento.porEstado[static_cast<std::size_t>(anterior)].quitar(clave.numero);
+            fragmento.porEstado[static_cast<std::size_t>(nuevo)].agregar(clave.numero);
+        } else {
+            fragmento.desindexar(clave, anterior);
+            fragmento.indexar(clave, nuevo);
+        }
+    }
+    // Primero el alta: una lectura concurrente puede contarla dos veces, pero
+    // ningún estado baja de cero
+    conteo[static_cast<std::size_t>(nuevo)].fetch_add(1, std::memory_order_relaxed);
+    conteo[static_cast<std::size_t>(anterior)].fetch_sub(1, std::memory_order_relaxed);
+}
+
+void IndicesTransacciones::setConteo(const std::array<std::size_t, NUM_ESTADOS_TRANSACCION>& conteoRestaurado) {
+    for (std::size_t i = 0; i < NUM_ESTADOS_TRANSACCION; ++i) {
+        conteo[i].store(conteoRestaurado[i], std::memory_order_relaxed);
+    }
+}
+
+std::array<std::size_t, NUM_ESTADOS_TRANSACCION> IndicesTransacciones::getConteo() const {
+    std::array<std::size_t, NUM_ESTADOS_TRANSACCION> copia{};
+    for (std::size_t i = 0; i < NUM_ESTADOS_TRANSACCION; ++i) {
+        copia[i] = conteo[i].load(std::memory_order_relaxed);
+    }
+    return copia;
+}
+
+std::vector<std::size_t> IndicesTransacciones::getEnCurso() const {
+    std::vector<std::size_t> numeros;
+    for (const Fragmento& fragmento : fragmentos) {
+        std::lock_guard<std::mutex> bloqueo(fragmento.mutex);
+        for (const auto& conjunto : fragmento.porEstado) {
+            numeros.insert(numeros.end(), conjunto.getElementos().begin(), conjunto.getElementos().end());
+        }
+    }
+    return numeros;
+}
+
+template <typename Clave, typename Consulta>
+std::vector<std::size_t> IndicesTransacciones::juntar(const std::array<Fragmento, NUM_FRAGMENTOS>& fragmentos,
+                                                      const Clave& clave, Consulta consulta) {
+    std::vector<std::size_t> numeros;
+    for (const Fragmento& fragmento : fragmentos) {
+        std::lock_guard<std::mutex> bloqueo(fragmento.mutex);
+        const auto& indice = consulta(fragmento);
+        auto it = indice.find(clave);
+        if (it != indice.end()) {
+            numeros.insert(numeros.end(), it->second.getElementos().begin(), it->second.getElementos().end());
+        }
+    }
+    return numeros;
+}
+
+std::vector<std::size_t> IndicesTransacciones::getEnEstado(EstadoTransaccion estado) const {
+    if (!enCurso(estado)) {
+        return {};
+    }
+    std::vector<std::size_t> numeros;
+    for (const Fragmento& fragmento : fragmentos) {
+        std::lock_guard<std::mutex> bloqueo(fragmento.mutex);
+        const auto& elementos = fragmento.porEstado[static_cast<std::size_t>(estado)].getElementos();
+        numeros.insert(numeros.end(), elementos.begin(), elementos.end());
+    }
+    return numeros;
+}
+
+std::vector<std::size_t> IndicesTransacciones::getDeBoveda(HandleBoveda boveda) const {
+    return juntar(fragmentos, boveda, [](const Fragmento& fragmento) -> const auto& { return fragmento.porBoveda; });
+}
+
+std::vector<std::size_t> IndicesTransacciones::getDeBanco(HandleBanco banco) const {
+    return juntar(fragmentos, banco, [](const Fragmento& fragmento) -> const auto& { return fragmento.porBanco; });
+}
+
+std::vector<std::size_t> IndicesTransacciones::getDeTransportadora(const std::string& transportadora) const {
+    return juntar(fragmentos, transportadora,
+                  [](const Fragmento& fragmento) -> const auto& { return fragmento.porTransportadora; });
+}
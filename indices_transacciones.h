@@ -0,0 +1,88 @@
+#ifndef INDICES_TRANSACCIONES_H
+#define INDICES_TRANSACCIONES_H
+
+#include "conjunto_denso.h"
+#include "handles.h"
+#include "transaccion.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Estados en los que una transacción sigue en curso (PREPARACION..ENTREGA)
+constexpr std::size_t NUM_ESTADOS_EN_CURSO = static_cast<std::size_t>(EstadoTransaccion::COMPLETADA);
+
+// Lo que se indexa de cada transacción; no cambia durante su vida. La
+// transportadora es una vista que solo tiene que valer mientras se usa la clave.
+struct ClaveIndice {
+    std::size_t numero;
+    HandleBoveda origen;
+    HandleBoveda destino;
+    HandleBanco bancoOrigen;
+    HandleBanco bancoDestino;
+    std::string_view transportadora;
+};
+
+// Índices secundarios de las transacciones en curso, por estado, bóveda,
+// banco (de origen o de destino) y transportadora, más la cantidad de
+// transacciones en cada estado (terminadas incluidas). Se actualizan en cada
+// cambio de estado, así que una consulta cuesta lo que su resultado y el
+// conteo es O(1). Al terminar, la transacción sale de todos los índices, y
+// la bóveda, banco o transportadora que se queda sin transacciones en curso
+// se borra de su mapa.
+// Todos los métodos pueden llamarse desde varios hilos. Los índices están
+// repartidos en NUM_FRAGMENTOS fragmentos por número de transacción, cada
+// uno con su mutex, para que los hilos que avanzan transacciones distintas
+// casi nunca se esperen; las consultas recorren los fragmentos de a uno y
+// juntan lo que encuentran. Los mutex son hojas (no se toma ningún otro
+// bloqueo con ellos) y el conteo se lleva en atómicos fuera de los fragmentos.
+class IndicesTransacciones {
+private:
+    static constexpr std::size_t NUM_FRAGMENTOS = 64;
+
+    struct alignas(64) Fragmento {
+        mutable std::mutex mutex;
+        std::array<ConjuntoDenso<std::size_t>, NUM_ESTADOS_EN_CURSO> porEstado;
+        std::unordered_map<HandleBoveda, ConjuntoDenso<std::size_t>> porBoveda;
+        std::unordered_map<HandleBanco, ConjuntoDenso<std::size_t>> porBanco;
+        std::unordered_map<std::string, ConjuntoDenso<std::size_t>> porTransportadora;
+
+        void indexar(const ClaveIndice& clave, EstadoTransaccion estado);
+        void desindexar(const ClaveIndice& clave, EstadoTransaccion estado);
+    };
+
+    std::array<Fragmento, NUM_FRAGMENTOS> fragmentos;
+    std::array<std::atomic<std::size_t>, NUM_ESTADOS_TRANSACCION> conteo;
+
+    Fragmento& fragmentoDe(std::size_t numero);
+    template <typename Clave, typename Consulta>
+    static std::vector<std::size_t> juntar(const std::array<Fragmento, NUM_FRAGMENTOS>& fragmentos,
+                                           const Clave& clave, Consulta consulta);
+
+public:
+    IndicesTransacciones();
+
+    IndicesTransacciones(const IndicesTransacciones&) = delete;
+    IndicesTransacciones& operator=(const IndicesTransacciones&) = delete;
+
+    // Alta de una transacción nueva: la cuenta y, si está en curso, la indexa
+    void agregar(const ClaveIndice& clave, EstadoTransaccion estado);
+    // Para transacciones restauradas que ya están en el conteo (ver setConteo)
+    void indexar(const ClaveIndice& clave, EstadoTransaccion estado);
+    void cambiarEstado(const ClaveIndice& clave, EstadoTransaccion anterior, EstadoTransaccion nuevo);
+    void setConteo(const std::array<std::size_t, NUM_ESTADOS_TRANSACCION>& conteoRestaurado);
+
+    std::array<std::size_t, NUM_ESTADOS_TRANSACCION> getConteo() const;
+    // Números de las transacciones en curso, sin orden
+    std::vector<std::size_t> getEnCurso() const;
+    std::vector<std::size_t> getEnEstado(EstadoTransaccion estado) const;
+    std::vector<std::size_t> getDeBoveda(HandleBoveda boveda) const;
+    std::vector<std::size_t> getDeBanco(HandleBanco banco) const;
+    std::vector<std::size_t> getDeTransportadora(const std::string& transportadora) const;
+};
+
+#endif // INDICES_TRANSACCIONES_H
@@ -0,0 +1,362 @@
+#include "instantanea.h"
+#include "disco.h"
+#include "exceptions.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MAGIA[4] = {'B', 'V', 'D', 'S'};
+
+static_assert(std::is_trivially_copyable<CabeceraInstantanea>::value &&
+              std::is_trivially_copyable<BancoInstantanea>::value &&
+              std::is_trivially_copyable<BovedaInstantanea>::value &&
+              std::is_trivially_copyable<TransaccionInstantanea>::value &&
+              std::is_trivially_copyable<SerieHistorialInstantanea>::value &&
+              std::is_trivially_copyable<EventoHistorialInstantanea>::value,
+              "Los registros de la instantánea se leen directamente del archivo");
+
+// Las secciones se alinean a 8 bytes para poder leer los registros en su lugar
+std::size_t alinear(std::size_t desplazamiento) {
+    return (desplazamiento + 7) & ~std::size_t(7);
+}
+
+bool seccionValida(std::uint64_t inicio, std::uint64_t cantidad, std::size_t tamRegistro, std::size_t tamArchivo) {
+    if (inicio % alignof(std::uint64_t) != 0 || inicio > tamArchivo) {
+        return false;
+    }
+    return cantidad <= (tamArchivo - inicio) / tamRegistro;
+}
+
+} // namespace
+
+Instantanea::Instantanea(const std::string& ruta) : datos(nullptr), tamano(0), cabecera(nullptr) {
+#ifdef _WIN32
+    std::ifstream archivo(ruta, std::ios::binary);
+    if (!archivo) {
+        throw ConfiguracionInvalidaException("No se pudo abrir la instantánea: " + ruta);
+    }
+    copia.assign(std::istreambuf_iterator<char>(archivo), std::istreambuf_iterator<char>());
+    datos = copia.data();
+    tamano = copia.size();
+#else
+    int descriptor = ::open(ruta.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw ConfiguracionInvalidaException("No se pudo abrir la instantánea: " + ruta + " (" + std::strerror(errno) + ")");
+    }
+    struct stat info;
+    if (::fstat(descriptor, &info) != 0) {
+        ::close(descriptor);
+        throw ConfiguracionInvalidaException("No se pudo leer la instantánea: " + ruta);
+    }
+    tamano = static_cast<std::size_t>(info.st_size);
+    if (tamano > 0) {
+        void* proyeccion = ::mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (proyeccion == MAP_FAILED) {
+            ::close(descriptor);
+            throw ConfiguracionInvalidaException("No se pudo proyectar la instantánea: " + ruta);
+        }
+        datos = static_cast<const char*>(proyeccion);
+    }
+    // La proyección sigue siendo válida después de cerrar el descriptor
+    ::close(descriptor);
+#endif
+
+    try {
+        validar(ruta);
+    } catch (...) {
+#ifndef _WIN32
+        if (datos) {
+            ::munmap(const_cast<char*>(datos), tamano);
+        }
+#endif
+        throw;
+    }
+}
+
+Instantanea::~Instantanea() {
+#ifndef _WIN32
+    if (datos) {
+        ::munmap(const_cast<char*>(datos), tamano);
+    }
+#endif
+}
+
+void Instantanea::validar(const std::string& ruta) {
+    if (tamano < sizeof(CabeceraInstantanea)) {
+        throw ConfiguracionInvalidaException("Instantánea incompleta: " + ruta);
+    }
+    const auto* c = reinterpret_cast<const CabeceraInstantanea*>(datos);
+    if (std::memcmp(c->magia, MAGIA, sizeof(MAGIA)) != 0) {
+        throw ConfiguracionInvalidaException("El archivo no es una instantánea: " + ruta);
+    }
+    if (c->version != VERSION) {
+        throw ConfiguracionInvalidaException("Versión de instantánea no soportada: " + std::to_string(c->version));
+    }
+    if (c->ordenBytes != ORDEN_BYTES) {
+        throw ConfiguracionInvalidaException("La instantánea se escribió con otro orden de bytes: " + ruta);
+    }
+    if (!seccionValida(c->seccionBancos, c->cantidadBancos, sizeof(BancoInstantanea), tamano) ||
+        !seccionValida(c->seccionBovedas, c->cantidadBovedas, sizeof(BovedaInstantanea), tamano) ||
+        !seccionValida(c->seccionTransacciones, c->cantidadTransacciones, sizeof(TransaccionInstantanea), tamano) ||
+        !seccionValida(c->seccionRezagadas, c->cantidadRezagadas, sizeof(TransaccionInstantanea), tamano) ||
+        !seccionValida(c->seccionNumerosRezagadas, c->cantidadRezagadas, sizeof(std::uint64_t), tamano) ||
+        !seccionValida(c->seccionActivas, c->cantidadActivas, sizeof(std::uint64_t), tamano) ||
+        !seccionValida(c->seccionSeriesHistorial, c->cantidadSeriesHistorial, sizeof(SerieHistorialInstantanea), tamano) ||
+        !seccionValida(c->seccionEventosHistorial, c->cantidadEventosHistorial, sizeof(EventoHistorialInstantanea), tamano) ||
+        !seccionValida(c->seccionCadenas, c->bytesCadenas, 1, tamano)) {
+        throw ConfiguracionInvalidaException("Instantánea truncada o corrupta: " + ruta);
+    }
+    // Hay una serie como mucho por bóveda: revisarlas ya no depende de la cantidad de eventos
+    const auto* series = reinterpret_cast<const SerieHistorialInstantanea*>(datos + c->seccionSeriesHistorial);
+    for (std::uint64_t i = 0; i < c->cantidadSeriesHistorial; ++i) {
+        if (series[i].boveda >= c->cantidadBovedas || series[i].primerEvento > c->cantidadEventosHistorial ||
+            series[i].cantidadEventos > c->cantidadEventosHistorial - series[i].primerEvento) {
+            throw ConfiguracionInvalidaException("Instantánea inconsistente: historial fuera de rango en " + ruta);
+        }
+    }
+    cabecera = c;
+}
+
+std::size_t Instantanea::getCantidadBancos() const {
+    return static_cast<std::size_t>(cabecera->cantidadBancos);
+}
+
+std::size_t Instantanea::getCantidadBovedas() const {
+    return static_cast<std::size_t>(cabecera->cantidadBovedas);
+}
+
+std::size_t Instantanea::getCantidadTransacciones() const {
+    return static_cast<std::size_t>(cabecera->cantidadTransacciones);
+}
+
+std::uint64_t Instantanea::getPrimeraTransaccion() const {
+    return cabecera->primeraTransaccion;
+}
+
+std::uint64_t Instantanea::getContadorTransacciones() const {
+    return cabecera->contadorTransacciones;
+}
+
+std::uint64_t Instantanea::getRegistrosDiario() const {
+    return cabecera->registrosDiario;
+}
+
+std::chrono::system_clock::time_point Instantanea::getFecha() const {
+    return aFecha(cabecera->fecha);
+}
+
+const BancoInstantanea& Instantanea::getBanco(std::size_t i) const {
+    return reinterpret_cast<const BancoInstantanea*>(datos + cabecera->seccionBancos)[i];
+}
+
+const BovedaInstantanea& Instantanea::getBoveda(std::size_t i) const {
+    return reinterpret_cast<const BovedaInstantanea*>(datos + cabecera->seccionBovedas)[i];
+}
+
+const TransaccionInstantanea& Instantanea::getTransaccion(std::size_t i) const {
+    return reinterpret_cast<const TransaccionInstantanea*>(datos + cabecera->seccionTransacciones)[i];
+}
+
+std::size_t Instantanea::getCantidadRezagadas() const {
+    return static_cast<std::size_t>(cabecera->cantidadRezagadas);
+}
+
+const TransaccionInstantanea& Instantanea::getRezagada(std::size_t i) const {
+    return reinterpret_cast<const TransaccionInstantanea*>(datos + cabecera->seccionRezagadas)[i];
+}
+
+std::uint64_t Instantanea::getNumeroRezagada(std::size_t i) const {
+    return reinterpret_cast<const std::uint64_t*>(datos + cabecera->seccionNumerosRezagadas)[i];
+}
+
+std::size_t Instantanea::getCantidadActivas() const {
+    return static_cast<std::size_t>(cabecera->cantidadActivas);
+}
+
+std::uint64_t Instantanea::getTransaccionesEnEstado(std::size_t estado) const {
+    return cabecera->transaccionesPorEstado[estado];
+}
+
+std::uint64_t Instantanea::getActiva(std::size_t i) const {
+    return reinterpret_cast<const std::uint64_t*>(datos + cabecera->seccionActivas)[i];
+}
+
+std::size_t Instantanea::getCantidadSeriesHistorial() const {
+    return static_cast<std::size_t>(cabecera->cantidadSeriesHistorial);
+}
+
+const SerieHistorialInstantanea& Instantanea::getSerieHistorial(std::size_t i) const {
+    return reinterpret_cast<const SerieHistorialInstantanea*>(datos + cabecera->seccionSeriesHistorial)[i];
+}
+
+const EventoHistorialInstantanea* Instantanea::getEventosHistorial(const SerieHistorialInstantanea& serie) const {
+    return reinterpret_cast<const EventoHistorialInstantanea*>(datos + cabecera->seccionEventosHistorial) + serie.primerEvento;
+}
+
+std::string_view Instantanea::getCadena(const CadenaInstantanea& cadena) const {
+    if (static_cast<std::uint64_t>(cadena.desplazamiento) + cadena.longitud > cabecera->bytesCadenas) {
+        throw ConfiguracionInvalidaException("Cadena fuera de rango en la instantánea");
+    }
+    return std::string_view(datos + cabecera->seccionCadenas + cadena.desplazamiento, cadena.longitud);
+}
+
+std::chrono::system_clock::time_point Instantanea::aFecha(std::int64_t nanosegundos) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(nanosegundos)));
+}
+
+std::int64_t Instantanea::desdeFecha(std::chrono::system_clock::time_point fecha) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(fecha.time_since_epoch()).count();
+}
+
+CadenaInstantanea EscritorInstantanea::agregarCadena(std::string_view texto) {
+    auto it = cadenasGuardadas.find(std::string(texto));
+    if (it != cadenasGuardadas.end()) {
+        return it->second;
+    }
+    if (cadenas.size() + texto.size() > UINT32_MAX) {
+        throw ErrorInternoSistemaException("La instantánea excede el tamaño máximo de cadenas");
+    }
+    CadenaInstantanea cadena{static_cast<std::uint32_t>(cadenas.size()), static_cast<std::uint32_t>(texto.size())};
+    cadenas.append(texto.data(), texto.size());
+    cadenasGuardadas.emplace(std::string(texto), cadena);
+    return cadena;
+}
+
+std::uint32_t EscritorInstantanea::agregarBanco(const BancoInstantanea& banco) {
+    bancos.push_back(banco);
+    return static_cast<std::uint32_t>(bancos.size() - 1);
+}
+
+std::uint32_t EscritorInstantanea::agregarBoveda(const BovedaInstantanea& boveda) {
+    bovedas.push_back(boveda);
+    return static_cast<std::uint32_t>(bovedas.size() - 1);
+}
+
+void EscritorInstantanea::agregarTransaccion(const TransaccionInstantanea& transaccion) {
+    transacciones.push_back(transaccion);
+}
+
+void EscritorInstantanea::reservarTransacciones(std::size_t cantidad) {
+    transacciones.reserve(cantidad);
+}
+
+void EscritorInstantanea::agregarRezagada(std::uint64_t numero, const TransaccionInstantanea& transaccion) {
+    rezagadas.push_back(transaccion);
+    numerosRezagadas.push_back(numero);
+}
+
+void EscritorInstantanea::agregarActiva(std::uint64_t numero) {
+    activas.push_back(numero);
+}
+
+void EscritorInstantanea::agregarSerieHistorial(SerieHistorialInstantanea serie,
+                                                const std::vector<EventoHistorialInstantanea>& eventos) {
+    serie.primerEvento = eventosHistorial.size();
+    serie.cantidadEventos = eventos.size();
+    seriesHistorial.push_back(serie);
+    eventosHistorial.insert(eventosHistorial.end(), eventos.begin(), eventos.end());
+}
+
+void EscritorInstantanea::setPrimeraTransaccion(std::uint64_t numero) {
+    primeraTransaccion = numero;
+}
+
+void EscritorInstantanea::setTransaccionesEnEstado(std::size_t estado, std::uint64_t cantidad) {
+    transaccionesPorEstado[estado] = cantidad;
+}
+
+void EscritorInstantanea::setContadorTransacciones(std::uint64_t contador) {
+    contadorTransacciones = contador;
+}
+
+void EscritorInstantanea::setRegistrosDiario(std::uint64_t registros) {
+    registrosDiario = registros;
+}
+
+void EscritorInstantanea::escribir(const std::string& ruta) const {
+    CabeceraInstantanea c{};
+    std::memcpy(c.magia, MAGIA, sizeof(MAGIA));
+    c.version = Instantanea::VERSION;
+    c.ordenBytes = Instantanea::ORDEN_BYTES;
+    c.fecha = Instantanea::desdeFecha(std::chrono::system_clock::now());
+    c.primeraTransaccion = primeraTransaccion;
+    c.contadorTransacciones = contadorTransacciones;
+    c.registrosDiario = registrosDiario;
+    std::copy(std::begin(transaccionesPorEstado), std::end(transaccionesPorEstado), c.transaccionesPorEstado);
+    c.cantidadBancos = bancos.size();
+    c.cantidadBovedas = bovedas.size();
+    c.cantidadTransacciones = transacciones.size();
+    c.cantidadRezagadas = rezagadas.size();
+    c.cantidadActivas = activas.size();
+    c.cantidadSeriesHistorial = seriesHistorial.size();
+    c.cantidadEventosHistorial = eventosHistorial.size();
+    c.bytesCadenas = cadenas.size();
+    c.seccionBancos = alinear(sizeof(CabeceraInstantanea));
+    c.seccionBovedas = alinear(c.seccionBancos + bancos.size() * sizeof(BancoInstantanea));
+    c.seccionTransacciones = alinear(c.seccionBovedas + bovedas.size() * sizeof(BovedaInstantanea));
+    c.seccionRezagadas = alinear(c.seccionTransacciones + transacciones.size() * sizeof(TransaccionInstantanea));
+    c.seccionNumerosRezagadas = alinear(c.seccionRezagadas + rezagadas.size() * sizeof(TransaccionInstantanea));
+    c.seccionActivas = alinear(c.seccionNumerosRezagadas + numerosRezagadas.size() * sizeof(std::uint64_t));
+    c.seccionSeriesHistorial = alinear(c.seccionActivas + activas.size() * sizeof(std::uint64_t));
+    c.seccionEventosHistorial = alinear(c.seccionSeriesHistorial + seriesHistorial.size() * sizeof(SerieHistorialInstantanea));
+    c.seccionCadenas = alinear(c.seccionEventosHistorial + eventosHistorial.size() * sizeof(EventoHistorialInstantanea));
+
+    const std::string temporal = ruta + ".tmp";
+    {
+        std::ofstream archivo(temporal, std::ios::binary | std::ios::trunc);
+        if (!archivo) {
+            throw ConfiguracionInvalidaException("No se pudo crear la instantánea: " + temporal);
+        }
+
+        std::size_t posicion = 0;
+        auto escribirEn = [&](std::uint64_t desplazamiento, const void* bytes, std::size_t longitud) {
+            static const char ceros[8] = {};
+            archivo.write(ceros, static_cast<std::streamsize>(desplazamiento - posicion));
+            archivo.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(longitud));
+            posicion = static_cast<std::size_t>(desplazamiento) + longitud;
+        };
+        escribirEn(0, &c, sizeof(c));
+        escribirEn(c.seccionBancos, bancos.data(), bancos.size() * sizeof(BancoInstantanea));
+        escribirEn(c.seccionBovedas, bovedas.data(), bovedas.size() * sizeof(BovedaInstantanea));
+        escribirEn(c.seccionTransacciones, transacciones.data(), transacciones.size() * sizeof(TransaccionInstantanea));
+        escribirEn(c.seccionRezagadas, rezagadas.data(), rezagadas.size() * sizeof(TransaccionInstantanea));
+        escribirEn(c.seccionNumerosRezagadas, numerosRezagadas.data(), numerosRezagadas.size() * sizeof(std::uint64_t));
+        escribirEn(c.seccionActivas, activas.data(), activas.size() * sizeof(std::uint64_t));
+        escribirEn(c.seccionSeriesHistorial, seriesHistorial.data(), seriesHistorial.size() * sizeof(SerieHistorialInstantanea));
+        escribirEn(c.seccionEventosHistorial, eventosHistorial.data(), eventosHistorial.size() * sizeof(EventoHistorialInstantanea));
+        escribirEn(c.seccionCadenas, cadenas.data(), cadenas.size());
+
+        archivo.flush();
+        if (!archivo) {
+            std::remove(temporal.c_str());
+            throw ConfiguracionInvalidaException("No se pudo escribir la instantánea: " + temporal);
+        }
+    }
+
+    // El contenido tiene que estar en disco antes del rename; si no, una caída
+    // puede dejar el nombre nuevo apuntando a un archivo vacío o a medias
+    if (!sincronizarArchivo(temporal)) {
+        std::remove(temporal.c_str());
+        throw ConfiguracionInvalidaException("No se pudo sincronizar la instantánea: " + temporal + " (" +
+                                             std::strerror(errno) + ")");
+    }
+    if (!reemplazarArchivo(temporal, ruta)) {
+        std::remove(temporal.c_str());
+        throw ConfiguracionInvalidaException("No se pudo reemplazar la instantánea: " + ruta + " (" +
+                                             std::strerror(errno) + ")");
+    }
+}
@@ -0,0 +1,201 @@
+#ifndef INSTANTANEA_H
+#define INSTANTANEA_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Formato binario de una instantánea completa del sistema (bancos, bóvedas,
+// saldos y transacciones). Todas las secciones son arreglos de registros de
+// tamaño fijo, así que el archivo se proyecta en memoria y se usa tal cual:
+// abrir una instantánea cuesta lo mismo con diez transacciones que con un
+// millón. Los enteros se guardan en el orden de bytes del equipo que la
+// escribió; la cabecera lo verifica.
+//
+// Estructura: CabeceraInstantanea, BancoInstantanea[], BovedaInstantanea[],
+// TransaccionInstantanea[], las rezagadas (TransaccionInstantanea[] y sus
+// números), los números de las transacciones activas, el historial de saldos
+// (SerieHistorialInstantanea[] y EventoHistorialInstantanea[], vacíos si no
+// estaba habilitado) y al final las cadenas (sin terminador).
+
+struct CadenaInstantanea {
+    std::uint32_t desplazamiento; // Relativo al inicio de la sección de cadenas
+    std::uint32_t longitud;
+};
+
+struct CabeceraInstantanea {
+    char magia[4];               // "BVDS"
+    std::uint32_t version;
+    std::uint32_t ordenBytes;    // ORDEN_BYTES tal como lo escribió el equipo de origen
+    std::uint32_t reservado;
+    std::int64_t fecha;          // Nanosegundos desde la época de system_clock
+    std::uint64_t contadorTransacciones; // Próximo número de transacción
+    std::uint64_t registrosDiario; // LSN del último registro del diario incluido en la instantánea
+    std::uint64_t cantidadBancos;
+    std::uint64_t cantidadBovedas;
+    std::uint64_t cantidadTransacciones;
+    std::uint64_t bytesCadenas;
+    std::uint64_t seccionBancos; // Desplazamientos desde el inicio del archivo
+    std::uint64_t seccionBovedas;
+    std::uint64_t seccionTransacciones;
+    std::uint64_t seccionCadenas;
+    // Las transacciones anteriores a primeraTransaccion están archivadas,
+    // salvo las rezagadas (seguían activas al archivar las de su época)
+    std::uint64_t primeraTransaccion;
+    std::uint64_t cantidadRezagadas;
+    std::uint64_t seccionRezagadas;
+    std::uint64_t seccionNumerosRezagadas;
+    std::uint64_t cantidadActivas;
+    std::uint64_t seccionActivas;
+    std::uint64_t transaccionesPorEstado[6]; // Indexadas por EstadoTransaccion, archivadas incluidas
+    std::uint64_t cantidadSeriesHistorial;
+    std::uint64_t seccionSeriesHistorial;
+    std::uint64_t cantidadEventosHistorial;
+    std::uint64_t seccionEventosHistorial;
+};
+
+struct BancoInstantanea {
+    CadenaInstantanea nombre;
+    CadenaInstantanea codigo;
+    std::uint32_t primeraBoveda; // Las bóvedas de un banco son contiguas
+    std::uint32_t cantidadBovedas;
+};
+
+struct BovedaInstantanea {
+    CadenaInstantanea id;
+    CadenaInstantanea ubicacion;
+    std::uint32_t banco;
+    std::uint32_t reservado;
+    std::int64_t centesimas[3]; // Indexadas por Activo::indice
+};
+
+// La transacción en la posición i tiene el número primeraTransaccion + i (ID "TXN-%06d")
+struct TransaccionInstantanea {
+    std::uint32_t bovedaOrigen;  // Posición en la sección de bóvedas
+    std::uint32_t bovedaDestino;
+    std::int64_t centesimas;
+    double porcentajeComision;
+    double tasaADolares;          // La congelada en la transacción (ver Transaccion::getTasaADolares)
+    std::int64_t fechaCreacion;   // Nanosegundos desde la época de system_clock
+    std::int64_t fechaCompletada;
+    CadenaInstantanea transportadora;
+    CadenaInstantanea observaciones;
+    std::uint8_t tipoActivo;
+    std::uint8_t estado;
+    std::uint8_t reservado[6];
+};
+
+// Lo que conservaba el historial de saldos de una bóveda (ver
+// HistorialSaldos::SerieGuardada); sus eventos son contiguos en su sección
+struct SerieHistorialInstantanea {
+    std::uint32_t boveda; // Posición en la sección de bóvedas
+    std::uint32_t reservado;
+    std::int64_t inicio;  // Nanosegundos desde la época de system_clock
+    std::int64_t centesimas[3]; // Saldos en 'inicio', indexados por Activo::indice
+    std::uint64_t primerEvento;
+    std::uint64_t cantidadEventos;
+};
+
+struct EventoHistorialInstantanea {
+    std::int64_t instante;
+    std::int64_t delta; // Centésimas
+    std::uint8_t tipoActivo;
+    std::uint8_t reservado[7];
+};
+
+// Vista de solo lectura sobre una instantánea proyectada en memoria
+class Instantanea {
+private:
+    const char* datos;
+    std::size_t tamano;
+#ifdef _WIN32
+    std::vector<char> copia; // Sin mmap: se lee el archivo completo
+#endif
+    const CabeceraInstantanea* cabecera;
+
+    void validar(const std::string& ruta);
+
+public:
+    // 2: la cabecera lleva la fecha; 3: archivo de transacciones; 4: conteo por
+    // estado; 5: historial de saldos; 6: tasa congelada de cada transacción
+    static constexpr std::uint32_t VERSION = 6;
+    static constexpr std::uint32_t ORDEN_BYTES = 0x01020304;
+
+    explicit Instantanea(const std::string& ruta);
+    ~Instantanea();
+
+    Instantanea(const Instantanea&) = delete;
+    Instantanea& operator=(const Instantanea&) = delete;
+
+    std::size_t getCantidadBancos() const;
+    std::size_t getCantidadBovedas() const;
+    std::size_t getCantidadTransacciones() const;
+    std::uint64_t getPrimeraTransaccion() const;
+    std::uint64_t getContadorTransacciones() const;
+    std::uint64_t getRegistrosDiario() const;
+    std::chrono::system_clock::time_point getFecha() const;
+
+    const BancoInstantanea& getBanco(std::size_t i) const;
+    const BovedaInstantanea& getBoveda(std::size_t i) const;
+    const TransaccionInstantanea& getTransaccion(std::size_t i) const;
+    std::size_t getCantidadRezagadas() const;
+    const TransaccionInstantanea& getRezagada(std::size_t i) const;
+    std::uint64_t getNumeroRezagada(std::size_t i) const;
+    std::size_t getCantidadActivas() const;
+    std::uint64_t getTransaccionesEnEstado(std::size_t estado) const;
+    std::uint64_t getActiva(std::size_t i) const;
+    std::size_t getCantidadSeriesHistorial() const;
+    const SerieHistorialInstantanea& getSerieHistorial(std::size_t i) const;
+    // Los eventos de la serie (validada al abrir la instantánea)
+    const EventoHistorialInstantanea* getEventosHistorial(const SerieHistorialInstantanea& serie) const;
+    std::string_view getCadena(const CadenaInstantanea& cadena) const;
+
+    static std::chrono::system_clock::time_point aFecha(std::int64_t nanosegundos);
+    static std::int64_t desdeFecha(std::chrono::system_clock::time_point fecha);
+};
+
+// Arma una instantánea en memoria y la escribe de forma atómica y durable
+// (archivo temporal sincronizado + rename + sincronización del directorio),
+// así que una caída deja la anterior intacta o la nueva completa
+class EscritorInstantanea {
+private:
+    std::vector<BancoInstantanea> bancos;
+    std::vector<BovedaInstantanea> bovedas;
+    std::vector<TransaccionInstantanea> transacciones;
+    std::vector<TransaccionInstantanea> rezagadas;
+    std::vector<std::uint64_t> numerosRezagadas;
+    std::vector<std::uint64_t> activas;
+    std::vector<SerieHistorialInstantanea> seriesHistorial;
+    std::vector<EventoHistorialInstantanea> eventosHistorial;
+    std::string cadenas;
+    std::uint64_t primeraTransaccion = 1;
+    std::uint64_t contadorTransacciones = 1;
+    std::uint64_t registrosDiario = 0;
+    std::uint64_t transaccionesPorEstado[6] = {};
+    // Las cadenas repetidas (transportadoras, códigos) se guardan una sola vez
+    std::unordered_map<std::string, CadenaInstantanea> cadenasGuardadas;
+
+public:
+    CadenaInstantanea agregarCadena(std::string_view texto);
+
+    // Devuelve la posición asignada en su sección
+    std::uint32_t agregarBanco(const BancoInstantanea& banco);
+    std::uint32_t agregarBoveda(const BovedaInstantanea& boveda);
+    void agregarTransaccion(const TransaccionInstantanea& transaccion);
+    void reservarTransacciones(std::size_t cantidad);
+    void agregarRezagada(std::uint64_t numero, const TransaccionInstantanea& transaccion);
+    void agregarActiva(std::uint64_t numero);
+    // Completa primerEvento y cantidadEventos de la serie
+    void agregarSerieHistorial(SerieHistorialInstantanea serie, const std::vector<EventoHistorialInstantanea>& eventos);
+    void setPrimeraTransaccion(std::uint64_t numero);
+    void setTransaccionesEnEstado(std::size_t estado, std::uint64_t cantidad);
+    void setContadorTransacciones(std::uint64_t contador);
+    void setRegistrosDiario(std::uint64_t registros);
+
+    void escribir(const std::string& ruta) const;
+};
+
+#endif // INSTANTANEA_H
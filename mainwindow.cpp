@@ -5,11 +5,17 @@
 #include <QSplitter>
 #include <QHeaderView>
 #include <QApplication>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <QStringList>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , sistema(new SistemaBovedas())
+    , timerMetricas(nullptr)
+    , suscripcionCambios(0)
 {
     ui->setupUi(this);
     
@@ -17,18 +23,37 @@ MainWindow::MainWindow(QWidget *parent)
     setWindowTitle("Sistema de Gestión de Bóvedas Bancarias");
     setMinimumSize(1200, 800);
     
-    // Configurar timer para actualizaciones automáticas
-    timerActualizacion = new QTimer(this);
-    connect(timerActualizacion, &QTimer::timeout, this, &MainWindow::actualizarDashboard);
-    timerActualizacion->start(5000); // Actualizar cada 5 segundos
+    // El dashboard se actualiza con los lotes de cambios del sistema; el timer
+    // solo pasa al archivo las transacciones terminadas
+    timerArchivo = new QTimer(this);
+    connect(timerArchivo, &QTimer::timeout, this, &MainWindow::archivarTransacciones);
+    timerArchivo->start(30000);
     
     setupUI();
     inicializarSistema();
     actualizarDashboard();
+    
+    if (MetricasNucleo::HABILITADAS) {
+        timerMetricas = new QTimer(this);
+        connect(timerMetricas, &QTimer::timeout, this, &MainWindow::actualizarMetricas);
+        timerMetricas->start(1000);
+    }
+    actualizarMetricas();
 }
 
 MainWindow::~MainWindow()
 {
+    // Al volver, el publicador ya no invoca el aviso que apunta a esta ventana
+    if (suscripcionCambios != 0) {
+        sistema->getPublicador()->desuscribir(suscripcionCambios);
+    }
+    if (!rutaInstantanea.isEmpty()) {
+        try {
+            sistema->guardarInstantanea(rutaInstantanea.toStdString());
+        } catch (const BovedaException&) {
+            // El diario sigue teniendo todo el estado
+        }
+    }
     delete ui;
     delete sistema;
 }
@@ -49,7 +74,7 @@ void MainWindow::setupUI() {
     setupControlPanel();
     
     // Agregar widgets al splitter
-    splitter->addWidget(dashboardScroll);
+    splitter->addWidget(dashboardWidget);
     
     // Panel de control a la derecha
     QWidget* controlWidget = new QWidget;
@@ -133,24 +158,19 @@ void MainWindow::setupUI() {
     btnProcesarTransaccion = new QPushButton("Procesar Transacción Completa");
     transaccionesLayout->addWidget(btnProcesarTransaccion);
     
-    // Área de texto para mostrar transacciones
-    textTransacciones = new QTextEdit;
-    textTransacciones->setReadOnly(true);
-    textTransacciones->setMaximumHeight(350);
-    textTransacciones->setStyleSheet(
-        "QTextEdit {"
-        "    font-family: 'Courier New', monospace;"
-        "    font-size: 11px;"
-        "    color: #212529;"
-        "    background-color: #ffffff;"
-        "    border: 2px solid #dee2e6;"
-        "    border-radius: 5px;"
-        "    padding: 10px;"
-        "    selection-background-color: #007bff;"
-        "    selection-color: white;"
-        "}"
-    );
-    transaccionesLayout->addWidget(textTransacciones);
+    // Tabla de las últimas transacciones; al elegir una se copia su ID
+    modeloTransacciones = new ModeloTransacciones(*sistema, 200, this);
+    tablaTransacciones = new QTableView;
+    tablaTransacciones->setModel(modeloTransacciones);
+    tablaTransacciones->setSelectionBehavior(QAbstractItemView::SelectRows);
+    tablaTransacciones->setSelectionMode(QAbstractItemView::SingleSelection);
+    tablaTransacciones->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    tablaTransacciones->setAlternatingRowColors(true);
+    tablaTransacciones->verticalHeader()->hide();
+    tablaTransacciones->verticalHeader()->setDefaultSectionSize(22);
+    tablaTransacciones->horizontalHeader()->setStretchLastSection(true);
+    tablaTransacciones->setMinimumHeight(350);
+    transaccionesLayout->addWidget(tablaTransacciones);
     
     splitter->addWidget(controlWidget);
     
@@ -162,6 +182,7 @@ void MainWindow::setupUI() {
     connect(btnProcesarTransaccion, &QPushButton::clicked, this, &MainWindow::procesarTransaccion);
     connect(comboBancoOrigen, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onBancoOrigenChanged);
     connect(comboBancoDestino, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onBancoDestinoChanged);
+    connect(tablaTransacciones, &QTableView::clicked, this, &MainWindow::onTransaccionSeleccionada);
     
     // Conectar para limpiar errores cuando el usuario interactúa
     connect(lineCantidad, &QLineEdit::textChanged, this, &MainWindow::limpiarError);
@@ -172,13 +193,9 @@ void MainWindow::setupUI() {
 }
 
 void MainWindow::setupDashboard() {
-    // Crear scroll area para el dashboard
-    dashboardScroll = new QScrollArea;
-    dashboardScroll->setWidgetResizable(true);
-    dashboardScroll->setMinimumWidth(600);
-    
     dashboardWidget = new QWidget;
-    dashboardLayout = new QVBoxLayout(dashboardWidget);
+    dashboardWidget->setMinimumWidth(600);
+    QVBoxLayout* dashboardLayout = new QVBoxLayout(dashboardWidget);
     
     // Título del dashboard
     QLabel* titulo = new QLabel("Dashboard de Bancos Registrados");
@@ -186,7 +203,76 @@ void MainWindow::setupDashboard() {
     titulo->setAlignment(Qt::AlignCenter);
     dashboardLayout->addWidget(titulo);
     
-    dashboardScroll->setWidget(dashboardWidget);
+    // Árbol bancos -> bóvedas: la vista solo pinta las filas visibles
+    modeloBovedas = new ModeloBovedas(*sistema, this);
+    vistaBovedas = new QTreeView;
+    vistaBovedas->setModel(modeloBovedas);
+    vistaBovedas->setUniformRowHeights(true);
+    vistaBovedas->setAlternatingRowColors(true);
+    vistaBovedas->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    vistaBovedas->header()->setStretchLastSection(true);
+    dashboardLayout->addWidget(vistaBovedas, 1);
+    
+    // Al cambiar la estructura el modelo se reinicia: se vuelven a abrir los bancos
+    connect(modeloBovedas, &QAbstractItemModel::modelReset, vistaBovedas, &QTreeView::expandAll);
+    
+    // Resumen de transacciones
+    QGroupBox* transaccionesGroup = new QGroupBox("Estado de Transacciones");
+    transaccionesGroup->setStyleSheet(
+        "QGroupBox {"
+        "    font-weight: bold;"
+        "    font-size: 14px;"
+        "    border: 2px solid #17a2b8;"
+        "    border-radius: 5px;"
+        "    margin-top: 1ex;"
+        "    padding: 10px;"
+        "}"
+        "QGroupBox::title {"
+        "    subcontrol-origin: margin;"
+        "    left: 10px;"
+        "    padding: 0 5px 0 5px;"
+        "    color: #17a2b8;"
+        "}"
+    );
+    
+    QVBoxLayout* transaccionesLayout = new QVBoxLayout(transaccionesGroup);
+    
+    labelTotalTransacciones = new QLabel;
+    labelTotalTransacciones->setStyleSheet("font-weight: normal; color: #495057;");
+    transaccionesLayout->addWidget(labelTotalTransacciones);
+    
+    labelDetalleTransacciones = new QLabel;
+    labelDetalleTransacciones->setStyleSheet("font-weight: normal; color: #6c757d; font-size: 11px;");
+    transaccionesLayout->addWidget(labelDetalleTransacciones);
+    
+    dashboardLayout->addWidget(transaccionesGroup);
+    
+    // Latencias y errores medidos por el núcleo
+    QGroupBox* metricasGroup = new QGroupBox("Rendimiento del Núcleo");
+    metricasGroup->setStyleSheet(
+        "QGroupBox {"
+        "    font-weight: bold;"
+        "    font-size: 14px;"
+        "    border: 2px solid #6f42c1;"
+        "    border-radius: 5px;"
+        "    margin-top: 1ex;"
+        "    padding: 10px;"
+        "}"
+        "QGroupBox::title {"
+        "    subcontrol-origin: margin;"
+        "    left: 10px;"
+        "    padding: 0 5px 0 5px;"
+        "    color: #6f42c1;"
+        "}"
+    );
+    
+    QVBoxLayout* metricasLayout = new QVBoxLayout(metricasGroup);
+    labelMetricas = new QLabel;
+    labelMetricas->setStyleSheet("font-weight: normal; font-family: monospace; color: #495057; font-size: 11px;");
+    labelMetricas->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    metricasLayout->addWidget(labelMetricas);
+    
+    dashboardLayout->addWidget(metricasGroup);
 }
 
 void MainWindow::setupControlPanel() {
@@ -195,7 +281,28 @@ void MainWindow::setupControlPanel() {
 
 void MainWindow::inicializarSistema() {
     try {
-        sistema->inicializarSistema();
+        // La instantánea y el diario viven en el directorio de datos de la
+        // aplicación; si existen, el estado anterior se recupera en lugar de generarse
+        QString directorio = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+        QDir().mkpath(directorio);
+        std::string rutaDiario = QDir(directorio).filePath("bovedas.diario").toStdString();
+        QString instantanea = QDir(directorio).filePath("bovedas.instantanea");
+        sistema->habilitarHistorial();
+        if (QFile::exists(instantanea)) {
+            sistema->cargarInstantanea(instantanea.toStdString());
+            sistema->habilitarDiario(rutaDiario);
+        } else {
+            sistema->inicializarSistema(rutaDiario);
+        }
+        // Las transacciones terminadas más allá de las últimas 10000 pasan al disco
+        sistema->habilitarArchivo(QDir(directorio).filePath("bovedas.archivo").toStdString());
+        
+        // Los lotes llegan en el hilo del publicador y se aplican en el de la interfaz
+        sistema->habilitarNotificaciones();
+        suscripcionCambios = sistema->getPublicador()->suscribir([this](const LoteCambios& lote) {
+            QMetaObject::invokeMethod(this, [this, lote] { aplicarCambios(lote); }, Qt::QueuedConnection);
+        });
+        rutaInstantanea = instantanea;
         cargarDatosSistema();
         statusBar()->showMessage("Sistema inicializado con éxito", 3000);
     } catch (const BovedaException& e) {
@@ -221,200 +328,91 @@ void MainWindow::cargarDatosSistema() {
 }
 
 void MainWindow::actualizarDashboard() {
-    // Limpiar layout anterior (excepto el título)
-    while (dashboardLayout->count() > 1) {
-        QLayoutItem* item = dashboardLayout->takeAt(1);
-        if (item) {
-            if (item->widget()) {
-                item->widget()->deleteLater();
-            }
-            delete item;
-        }
+    // Resincronización completa al iniciar; el resto del
+    // tiempo los modelos se actualizan con aplicarCambios
+    try {
+        modeloBovedas->refrescar();
+        modeloTransacciones->refrescar();
+        actualizarResumenTransacciones();
+    } catch (const BovedaException& e) {
+        mostrarError(QString::fromStdString(e.what()));
     }
-    
+}
+
+void MainWindow::aplicarCambios(const LoteCambios& lote) {
     try {
-        const auto& bancos = sistema->getBancos();
-        
-        for (const auto& [codigo, banco] : bancos) {
-            // Crear grupo para cada banco
-            QGroupBox* bancoGroup = new QGroupBox(QString::fromStdString(banco->getNombre()));
-            bancoGroup->setStyleSheet(
-                "QGroupBox {"
-                "    font-weight: bold;"
-                "    font-size: 14px;"
-                "    border: 2px solid #cccccc;"
-                "    border-radius: 5px;"
-                "    margin-top: 1ex;"
-                "    padding: 10px;"
-                "}"
-                "QGroupBox::title {"
-                "    subcontrol-origin: margin;"
-                "    left: 10px;"
-                "    padding: 0 5px 0 5px;"
-                "}"
-            );
-            
-            QVBoxLayout* bancoLayout = new QVBoxLayout(bancoGroup);
-            
-            // Información general del banco
-            QLabel* infoGeneral = new QLabel(QString("Código: %1 | Activos Totales: $%2")
-                                           .arg(QString::fromStdString(codigo))
-                                           .arg(banco->getActivosTotales(), 0, 'f', 2));
-            infoGeneral->setStyleSheet(
-                "font-weight: normal;"
-                "color: #2e7d32;"
-                "font-size: 12px;"
-                "margin-bottom: 5px;"
-            );
-            bancoLayout->addWidget(infoGeneral);
-            
-            // Información de bóvedas
-            const auto& bovedas = banco->getBovedas();
-            for (const auto& boveda : bovedas) {
-                // Crear widget para cada bóveda
-                QWidget* bovedaWidget = new QWidget;
-                bovedaWidget->setStyleSheet(
-                    "background-color: #f8f9fa;"
-                    "border: 1px solid #dee2e6;"
-                    "border-radius: 3px;"
-                    "margin: 2px;"
-                    "padding: 8px;"
-                );
-                
-                QVBoxLayout* bovedaLayout = new QVBoxLayout(bovedaWidget);
-                bovedaLayout->setContentsMargins(5, 5, 5, 5);
-                
-                // Título de la bóveda
-                QLabel* tituloBovedea = new QLabel(QString("Bóveda: %1 (%2)")
-                                                 .arg(QString::fromStdString(boveda->getId()))
-                                                 .arg(QString::fromStdString(boveda->getUbicacion())));
-                tituloBovedea->setStyleSheet("font-weight: bold; color: #495057;");
-                bovedaLayout->addWidget(tituloBovedea);
-                
-                // Detalles de activos
-                QLabel* soles = new QLabel(QString("  Soles: S/ %1")
-                                         .arg(boveda->getSaldo(TipoActivo::SOLES), 0, 'f', 2));
-                soles->setStyleSheet("font-family: monospace; font-size: 11px; color: #6c757d;");
-                bovedaLayout->addWidget(soles);
-                
-                QLabel* dolares = new QLabel(QString("  Dólares: $ %1")
-                                           .arg(boveda->getSaldo(TipoActivo::DOLARES), 0, 'f', 2));
-                dolares->setStyleSheet("font-family: monospace; font-size: 11px; color: #6c757d;");
-                bovedaLayout->addWidget(dolares);
-                
-                QLabel* joyas = new QLabel(QString("  Joyas: %1 unidades")
-                                         .arg(boveda->getSaldo(TipoActivo::JOYAS), 0, 'f', 0));
-                joyas->setStyleSheet("font-family: monospace; font-size: 11px; color: #6c757d;");
-                bovedaLayout->addWidget(joyas);
-                
-                QLabel* valorTotal = new QLabel(QString("  Valor total: $ %1")
-                                              .arg(boveda->getValorTotalEnDolares(), 0, 'f', 2));
-                valorTotal->setStyleSheet("font-family: monospace; font-size: 11px; font-weight: bold; color: #28a745;");
-                bovedaLayout->addWidget(valorTotal);
-                
-                bancoLayout->addWidget(bovedaWidget);
-            }
-            
-            dashboardLayout->addWidget(bancoGroup);
+        // Solo las bóvedas y transacciones que cambiaron desde el lote anterior
+        modeloBovedas->actualizarBovedas(lote.bovedas);
+        modeloTransacciones->aplicarCambios(lote);
+        if (lote.ultimaCreada != 0 || !lote.transaccionesModificadas.empty()) {
+            actualizarResumenTransacciones();
         }
-        
-        // Agregar información de transacciones
-        QGroupBox* transaccionesGroup = new QGroupBox("Estado de Transacciones");
-        transaccionesGroup->setStyleSheet(
-            "QGroupBox {"
-            "    font-weight: bold;"
-            "    font-size: 14px;"
-            "    border: 2px solid #17a2b8;"
-            "    border-radius: 5px;"
-            "    margin-top: 1ex;"
-            "    padding: 10px;"
-            "}"
-            "QGroupBox::title {"
-            "    subcontrol-origin: margin;"
-            "    left: 10px;"
-            "    padding: 0 5px 0 5px;"
-            "    color: #17a2b8;"
-            "}"
-        );
-        
-        QVBoxLayout* transaccionesLayout = new QVBoxLayout(transaccionesGroup);
-        
-        auto transacciones = sistema->getTodasLasTransacciones();
-        QLabel* estadoTransacciones = new QLabel(QString("Transacciones Totales: %1").arg(transacciones.size()));
-        estadoTransacciones->setStyleSheet("font-weight: normal; color: #495057;");
-        transaccionesLayout->addWidget(estadoTransacciones);
-        
-        // Contar transacciones por estado
-        int activas = 0, completadas = 0, canceladas = 0;
-        for (const auto& t : transacciones) {
-            if (t->estaCompletada()) completadas++;
-            else if (t->getEstado() == EstadoTransaccion::CANCELADA) canceladas++;
-            else activas++;
-        }
-        
-        QLabel* detalleTransacciones = new QLabel(QString("Activas: %1 | Completadas: %2 | Canceladas: %3")
-                                                .arg(activas).arg(completadas).arg(canceladas));
-        detalleTransacciones->setStyleSheet("font-weight: normal; color: #6c757d; font-size: 11px;");
-        transaccionesLayout->addWidget(detalleTransacciones);
-        
-        // Mostrar últimas transacciones con detalles completos
-        QString textoTransacciones;
-        for (size_t i = 0; i < std::min(size_t(5), transacciones.size()); ++i) {
-            auto& transaccion = transacciones[transacciones.size() - 1 - i]; // Últimas primero
-            textoTransacciones += QString("╔══ TRANSACCIÓN %1 ══════════════════════════════════════╗\n")
-                                .arg(QString::fromStdString(transaccion->getId()));
-            textoTransacciones += QString("║ Tipo: %1\n")
-                                .arg(QString::fromStdString(transaccion->getTipoString()));
-            textoTransacciones += QString("║ Estado: %1\n")
-                                .arg(QString::fromStdString(transaccion->getEstadoString()));
-            textoTransacciones += QString("║ Origen: %1 - Bóveda %2\n")
-                                .arg(QString::fromStdString(transaccion->getBancoOrigenCodigo()))
-                                .arg(QString::fromStdString(transaccion->getBovedaOrigenId()));
-            textoTransacciones += QString("║ Destino: %1 - Bóveda %2\n")
-                                .arg(QString::fromStdString(transaccion->getBancoDestinoCodigo()))
-                                .arg(QString::fromStdString(transaccion->getBovedaDestinoId()));
-            textoTransacciones += QString("║ Activo: %1 %2\n")
-                                .arg(transaccion->getActivo().getCantidad(), 0, 'f', 2)
-                                .arg(QString::fromStdString(transaccion->getActivo().getTipoString()));
-            textoTransacciones += QString("║ Transportadora: %1\n")
-                                .arg(QString::fromStdString(transaccion->getTransportadora()));
-            textoTransacciones += QString("║ Comisión: %1% ($ %2)\n")
-                                .arg(transaccion->getPorcentajeComision() * 100, 0, 'f', 2)
-                                .arg(transaccion->getComision(), 0, 'f', 2);
-            textoTransacciones += QString("╚═══════════════════════════════════════════════════════════╝\n\n");
-        }
-        
-        textTransacciones->setPlainText(textoTransacciones);
-        
-        // Si no hay transacciones, mostrar mensaje informativo
-        if (transacciones.empty()) {
-            textTransacciones->setPlainText(
-                "╔═══════════════════════════════════════════════════════════╗\n"
-                "║                    SISTEMA DE TRANSACCIONES               ║\n"
-                "╠═══════════════════════════════════════════════════════════╣\n"
-                "║                                                           ║\n"
-                "║  📋 No hay transacciones registradas                     ║\n"
-                "║                                                           ║\n"
-                "║  Para crear una transacción:                             ║\n"
-                "║  1. Complete el formulario de Nueva Transferencia        ║\n"
-                "║  2. Haga clic en 'Iniciar Transferencia'                 ║\n"
-                "║  3. Use el ID generado para procesar la transacción      ║\n"
-                "║                                                           ║\n"
-                "╚═══════════════════════════════════════════════════════════╝"
-            );
+    } catch (const BovedaException& e) {
+        mostrarError(QString::fromStdString(e.what()));
+    }
+}
+
+void MainWindow::archivarTransacciones() {
+    try {
+        // Con el archivo la memoria de transacciones queda acotada; los
+        // modelos guardan copias, así que no hay nada que refrescar
+        if (sistema->getArchivo()) {
+            sistema->archivarTerminadas();
         }
-        
-        dashboardLayout->addWidget(transaccionesGroup);
-        dashboardLayout->addStretch();
-        
-        // Actualizar el widget
-        dashboardWidget->update();
-        
     } catch (const BovedaException& e) {
         mostrarError(QString::fromStdString(e.what()));
     }
 }
 
+void MainWindow::actualizarResumenTransacciones() {
+    labelTotalTransacciones->setText(QString("Transacciones Totales: %1").arg(sistema->getCantidadTransacciones()));
+    
+    // Conteo por estado mantenido por los índices del sistema
+    auto conteo = sistema->contarTransaccionesPorEstado();
+    std::size_t completadas = conteo[static_cast<std::size_t>(EstadoTransaccion::COMPLETADA)];
+    std::size_t canceladas = conteo[static_cast<std::size_t>(EstadoTransaccion::CANCELADA)];
+    std::size_t activas = 0;
+    for (std::size_t i = 0; i < static_cast<std::size_t>(EstadoTransaccion::COMPLETADA); ++i) {
+        activas += conteo[i];
+    }
+    
+    labelDetalleTransacciones->setText(QString("Activas: %1 | Completadas: %2 | Canceladas: %3")
+                                       .arg(activas).arg(completadas).arg(canceladas));
+}
+
+void MainWindow::actualizarMetricas() {
+    ResumenMetricas metricas = sistema->getMetricas();
+    if (!metricas.habilitadas) {
+        labelMetricas->setText("Compilado sin BOVEDAS_METRICAS");
+        return;
+    }
+    
+    // Una línea por operación usada; latencias en microsegundos
+    QStringList lineas;
+    lineas << QString("%1 %2 %3 %4 %5 %6")
+                  .arg("Operación", -10).arg("p50", 9).arg("p99", 9).arg("máx", 10).arg("llamadas", 9).arg("rechazos", 9);
+    for (const EstadisticasOperacion& operacion : metricas.operaciones) {
+        if (operacion.cantidad == 0) {
+            continue;
+        }
+        lineas << QString("%1 %2 %3 %4 %5 %6")
+                      .arg(QString::fromStdString(operacion.nombre), -10)
+                      .arg(operacion.latencias.percentil(0.50) / 1000.0, 9, 'f', 1)
+                      .arg(operacion.latencias.percentil(0.99) / 1000.0, 9, 'f', 1)
+                      .arg(operacion.latencias.getMaximo() / 1000.0, 10, 'f', 1)
+                      .arg(operacion.cantidad, 9)
+                      .arg(operacion.rechazadas, 9);
+    }
+    for (std::size_t i = 0; i < NUM_TIPOS_EXCEPCION; ++i) {
+        if (metricas.excepciones[i] > 0) {
+            lineas << QString("%1: %2")
+                          .arg(QString::fromStdString(MetricasNucleo::excepcionToString(static_cast<TipoExcepcion>(i))))
+                          .arg(metricas.excepciones[i]);
+        }
+    }
+    labelMetricas->setText(lineas.join('\n'));
+}
+
 void MainWindow::onBancoOrigenChanged() {
     actualizarComboBovedas(comboBancoOrigen, comboBovedaOrigen);
 }
@@ -503,9 +501,6 @@ void MainWindow::iniciarTransferencia() {
         statusBar()->showMessage(QString("Transferencia iniciada con ID: %1").arg(QString::fromStdString(transaccionId)), 5000);
         lineTransaccionId->setText(QString::fromStdString(transaccionId));
         
-        // Actualizar dashboard
-        actualizarDashboard();
-        
     } catch (const BovedaException& e) {
         mostrarError(QString::fromStdString(e.what()));
     } catch (const std::exception& e) {
@@ -527,9 +522,6 @@ void MainWindow::procesarTransaccion() {
         statusBar()->showMessage(QString("Transacción %1 procesada completamente").arg(transaccionId), 5000);
         lineTransaccionId->clear();
         
-        // Actualizar dashboard
-        actualizarDashboard();
-        
     } catch (const BovedaException& e) {
         mostrarError(QString::fromStdString(e.what()));
     } catch (const std::exception& e) {
@@ -537,6 +529,13 @@ void MainWindow::procesarTransaccion() {
     }
 }
 
+void MainWindow::onTransaccionSeleccionada(const QModelIndex& indice) {
+    QString transaccionId = modeloTransacciones->getIdTransaccion(indice.row());
+    if (!transaccionId.isEmpty()) {
+        lineTransaccionId->setText(transaccionId);
+    }
+}
+
 void MainWindow::mostrarError(const QString& mensaje) {
     statusBar()->setStyleSheet("QStatusBar { color: red; font-weight: bold; }");
     statusBar()->showMessage("ERROR: " + mensaje, 10000);
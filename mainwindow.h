@@ -7,15 +7,17 @@
 #include <QGridLayout>
 #include <QTabWidget>
 #include <QLabel>
-#include <QTextEdit>
 #include <QComboBox>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QGroupBox>
 #include <QStatusBar>
-#include <QScrollArea>
+#include <QTreeView>
+#include <QTableView>
 #include <QTimer>
 #include "sistema_bovedas.h"
+#include "modelo_bovedas.h"
+#include "modelo_transacciones.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -39,16 +41,25 @@ private slots:
     void onBancoDestinoChanged();
     void mostrarError(const QString& mensaje);
     void limpiarError();
+    void onTransaccionSeleccionada(const QModelIndex& indice);
+    void archivarTransacciones();
+    void actualizarMetricas();
 
 private:
     Ui::MainWindow *ui;
     SistemaBovedas* sistema;
-    QTimer* timerActualizacion;
+    QTimer* timerArchivo; // Mantenimiento: los cambios llegan por el publicador del sistema
+    QTimer* timerMetricas; // Las métricas cambian con cada operación: se muestran cada segundo
+    std::size_t suscripcionCambios; // 0 si no hay suscripción
+    QString rutaInstantanea; // Se escribe al cerrar para arrancar rápido la próxima vez
     
-    // Widgets del dashboard
-    QScrollArea* dashboardScroll;
+    // Widgets del dashboard: vistas sobre modelos que se refrescan por diferencias
     QWidget* dashboardWidget;
-    QVBoxLayout* dashboardLayout;
+    QTreeView* vistaBovedas;
+    ModeloBovedas* modeloBovedas;
+    QLabel* labelTotalTransacciones;
+    QLabel* labelDetalleTransacciones;
+    QLabel* labelMetricas;
     
     // Widgets del formulario de control
     QComboBox* comboBancoOrigen;
@@ -62,7 +73,8 @@ private:
     QPushButton* btnIniciarTransferencia;
     
     // Widgets de transacciones
-    QTextEdit* textTransacciones;
+    QTableView* tablaTransacciones;
+    ModeloTransacciones* modeloTransacciones;
     QPushButton* btnProcesarTransaccion;
     QLineEdit* lineTransaccionId;
     
@@ -72,5 +84,7 @@ private:
     void inicializarSistema();
     void actualizarComboBovedas(QComboBox* comboBanco, QComboBox* comboBoveda);
     void cargarDatosSistema();
+    void aplicarCambios(const LoteCambios& lote);
+    void actualizarResumenTransacciones();
 };
 #endif // MAINWINDOW_H
@@ -0,0 +1,237 @@
+#include "metricas.h"
+#include <algorithm>
+#include <cmath>
+
+std::size_t HistogramaLatencias::casilleroDe(std::uint64_t nanos) {
+    constexpr std::uint64_t SUBCASILLEROS = std::uint64_t(1) << BITS_SUBCASILLERO;
+    if (nanos < SUBCASILLEROS) {
+        return static_cast<std::size_t>(nanos);
+    }
+    // Exponente = posición del bit más alto; los BITS_SUBCASILLERO bits
+    // siguientes eligen el subcasillero dentro de la potencia de dos
+    unsigned exponente = 63;
+    while (!(nanos >> exponente)) {
+        --exponente;
+    }
+    if (exponente > EXPONENTE_MAXIMO) {
+        return NUM_CASILLEROS - 1;
+    }
+    std::uint64_t sub = (nanos >> (exponente - BITS_SUBCASILLERO)) & (SUBCASILLEROS - 1);
+    return static_cast<std::size_t>(((exponente - BITS_SUBCASILLERO + 1) << BITS_SUBCASILLERO) + sub);
+}
+
+std::uint64_t HistogramaLatencias::limiteSuperior(std::size_t casillero) {
+    constexpr std::uint64_t SUBCASILLEROS = std::uint64_t(1) << BITS_SUBCASILLERO;
+    if (casillero < SUBCASILLEROS) {
+        return casillero;
+    }
+    unsigned exponente = static_cast<unsigned>(casillero >> BITS_SUBCASILLERO) + BITS_SUBCASILLERO - 1;
+    std::uint64_t sub = casillero & (SUBCASILLEROS - 1);
+    std::uint64_t ancho = std::uint64_t(1) << (exponente - BITS_SUBCASILLERO);
+    return (std::uint64_t(1) << exponente) + (sub + 1) * ancho - 1;
+}
+
+HistogramaLatencias::HistogramaLatencias() : casilleros(NUM_CASILLEROS, 0), cantidad(0), maximo(0) {}
+
+void HistogramaLatencias::agregar(std::size_t casillero, std::uint64_t cantidadAgregada) {
+    casilleros[casillero] += cantidadAgregada;
+    cantidad += cantidadAgregada;
+}
+
+void HistogramaLatencias::ajustarMaximo(std::uint64_t nanos) {
+    maximo = std::max(maximo, nanos);
+}
+
+void HistogramaLatencias::registrar(std::uint64_t nanos) {
+    agregar(casilleroDe(nanos), 1);
+    ajustarMaximo(nanos);
+}
+
+std::uint64_t HistogramaLatencias::percentil(double p) const {
+    if (cantidad == 0) {
+        return 0;
+    }
+    // Rango más cercano, igual que en bovedas_carga
+    std::uint64_t rango = static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(cantidad)));
+    rango = std::min(cantidad, std::max<std::uint64_t>(rango, 1));
+    std::uint64_t acumulado = 0;
+    for (std::size_t i = 0; i < casilleros.size(); ++i) {
+        acumulado += casilleros[i];
+        if (acumulado >= rango) {
+            return std::min(limiteSuperior(i), maximo);
+        }
+    }
+    return maximo;
+}
+
+#ifdef BOVEDAS_METRICAS
+
+MetricasNucleo::MetricasNucleo()
+    : fragmentos(new Fragmento[NUM_FRAGMENTOS]()), inicio(Reloj::now().time_since_epoch().count()) {}
+
+std::size_t MetricasNucleo::fragmentoDelHilo() {
+    // Cada hilo recibe un fragmento fijo la primera vez que registra
+    static std::atomic<std::size_t> siguiente{0};
+    thread_local std::size_t fragmento = siguiente.fetch_add(1, std::memory_order_relaxed) % NUM_FRAGMENTOS;
+    return fragmento;
+}
+
+void MetricasNucleo::registrar(OperacionMetrica operacion, Reloj::time_point desde, CodigoError codigo) {
+    std::uint64_t nanos = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Reloj::now() - desde).count());
+    Fragmento& fragmento = fragmentos[fragmentoDelHilo()];
+    ContadoresOperacion& contadores = fragmento.operaciones[static_cast<std::size_t>(operacion)];
+
+    contadores.casilleros[HistogramaLatencias::casilleroDe(nanos)].fetch_add(1, std::memory_order_relaxed);
+    contadores.nsTotal.fetch_add(nanos, std::memory_order_relaxed);
+    std::uint64_t maximo = contadores.nsMaximo.load(std::memory_order_relaxed);
+    while (nanos > maximo && !contadores.nsMaximo.compare_exchange_weak(maximo, nanos, std::memory_order_relaxed)) {
+    }
+    if (codigo != CodigoError::NINGUNO) {
+        contadores.rechazadas.fetch_add(1, std::memory_order_relaxed);
+        fragmento.excepciones[static_cast<std::size_t>(excepcionDe(codigo))].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void MetricasNucleo::registrarExcepcion(OperacionMetrica operacion, Reloj::time_point desde,
+                                        const BovedaException& excepcion) {
+    // Como un rechazo, pero contando el tipo real de la excepción
+    registrar(operacion, desde, CodigoError::NINGUNO);
+    Fragmento& fragmento = fragmentos[fragmentoDelHilo()];
+    fragmento.operaciones[static_cast<std::size_t>(operacion)].rechazadas.fetch_add(1, std::memory_order_relaxed);
+    fragmento.excepciones[static_cast<std::size_t>(excepcionDe(excepcion))].fetch_add(1, std::memory_order_relaxed);
+}
+
+ResumenMetricas MetricasNucleo::getResumen() const {
+    ResumenMetricas resumen;
+    resumen.habilitadas = true;
+    Reloj::time_point desde{Reloj::duration(inicio.load(std::memory_order_relaxed))};
+    resumen.segundos = std::chrono::duration<double>(Reloj::now() - desde).count();
+    resumen.excepciones.fill(0);
+
+    for (std::size_t op = 0; op < NUM_OPERACIONES_METRICA; ++op) {
+        EstadisticasOperacion estadisticas{operacionToString(static_cast<OperacionMetrica>(op)), 0, 0, 0.0, 0.0, {}};
+        std::uint64_t nsTotal = 0;
+        for (std::size_t f = 0; f < NUM_FRAGMENTOS; ++f) {
+            const ContadoresOperacion& contadores = fragmentos[f].operaciones[op];
+            for (std::size_t c = 0; c < HistogramaLatencias::NUM_CASILLEROS; ++c) {
+                std::uint64_t cantidad = contadores.casilleros[c].load(std::memory_order_relaxed);
+                if (cantidad > 0) {
+                    estadisticas.latencias.agregar(c, cantidad);
+                }
+            }
+            estadisticas.rechazadas += contadores.rechazadas.load(std::memory_order_relaxed);
+            nsTotal += contadores.nsTotal.load(std::memory_order_relaxed);
+            estadisticas.latencias.ajustarMaximo(contadores.nsMaximo.load(std::memory_order_relaxed));
+        }
+        estadisticas.cantidad = estadisticas.latencias.getCantidad();
+        if (estadisticas.cantidad > 0) {
+            estadisticas.nsPromedio = static_cast<double>(nsTotal) / static_cast<double>(estadisticas.cantidad);
+        }
+        if (resumen.segundos > 0) {
+            estadisticas.porSegundo = static_cast<double>(estadisticas.cantidad) / resumen.segundos;
+        }
+        resumen.operaciones.push_back(std::move(estadisticas));
+    }
+
+    for (std::size_t f = 0; f < NUM_FRAGMENTOS; ++f) {
+        for (std::size_t t = 0; t < NUM_TIPOS_EXCEPCION; ++t) {
+            resumen.excepciones[t] += fragmentos[f].excepciones[t].load(std::memory_order_relaxed);
+        }
+    }
+    return resumen;
+}
+
+void MetricasNucleo::reiniciar() {
+    for (std::size_t f = 0; f < NUM_FRAGMENTOS; ++f) {
+        for (ContadoresOperacion& contadores : fragmentos[f].operaciones) {
+            for (auto& casillero : contadores.casilleros) {
+                casillero.store(0, std::memory_order_relaxed);
+            }
+            contadores.rechazadas.store(0, std::memory_order_relaxed);
+            contadores.nsTotal.store(0, std::memory_order_relaxed);
+            contadores.nsMaximo.store(0, std::memory_order_relaxed);
+        }
+        for (auto& excepcion : fragmentos[f].excepciones) {
+            excepcion.store(0, std::memory_order_relaxed);
+        }
+    }
+    inicio.store(Reloj::now().time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+#else
+
+MetricasNucleo::MetricasNucleo() = default;
+
+ResumenMetricas MetricasNucleo::getResumen() const {
+    ResumenMetricas resumen;
+    resumen.habilitadas = false;
+    resumen.segundos = 0.0;
+    resumen.excepciones.fill(0);
+    for (std::size_t op = 0; op < NUM_OPERACIONES_METRICA; ++op) {
+        resumen.operaciones.push_back({operacionToString(static_cast<OperacionMetrica>(op)), 0, 0, 0.0, 0.0, {}});
+    }
+    return resumen;
+}
+
+void MetricasNucleo::reiniciar() {}
+
+#endif // BOVEDAS_METRICAS
+
+MetricasNucleo::~MetricasNucleo() = default;
+
+std::string MetricasNucleo::operacionToString(OperacionMetrica operacion) {
+    switch (operacion) {
+        case OperacionMetrica::INICIAR: return "iniciar";
+        case OperacionMetrica::PROCESAR: return "procesar";
+        case OperacionMetrica::AVANZAR: return "avanzar";
+        case OperacionMetrica::CANCELAR: return "cancelar";
+        case OperacionMetrica::BUSCAR: return "buscar";
+        default: return "desconocida";
+    }
+}
+
+std::string MetricasNucleo::excepcionToString(TipoExcepcion tipo) {
+    switch (tipo) {
+        case TipoExcepcion::SALDO_INSUFICIENTE: return "SaldoInsuficienteException";
+        case TipoExcepcion::ACTIVO_NO_DISPONIBLE: return "ActivoNoDisponibleException";
+        case TipoExcepcion::OPERACION_INVALIDA: return "OperacionInvalidaException";
+        case TipoExcepcion::TIPO_OPERACION_NO_SOPORTADO: return "TipoOperacionNoSoportadoException";
+        case TipoExcepcion::DATOS_INVALIDOS: return "DatosInvalidosException";
+        case TipoExcepcion::BOVEDA_NO_ENCONTRADA: return "BovedaNoEncontradaException";
+        case TipoExcepcion::ENTIDAD_BANCARIA_NO_ENCONTRADA: return "EntidadBancariaNoEncontradaException";
+        case TipoExcepcion::TRANSPORTADORA_NO_DISPONIBLE: return "TransportadoraNoDisponibleException";
+        case TipoExcepcion::CONFIGURACION_INVALIDA: return "ConfiguracionInvalidaException";
+        case TipoExcepcion::ERROR_INTERNO: return "ErrorInternoSistemaException";
+        default: return "BovedaException";
+    }
+}
+
+TipoExcepcion MetricasNucleo::excepcionDe(CodigoError codigo) {
+    // La misma correspondencia que ErrorBoveda::lanzar()
+    switch (codigo) {
+        case CodigoError::SALDO_INSUFICIENTE: return TipoExcepcion::SALDO_INSUFICIENTE;
+        case CodigoError::BOVEDA_NO_ENCONTRADA: return TipoExcepcion::BOVEDA_NO_ENCONTRADA;
+        case CodigoError::BANCO_NO_ENCONTRADO: return TipoExcepcion::ENTIDAD_BANCARIA_NO_ENCONTRADA;
+        case CodigoError::DATOS_INVALIDOS: return TipoExcepcion::DATOS_INVALIDOS;
+        case CodigoError::TRANSACCION_NO_ENCONTRADA:
+        case CodigoError::TRANSACCION_ARCHIVADA:
+        case CodigoError::OPERACION_INVALIDA: return TipoExcepcion::OPERACION_INVALIDA;
+        case CodigoError::NINGUNO: break;
+    }
+    return TipoExcepcion::ERROR_INTERNO;
+}
+
+TipoExcepcion MetricasNucleo::excepcionDe(const BovedaException& excepcion) {
+    if (dynamic_cast<const SaldoInsuficienteException*>(&excepcion)) return TipoExcepcion::SALDO_INSUFICIENTE;
+    if (dynamic_cast<const ActivoNoDisponibleException*>(&excepcion)) return TipoExcepcion::ACTIVO_NO_DISPONIBLE;
+    if (dynamic_cast<const OperacionInvalidaException*>(&excepcion)) return TipoExcepcion::OPERACION_INVALIDA;
+    if (dynamic_cast<const TipoOperacionNoSoportadoException*>(&excepcion)) return TipoExcepcion::TIPO_OPERACION_NO_SOPORTADO;
+    if (dynamic_cast<const DatosInvalidosException*>(&excepcion)) return TipoExcepcion::DATOS_INVALIDOS;
+    if (dynamic_cast<const BovedaNoEncontradaException*>(&excepcion)) return TipoExcepcion::BOVEDA_NO_ENCONTRADA;
+    if (dynamic_cast<const EntidadBancariaNoEncontradaException*>(&excepcion)) return TipoExcepcion::ENTIDAD_BANCARIA_NO_ENCONTRADA;
+    if (dynamic_cast<const TransportadoraNoDisponibleException*>(&excepcion)) return TipoExcepcion::TRANSPORTADORA_NO_DISPONIBLE;
+    if (dynamic_cast<const ConfiguracionInvalidaException*>(&excepcion)) return TipoExcepcion::CONFIGURACION_INVALIDA;
+    if (dynamic_cast<const ErrorInternoSistemaException*>(&excepcion)) return TipoExcepcion::ERROR_INTERNO;
+    return TipoExcepcion::OTRA;
+}
@@ -0,0 +1,186 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include "exceptions.h"
+#include "resultado.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Operaciones instrumentadas de SistemaBovedas (las "intentar..." y sus
+// versiones que lanzan cuentan como la misma operación)
+enum class OperacionMetrica {
+    INICIAR,  // iniciarTransferencia
+    PROCESAR, // procesarTransaccion
+    AVANZAR,  // avanzarEtapaTransaccion
+    CANCELAR, // cancelarTransaccion
+    BUSCAR    // buscarTransaccion
+};
+
+constexpr std::size_t NUM_OPERACIONES_METRICA = 5;
+
+// Una por cada excepción de exceptions.h (BovedaException aparte)
+enum class TipoExcepcion {
+    SALDO_INSUFICIENTE,
+    ACTIVO_NO_DISPONIBLE,
+    OPERACION_INVALIDA,
+    TIPO_OPERACION_NO_SOPORTADO,
+    DATOS_INVALIDOS,
+    BOVEDA_NO_ENCONTRADA,
+    ENTIDAD_BANCARIA_NO_ENCONTRADA,
+    TRANSPORTADORA_NO_DISPONIBLE,
+    CONFIGURACION_INVALIDA,
+    ERROR_INTERNO,
+    OTRA // BovedaException sin subclase
+};
+
+constexpr std::size_t NUM_TIPOS_EXCEPCION = 11;
+
+// Histograma de latencias en nanosegundos al estilo HDR: los valores
+// menores que 16 tienen su propio casillero y de ahí en adelante cada
+// potencia de dos se parte en 16, así que el error relativo de cualquier
+// percentil es menor que 1/16. Lo que pasa de 2^36 ns (~69 s) cae en el
+// último casillero. Es la forma que tiene en las lecturas (ResumenMetricas);
+// el registro concurrente lo hace MetricasNucleo.
+class HistogramaLatencias {
+public:
+    static constexpr unsigned BITS_SUBCASILLERO = 4;
+    static constexpr unsigned EXPONENTE_MAXIMO = 36;
+    static constexpr std::size_t NUM_CASILLEROS =
+        (EXPONENTE_MAXIMO - BITS_SUBCASILLERO + 2) << BITS_SUBCASILLERO;
+
+    static std::size_t casilleroDe(std::uint64_t nanos);
+    static std::uint64_t limiteSuperior(std::size_t casillero); // Mayor valor que cae en él
+
+    HistogramaLatencias();
+
+    // Suma muestras ya clasificadas; el máximo exacto se informa aparte
+    void agregar(std::size_t casillero, std::uint64_t cantidad);
+    void ajustarMaximo(std::uint64_t nanos);
+    void registrar(std::uint64_t nanos);
+
+    std::uint64_t getCantidad() const { return cantidad; }
+    std::uint64_t getMaximo() const { return maximo; }
+    // Valor bajo el cual cae la fracción p (0..1) de las muestras: el límite
+    // superior de su casillero, sin pasar del máximo. 0 sin muestras.
+    std::uint64_t percentil(double p) const;
+
+private:
+    std::vector<std::uint64_t> casilleros;
+    std::uint64_t cantidad;
+    std::uint64_t maximo;
+};
+
+struct EstadisticasOperacion {
+    std::string nombre;
+    std::uint64_t cantidad;   // Llamadas terminadas, con o sin éxito
+    std::uint64_t rechazadas; // Las que devolvieron error o lanzaron
+    double porSegundo;        // Llamadas desde que se crearon o reiniciaron las métricas
+    double nsPromedio;
+    HistogramaLatencias latencias;
+};
+
+struct ResumenMetricas {
+    bool habilitadas; // false si se compiló sin BOVEDAS_METRICAS (todo en cero)
+    double segundos;  // Desde que se crearon o reiniciaron las métricas
+    std::vector<EstadisticasOperacion> operaciones; // Indexado por OperacionMetrica
+    std::array<std::uint64_t, NUM_TIPOS_EXCEPCION> excepciones; // Indexado por TipoExcepcion
+};
+
+// Latencias, cantidades y errores de las operaciones del núcleo. Registrar
+// es barato y no bloquea: cada hilo escribe con sumas atómicas relajadas en
+// su propio fragmento (como AcumuladorSaldos), y getResumen() los suma.
+//
+// Los errores se cuentan por la excepción de exceptions.h que representan:
+// los de un Resultado por la que lanzaría valor(), y las excepciones que
+// atraviesan la operación por su tipo.
+//
+// Si el núcleo se compila sin BOVEDAS_METRICAS (opción de CMake) la clase
+// queda vacía, medir() solo llama a la función y no hay costo alguno.
+class MetricasNucleo {
+public:
+#ifdef BOVEDAS_METRICAS
+    static constexpr bool HABILITADAS = true;
+#else
+    static constexpr bool HABILITADAS = false;
+#endif
+
+    MetricasNucleo();
+    ~MetricasNucleo();
+    MetricasNucleo(const MetricasNucleo&) = delete;
+    MetricasNucleo& operator=(const MetricasNucleo&) = delete;
+
+    // Ejecuta la operación y registra su latencia y su resultado
+    template <typename Funcion>
+    auto medir(OperacionMetrica operacion, Funcion funcion) -> decltype(funcion());
+
+    ResumenMetricas getResumen() const;
+    // No debe llamarse mientras haya operaciones en curso
+    void reiniciar();
+
+    static std::string operacionToString(OperacionMetrica operacion);
+    static std::string excepcionToString(TipoExcepcion tipo);
+    static TipoExcepcion excepcionDe(CodigoError codigo);
+    static TipoExcepcion excepcionDe(const BovedaException& excepcion);
+
+private:
+#ifdef BOVEDAS_METRICAS
+    using Reloj = std::chrono::steady_clock;
+
+    static constexpr std::size_t NUM_FRAGMENTOS = 16;
+
+    struct alignas(64) ContadoresOperacion {
+        std::array<std::atomic<std::uint64_t>, HistogramaLatencias::NUM_CASILLEROS> casilleros;
+        std::atomic<std::uint64_t> rechazadas;
+        std::atomic<std::uint64_t> nsTotal;
+        std::atomic<std::uint64_t> nsMaximo;
+    };
+
+    struct Fragmento {
+        std::array<ContadoresOperacion, NUM_OPERACIONES_METRICA> operaciones;
+        alignas(64) std::array<std::atomic<std::uint64_t>, NUM_TIPOS_EXCEPCION> excepciones;
+    };
+
+    std::unique_ptr<Fragmento[]> fragmentos;
+    std::atomic<Reloj::rep> inicio; // Reloj::time_point del último reinicio
+
+    static std::size_t fragmentoDelHilo();
+    void registrar(OperacionMetrica operacion, Reloj::time_point desde, CodigoError codigo);
+    void registrarExcepcion(OperacionMetrica operacion, Reloj::time_point desde, const BovedaException& excepcion);
+
+    template <typename T>
+    static CodigoError codigoDe(const Resultado<T>& resultado) { return resultado.getCodigo(); }
+    template <typename T>
+    static CodigoError codigoDe(const T&) { return CodigoError::NINGUNO; }
+#endif
+};
+
+template <typename Funcion>
+auto MetricasNucleo::medir(OperacionMetrica operacion, Funcion funcion) -> decltype(funcion()) {
+#ifdef BOVEDAS_METRICAS
+    Reloj::time_point desde = Reloj::now();
+    try {
+        if constexpr (std::is_void_v<decltype(funcion())>) {
+            funcion();
+            registrar(operacion, desde, CodigoError::NINGUNO);
+        } else {
+            auto resultado = funcion();
+            registrar(operacion, desde, codigoDe(resultado));
+            return resultado;
+        }
+    } catch (const BovedaException& e) {
+        registrarExcepcion(operacion, desde, e);
+        throw;
+    }
+#else
+    (void)operacion;
+    return funcion();
+#endif
+}
+
+#endif // METRICAS_H
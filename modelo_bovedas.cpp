@@ -0,0 +1,262 @@
+#include "modelo_bovedas.h"
+#include <QBrush>
+#include <QColor>
+#include <QFont>
+
+namespace {
+
+// internalId de los índices: 0 para un banco, fila del banco + 1 para sus bóvedas
+constexpr quintptr ID_BANCO = 0;
+
+} // namespace
+
+ModeloBovedas::ModeloBovedas(SistemaBovedas& sistema, QObject* parent)
+    : QAbstractItemModel(parent), sistema(sistema), tasas(ProveedorTasas::getGlobal().getActuales()) {}
+
+void ModeloBovedas::refrescar() {
+    if (cambioLaEstructura()) {
+        beginResetModel();
+        reconstruir();
+        endResetModel();
+        return;
+    }
+
+    revaluar();
+    for (std::size_t filaBanco = 0; filaBanco < filas.size(); ++filaBanco) {
+        for (std::size_t fila = 0; fila < filas[filaBanco].bovedas.size(); ++fila) {
+            actualizarFilaBoveda(filaBanco, fila);
+        }
+        actualizarFilaBanco(filaBanco);
+    }
+}
+
+void ModeloBovedas::actualizarBovedas(const std::vector<const Boveda*>& bovedas) {
+    revaluar();
+    std::vector<bool> bancosTocados(filas.size(), false);
+    for (const Boveda* boveda : bovedas) {
+        auto it = posiciones.find(boveda);
+        if (it == posiciones.end()) {
+            // Bóveda que el modelo no conoce: cambió la estructura
+            refrescar();
+            return;
+        }
+        auto [filaBanco, fila] = it->second;
+        actualizarFilaBoveda(filaBanco, fila);
+        bancosTocados[filaBanco] = true;
+    }
+    for (std::size_t filaBanco = 0; filaBanco < filas.size(); ++filaBanco) {
+        if (bancosTocados[filaBanco]) {
+            actualizarFilaBanco(filaBanco);
+        }
+    }
+}
+
+void ModeloBovedas::revaluar() {
+    std::shared_ptr<const TasasCambio> actuales = ProveedorTasas::getGlobal().getActuales();
+    if (actuales->epoca == tasas->epoca) {
+        return;
+    }
+    tasas = std::move(actuales);
+
+    // Una pasada sobre los saldos ya copiados, sin leer las bóvedas; la
+    // vista recibe un único aviso por columna de cada nivel del árbol
+    for (FilaBanco& banco : filas) {
+        banco.valuacion.revaluar(*tasas);
+        for (FilaBoveda& boveda : banco.bovedas) {
+            boveda.valuacion.revaluar(*tasas);
+        }
+    }
+    if (filas.empty()) {
+        return;
+    }
+    emit dataChanged(index(0, COLUMNA_VALOR), index(static_cast<int>(filas.size()) - 1, COLUMNA_VALOR));
+    for (std::size_t filaBanco = 0; filaBanco < filas.size(); ++filaBanco) {
+        if (filas[filaBanco].bovedas.empty()) {
+            continue;
+        }
+        QModelIndex indiceBanco = index(static_cast<int>(filaBanco), 0);
+        emit dataChanged(index(0, COLUMNA_VALOR, indiceBanco),
+                         index(static_cast<int>(filas[filaBanco].bovedas.size()) - 1, COLUMNA_VALOR, indiceBanco));
+    }
+}
+
+void ModeloBovedas::actualizarFilaBoveda(std::size_t filaBanco, std::size_t fila) {
+    FilaBoveda& boveda = filas[filaBanco].bovedas[fila];
+    // La época ya es la de 'tasas': solo cambia si cambiaron los saldos
+    if (!boveda.boveda->valuar(boveda.valuacion, *tasas)) {
+        return;
+    }
+    QModelIndex indiceBanco = index(static_cast<int>(filaBanco), 0);
+    emit dataChanged(index(static_cast<int>(fila), COLUMNA_SOLES, indiceBanco),
+                     index(static_cast<int>(fila), COLUMNA_VALOR, indiceBanco));
+}
+
+void ModeloBovedas::actualizarFilaBanco(std::size_t filaBanco) {
+    FilaBanco& banco = filas[filaBanco];
+    // Los totales del banco son O(1): no hace falta sumar sus bóvedas
+    if (!banco.banco->valuar(banco.valuacion, *tasas)) {
+        return;
+    }
+    emit dataChanged(index(static_cast<int>(filaBanco), COLUMNA_SOLES),
+                     index(static_cast<int>(filaBanco), COLUMNA_VALOR));
+}
+
+bool ModeloBovedas::cambioLaEstructura() const {
+    const auto& bancos = sistema.getBancos();
+    if (bancos.size() != filas.size()) {
+        return true;
+    }
+    std::size_t filaBanco = 0;
+    for (const auto& [codigo, banco] : bancos) {
+        const FilaBanco& fila = filas[filaBanco++];
+        if (fila.banco != banco.get()) {
+            return true;
+        }
+        const auto& bovedas = banco->getBovedas();
+        if (bovedas.size() != fila.bovedas.size()) {
+            return true;
+        }
+        for (std::size_t i = 0; i < bovedas.size(); ++i) {
+            if (fila.bovedas[i].boveda != bovedas[i].get()) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ModeloBovedas::reconstruir() {
+    tasas = ProveedorTasas::getGlobal().getActuales();
+    filas.clear();
+    posiciones.clear();
+    const auto& bancos = sistema.getBancos();
+    filas.reserve(bancos.size());
+    for (const auto& [codigo, banco] : bancos) {
+        FilaBanco fila{banco.get(),
+                       QString::fromStdString(codigo),
+                       QString::fromStdString(banco->getNombre()),
+                       {},
+                       {}};
+        banco->valuar(fila.valuacion, *tasas);
+        const auto& bovedas = banco->getBovedas();
+        fila.bovedas.reserve(bovedas.size());
+        for (const auto& boveda : bovedas) {
+            posiciones[boveda.get()] = {filas.size(), fila.bovedas.size()};
+            FilaBoveda filaBoveda{boveda.get(),
+                                  QString::fromStdString(boveda->getId()),
+                                  QString::fromStdString(boveda->getUbicacion()),
+                                  {}};
+            boveda->valuar(filaBoveda.valuacion, *tasas);
+            fila.bovedas.push_back(std::move(filaBoveda));
+        }
+        filas.push_back(std::move(fila));
+    }
+}
+
+QModelIndex ModeloBovedas::index(int row, int column, const QModelIndex& parent) const {
+    if (!hasIndex(row, column, parent)) {
+        return QModelIndex();
+    }
+    if (!parent.isValid()) {
+        return createIndex(row, column, ID_BANCO);
+    }
+    return createIndex(row, column, static_cast<quintptr>(parent.row()) + 1);
+}
+
+QModelIndex ModeloBovedas::parent(const QModelIndex& child) const {
+    if (!child.isValid() || child.internalId() == ID_BANCO) {
+        return QModelIndex();
+    }
+    return createIndex(static_cast<int>(child.internalId() - 1), 0, ID_BANCO);
+}
+
+int ModeloBovedas::rowCount(const QModelIndex& parent) const {
+    if (!parent.isValid()) {
+        return static_cast<int>(filas.size());
+    }
+    // Solo la primera columna de un banco tiene hijos
+    if (parent.internalId() != ID_BANCO || parent.column() != 0) {
+        return 0;
+    }
+    return static_cast<int>(filas[parent.row()].bovedas.size());
+}
+
+int ModeloBovedas::columnCount(const QModelIndex& parent) const {
+    (void)parent;
+    return NUM_COLUMNAS;
+}
+
+QVariant ModeloBovedas::textoColumna(int columna, const ValuacionSaldos& valuacion) {
+    const SaldosBoveda& saldos = valuacion.getSaldos();
+    switch (columna) {
+        case COLUMNA_SOLES:
+            return QString("S/ %1").arg(saldos[static_cast<std::size_t>(TipoActivo::SOLES)].aDouble(), 0, 'f', 2);
+        case COLUMNA_DOLARES:
+            return QString("$ %1").arg(saldos[static_cast<std::size_t>(TipoActivo::DOLARES)].aDouble(), 0, 'f', 2);
+        case COLUMNA_JOYAS:
+            return QString("%1 unidades").arg(saldos[static_cast<std::size_t>(TipoActivo::JOYAS)].aDouble(), 0, 'f', 0);
+        case COLUMNA_VALOR:
+            return QString("$ %1").arg(valuacion.getValor(), 0, 'f', 2);
+        default:
+            return QVariant();
+    }
+}
+
+QVariant ModeloBovedas::data(const QModelIndex& index, int role) const {
+    if (!index.isValid()) {
+        return QVariant();
+    }
+    bool esBanco = index.internalId() == ID_BANCO;
+    int columna = index.column();
+
+    // El texto se arma aquí, solo para las celdas que la vista pinta
+    if (role == Qt::DisplayRole) {
+        if (esBanco) {
+            const FilaBanco& banco = filas[index.row()];
+            if (columna == COLUMNA_NOMBRE) {
+                return QString("%1 (%2)").arg(banco.nombre, banco.codigo);
+            }
+            return textoColumna(columna, banco.valuacion);
+        }
+        const FilaBoveda& boveda = filas[index.internalId() - 1].bovedas[index.row()];
+        if (columna == COLUMNA_NOMBRE) {
+            return boveda.id;
+        }
+        if (columna == COLUMNA_UBICACION) {
+            return boveda.ubicacion;
+        }
+        return textoColumna(columna, boveda.valuacion);
+    }
+    if (role == Qt::TextAlignmentRole && columna >= COLUMNA_SOLES) {
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    if (role == Qt::FontRole && (esBanco || columna == COLUMNA_VALOR)) {
+        QFont fuente;
+        fuente.setBold(true);
+        return fuente;
+    }
+    if (role == Qt::ForegroundRole) {
+        if (columna == COLUMNA_VALOR) {
+            return QBrush(QColor("#28a745"));
+        }
+        if (esBanco) {
+            return QBrush(QColor("#2e7d32"));
+        }
+    }
+    return QVariant();
+}
+
+QVariant ModeloBovedas::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    switch (section) {
+        case COLUMNA_NOMBRE: return QString("Banco / Bóveda");
+        case COLUMNA_UBICACION: return QString("Ubicación");
+        case COLUMNA_SOLES: return QString("Soles");
+        case COLUMNA_DOLARES: return QString("Dólares");
+        case COLUMNA_JOYAS: return QString("Joyas");
+        case COLUMNA_VALOR: return QString("Valor total");
+        default: return QVariant();
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef MODELO_BOVEDAS_H
+#define MODELO_BOVEDAS_H
+
+#include <QAbstractItemModel>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "sistema_bovedas.h"
+#include "tasas_cambio.h"
+
+// Árbol bancos -> bóvedas para el dashboard. Cada fila guarda la
+// ValuacionSaldos de lo que muestra; refrescar() la pone al día y solo avisa
+// (dataChanged) de las filas que cambiaron, así la vista repinta lo visible
+// y nada más. Todas las filas se valúan con las tasas de una sola época; si
+// cambian, se revalúan de una vez desde los saldos ya guardados.
+class ModeloBovedas : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Columna {
+        COLUMNA_NOMBRE,
+        COLUMNA_UBICACION,
+        COLUMNA_SOLES,
+        COLUMNA_DOLARES,
+        COLUMNA_JOYAS,
+        COLUMNA_VALOR,
+        NUM_COLUMNAS
+    };
+
+    explicit ModeloBovedas(SistemaBovedas& sistema, QObject* parent = nullptr);
+
+    // Si cambiaron los bancos o sus bóvedas se reinicia el modelo; si no,
+    // solo se avisan las filas cuyos saldos cambiaron
+    void refrescar();
+    // Solo las bóvedas indicadas (las de un LoteCambios) y sus bancos
+    void actualizarBovedas(const std::vector<const Boveda*>& bovedas);
+    // Revalúa todas las filas si hay tasas de una época posterior
+    void revaluar();
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    struct FilaBoveda {
+        const Boveda* boveda;
+        QString id;
+        QString ubicacion;
+        ValuacionSaldos valuacion;
+    };
+
+    struct FilaBanco {
+        const Banco* banco;
+        QString codigo;
+        QString nombre;
+        ValuacionSaldos valuacion; // Totales del banco por tipo de activo
+        std::vector<FilaBoveda> bovedas;
+    };
+
+    SistemaBovedas& sistema;
+    std::vector<FilaBanco> filas;
+    std::unordered_map<const Boveda*, std::pair<std::size_t, std::size_t>> posiciones; // Bóveda -> (banco, fila)
+    std::shared_ptr<const TasasCambio> tasas; // Época con la que están calculados los valores
+
+    bool cambioLaEstructura() const;
+    void reconstruir();
+    void actualizarFilaBoveda(std::size_t filaBanco, std::size_t fila);
+    void actualizarFilaBanco(std::size_t filaBanco);
+    static QVariant textoColumna(int columna, const ValuacionSaldos& valuacion);
+};
+
+#endif // MODELO_BOVEDAS_H
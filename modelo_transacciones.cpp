@@ -0,0 +1,191 @@
+#include "modelo_transacciones.h"
+#include "exceptions.h"
+#include <QBrush>
+#include <QColor>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+QString aQString(std::string_view texto) {
+    return QString::fromUtf8(texto.data(), static_cast<int>(texto.size()));
+}
+
+bool estaTerminada(EstadoTransaccion estado) {
+    return estado == EstadoTransaccion::COMPLETADA || estado == EstadoTransaccion::CANCELADA;
+}
+
+} // namespace
+
+ModeloTransacciones::ModeloTransacciones(SistemaBovedas& sistema, std::size_t capacidad, QObject* parent)
+    : QAbstractTableModel(parent), sistema(sistema), capacidad(capacidad > 0 ? capacidad : 1), ultimaVista(0) {}
+
+void ModeloTransacciones::refrescar() {
+    if (sistema.getCantidadTransacciones() < ultimaVista) {
+        // Se cargó otro estado: lo mostrado ya no corresponde
+        beginResetModel();
+        filas.clear();
+        ultimaVista = 0;
+        endResetModel();
+    }
+
+    // Las terminadas ya no cambian; solo se vuelven a leer las que seguían en curso
+    for (std::size_t i = 0; i < filas.size(); ++i) {
+        actualizarFila(i);
+    }
+    agregarNuevas();
+}
+
+void ModeloTransacciones::aplicarCambios(const LoteCambios& lote) {
+    const auto& modificadas = lote.transaccionesModificadas;
+    if (!modificadas.empty()) {
+        for (std::size_t i = 0; i < filas.size(); ++i) {
+            if (std::binary_search(modificadas.begin(), modificadas.end(), filas[i].numero)) {
+                actualizarFila(i);
+            }
+        }
+    }
+    if (lote.ultimaCreada > ultimaVista) {
+        agregarNuevas();
+    }
+}
+
+void ModeloTransacciones::actualizarFila(std::size_t i) {
+    FilaTransaccion& fila = filas[i];
+    if (estaTerminada(fila.estado)) {
+        return;
+    }
+    EstadoTransaccion estado = estadoActual(fila);
+    if (estado != fila.estado) {
+        fila.estado = estado;
+        QModelIndex celda = index(static_cast<int>(i), COLUMNA_ESTADO);
+        emit dataChanged(celda, celda);
+    }
+}
+
+void ModeloTransacciones::agregarNuevas() {
+    std::size_t total = sistema.getCantidadTransacciones();
+    if (total <= ultimaVista) {
+        return;
+    }
+    std::size_t nuevas = std::min(total - ultimaVista, capacidad);
+    ultimaVista = total;
+
+    // getUltimasTransacciones las da de la más reciente a la más antigua
+    std::vector<Transaccion*> transacciones = sistema.getUltimasTransacciones(nuevas);
+    if (!transacciones.empty()) {
+        beginInsertRows(QModelIndex(), 0, static_cast<int>(transacciones.size()) - 1);
+        for (auto it = transacciones.rbegin(); it != transacciones.rend(); ++it) {
+            filas.push_front(filaDe(**it));
+        }
+        endInsertRows();
+    }
+
+    if (filas.size() > capacidad) {
+        beginRemoveRows(QModelIndex(), static_cast<int>(capacidad), static_cast<int>(filas.size()) - 1);
+        filas.resize(capacidad);
+        endRemoveRows();
+    }
+}
+
+QString ModeloTransacciones::getIdTransaccion(int fila) const {
+    if (fila < 0 || static_cast<std::size_t>(fila) >= filas.size()) {
+        return QString();
+    }
+    return QString::fromStdString(filas[fila].id);
+}
+
+ModeloTransacciones::FilaTransaccion ModeloTransacciones::filaDe(const Transaccion& transaccion) {
+    Activo activo = transaccion.getActivo();
+    std::string id(transaccion.getId());
+    std::size_t numero = 0;
+    SistemaBovedas::extraerNumeroTransaccion(id, numero);
+    return {numero,
+            id,
+            transaccion.getEstado(),
+            transaccion.getTipo(),
+            QString("%1 - %2").arg(aQString(transaccion.getBancoOrigenCodigo()),
+                                   aQString(transaccion.getBovedaOrigenId())),
+            QString("%1 - %2").arg(aQString(transaccion.getBancoDestinoCodigo()),
+                                   aQString(transaccion.getBovedaDestinoId())),
+            activo.getTipo(),
+            activo.getCantidad(),
+            aQString(transaccion.getTransportadora()),
+            transaccion.getPorcentajeComision(),
+            transaccion.getComision().aDouble()};
+}
+
+EstadoTransaccion ModeloTransacciones::estadoActual(const FilaTransaccion& fila) const {
+    try {
+        return sistema.buscarTransaccion(fila.id)->getEstado();
+    } catch (const OperacionInvalidaException&) {
+        // Terminó y pasó al archivo entre dos refrescos
+        return sistema.buscarTransaccionArchivada(fila.id)->getEstado();
+    }
+}
+
+int ModeloTransacciones::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(filas.size());
+}
+
+int ModeloTransacciones::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : NUM_COLUMNAS;
+}
+
+QVariant ModeloTransacciones::data(const QModelIndex& index, int role) const {
+    if (!index.isValid()) {
+        return QVariant();
+    }
+    const FilaTransaccion& fila = filas[index.row()];
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+            case COLUMNA_ID:
+                return QString::fromStdString(fila.id);
+            case COLUMNA_ESTADO:
+                return QString::fromStdString(Transaccion::estadoToString(fila.estado));
+            case COLUMNA_TIPO:
+                return QString::fromStdString(Transaccion::tipoToString(fila.tipo));
+            case COLUMNA_ORIGEN:
+                return fila.origen;
+            case COLUMNA_DESTINO:
+                return fila.destino;
+            case COLUMNA_ACTIVO:
+                return QString("%1 %2").arg(fila.cantidad, 0, 'f', 2)
+                                       .arg(QString::fromStdString(Activo::tipoActivoToString(fila.tipoActivo)));
+            case COLUMNA_TRANSPORTADORA:
+                return fila.transportadora;
+            case COLUMNA_COMISION:
+                return QString("%1% ($ %2)").arg(fila.porcentajeComision * 100, 0, 'f', 2)
+                                            .arg(fila.comision, 0, 'f', 2);
+            default:
+                return QVariant();
+        }
+    }
+    if (role == Qt::ForegroundRole && index.column() == COLUMNA_ESTADO) {
+        if (fila.estado == EstadoTransaccion::COMPLETADA) {
+            return QBrush(QColor("#28a745"));
+        }
+        if (fila.estado == EstadoTransaccion::CANCELADA) {
+            return QBrush(QColor("#dc3545"));
+        }
+    }
+    return QVariant();
+}
+
+QVariant ModeloTransacciones::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    switch (section) {
+        case COLUMNA_ID: return QString("ID");
+        case COLUMNA_ESTADO: return QString("Estado");
+        case COLUMNA_TIPO: return QString("Tipo");
+        case COLUMNA_ORIGEN: return QString("Origen");
+        case COLUMNA_DESTINO: return QString("Destino");
+        case COLUMNA_ACTIVO: return QString("Activo");
+        case COLUMNA_TRANSPORTADORA: return QString("Transportadora");
+        case COLUMNA_COMISION: return QString("Comisión");
+        default: return QVariant();
+    }
+}
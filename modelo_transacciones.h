@@ -0,0 +1,67 @@
+#ifndef MODELO_TRANSACCIONES_H
+#define MODELO_TRANSACCIONES_H
+
+#include <QAbstractTableModel>
+#include <deque>
+#include <string>
+#include "sistema_bovedas.h"
+
+// Últimas transacciones para el dashboard, la más reciente arriba. Guarda
+// copias de los datos (no punteros: archivarTerminadas los invalida) y en
+// cada refresco solo inserta las nuevas y vuelve a leer las que seguían en curso.
+class ModeloTransacciones : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Columna {
+        COLUMNA_ID,
+        COLUMNA_ESTADO,
+        COLUMNA_TIPO,
+        COLUMNA_ORIGEN,
+        COLUMNA_DESTINO,
+        COLUMNA_ACTIVO,
+        COLUMNA_TRANSPORTADORA,
+        COLUMNA_COMISION,
+        NUM_COLUMNAS
+    };
+
+    explicit ModeloTransacciones(SistemaBovedas& sistema, std::size_t capacidad = 200, QObject* parent = nullptr);
+
+    void refrescar();
+    // Solo las filas cuyo estado cambió según el lote, más las altas
+    void aplicarCambios(const LoteCambios& lote);
+    QString getIdTransaccion(int fila) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    struct FilaTransaccion {
+        std::size_t numero;
+        std::string id;
+        EstadoTransaccion estado;
+        TipoTransaccion tipo;
+        QString origen;
+        QString destino;
+        TipoActivo tipoActivo;
+        double cantidad;
+        QString transportadora;
+        double porcentajeComision;
+        double comision;
+    };
+
+    SistemaBovedas& sistema;
+    std::size_t capacidad;
+    std::size_t ultimaVista; // Cantidad de transacciones en el último refresco
+    std::deque<FilaTransaccion> filas;
+
+    void actualizarFila(std::size_t fila);
+    void agregarNuevas();
+    static FilaTransaccion filaDe(const Transaccion& transaccion);
+    EstadoTransaccion estadoActual(const FilaTransaccion& fila) const;
+};
+
+#endif // MODELO_TRANSACCIONES_H
@@ -0,0 +1,39 @@
+#include "monto.h"
+#include "resultado.h"
+#include <cmath>
+#include <cstdio>
+
+Resultado<Monto> Monto::intentarDesdeUnidades(double unidades) {
+    double escalado = std::round(unidades * ESCALA);
+    if (!std::isfinite(escalado) || std::fabs(escalado) > static_cast<double>(MAXIMO_UNIDADES * ESCALA)) {
+        return ErrorBoveda::conMensaje(CodigoError::DATOS_INVALIDOS, "Cantidad fuera de rango: " + std::to_string(unidades));
+    }
+    return Monto(static_cast<std::int64_t>(escalado));
+}
+
+Monto Monto::desdeUnidades(double unidades) {
+    return intentarDesdeUnidades(unidades).valor();
+}
+
+double Monto::aDouble() const {
+    return static_cast<double>(centesimas) / ESCALA;
+}
+
+std::string Monto::toString() const {
+    // Se formatea desde el entero para no perder exactitud
+    std::uint64_t absoluto = centesimas < 0 ? 0 - static_cast<std::uint64_t>(centesimas)
+                                            : static_cast<std::uint64_t>(centesimas);
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%s%llu.%02llu", centesimas < 0 ? "-" : "",
+                  static_cast<unsigned long long>(absoluto / ESCALA),
+                  static_cast<unsigned long long>(absoluto % ESCALA));
+    return buffer;
+}
+
+Monto Monto::aplicarPorcentaje(double porcentaje) const {
+    return Monto(static_cast<std::int64_t>(std::llround(static_cast<double>(centesimas) * porcentaje)));
+}
+
+Monto Monto::multiplicar(std::int64_t factor) const {
+    return Monto(centesimas * factor);
+}
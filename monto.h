@@ -0,0 +1,66 @@
+#ifndef MONTO_H
+#define MONTO_H
+
+#include <cstdint>
+#include <string>
+
+template <typename T>
+class Resultado; // resultado.h
+
+// Cantidad en punto fijo: un entero de 64 bits en centésimas de unidad
+// (céntimos para soles y dólares, centésimas de unidad para joyas).
+// Las sumas y restas son exactas, de modo que los saldos no acumulan
+// errores de redondeo y los totales se concilian bit a bit. Los operadores
+// no comprueban desbordes: una cantidad aceptada no pasa de MAXIMO_UNIDADES
+// (~1% del rango), así que sumar unas pocas no desborda, y los saldos que
+// acumulan muchas (Boveda, AcumuladorSaldos) comprueban cada suma.
+class Monto {
+private:
+    std::int64_t centesimas;
+    
+    constexpr explicit Monto(std::int64_t centesimas) : centesimas(centesimas) {}
+
+public:
+    static constexpr std::int64_t ESCALA = 100;
+    // Mayor cantidad (en valor absoluto) que acepta desdeUnidades
+    static constexpr std::int64_t MAXIMO_UNIDADES = 1000000000000000; // 10^15
+    
+    constexpr Monto() : centesimas(0) {}
+    
+    // Construcción
+    static constexpr Monto desdeCentesimas(std::int64_t centesimas) { return Monto(centesimas); }
+    // Redondea a la centésima más cercana; más allá de MAXIMO_UNIDADES (o NaN)
+    // es DATOS_INVALIDOS. desdeUnidades lanza lo mismo como excepción.
+    static Resultado<Monto> intentarDesdeUnidades(double unidades);
+    static Monto desdeUnidades(double unidades);
+    
+    // Conversión
+    constexpr std::int64_t getCentesimas() const { return centesimas; }
+    double aDouble() const;
+    std::string toString() const; // Siempre con dos decimales, p. ej. "1234.50"
+    
+    // Porcentaje redondeado a la centésima más cercana (p. ej. comisiones)
+    Monto aplicarPorcentaje(double porcentaje) const;
+    Monto multiplicar(std::int64_t factor) const;
+    
+    constexpr bool esCero() const { return centesimas == 0; }
+    constexpr bool esPositivo() const { return centesimas > 0; }
+    constexpr bool esNegativo() const { return centesimas < 0; }
+    
+    // Aritmética exacta
+    constexpr Monto operator+(Monto otro) const { return Monto(centesimas + otro.centesimas); }
+    constexpr Monto operator-(Monto otro) const { return Monto(centesimas - otro.centesimas); }
+    constexpr Monto operator-() const { return Monto(-centesimas); }
+    Monto& operator+=(Monto otro) { centesimas += otro.centesimas; return *this; }
+    Monto& operator-=(Monto otro) { centesimas -= otro.centesimas; return *this; }
+    
+    // Comparaciones
+    constexpr bool operator==(Monto otro) const { return centesimas == otro.centesimas; }
+    constexpr bool operator!=(Monto otro) const { return centesimas != otro.centesimas; }
+    constexpr bool operator<(Monto otro) const { return centesimas < otro.centesimas; }
+    constexpr bool operator<=(Monto otro) const { return centesimas <= otro.centesimas; }
+    constexpr bool operator>(Monto otro) const { return centesimas > otro.centesimas; }
+    constexpr bool operator>=(Monto otro) const { return centesimas >= otro.centesimas; }
+};
+
+#endif // MONTO_H
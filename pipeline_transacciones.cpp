@@ -0,0 +1,195 @@
+#include "pipeline_transacciones.h"
+#include "exceptions.h"
+
+PipelineTransacciones::PipelineTransacciones(SistemaBovedas& sistema, std::size_t hilosPorEtapa, std::size_t capacidadCola)
+    : sistema(sistema), hilosPorEtapa(hilosPorEtapa > 0 ? hilosPorEtapa : 1), iniciado(false) {
+    for (auto& cola : colas) {
+        cola = std::make_unique<ColaAcotada<std::string>>(capacidadCola);
+    }
+}
+
+PipelineTransacciones::~PipelineTransacciones() {
+    detener();
+}
+
+void PipelineTransacciones::setGancho(EtapaPipeline etapa, Gancho gancho) {
+    if (iniciado) {
+        throw OperacionInvalidaException("Los ganchos se configuran antes de iniciar el pipeline");
+    }
+    ganchos[static_cast<std::size_t>(etapa)] = std::move(gancho);
+}
+
+void PipelineTransacciones::setAvisoFin(AvisoFin aviso) {
+    if (iniciado) {
+        throw OperacionInvalidaException("El aviso de fin se configura antes de iniciar el pipeline");
+    }
+    avisoFin = std::move(aviso);
+}
+
+void PipelineTransacciones::iniciar() {
+    if (iniciado) {
+        return;
+    }
+    iniciado = true;
+    inicio = std::chrono::steady_clock::now();
+    hilos.reserve(NUM_ETAPAS_PIPELINE * hilosPorEtapa);
+    for (std::size_t etapa = 0; etapa < NUM_ETAPAS_PIPELINE; ++etapa) {
+        for (std::size_t i = 0; i < hilosPorEtapa; ++i) {
+            hilos.emplace_back(&PipelineTransacciones::trabajar, this, etapa);
+        }
+    }
+}
+
+void PipelineTransacciones::detener() {
+    if (!iniciado || hilos.empty()) {
+        return;
+    }
+    esperarVacio();
+    for (auto& cola : colas) {
+        cola->cerrar();
+    }
+    for (auto& hilo : hilos) {
+        hilo.join();
+    }
+    hilos.clear();
+}
+
+void PipelineTransacciones::enviar(const std::string& transaccionId) {
+    if (!iniciado || hilos.empty()) {
+        throw OperacionInvalidaException("El pipeline no está en ejecución");
+    }
+
+    EstadoTransaccion estado = sistema.buscarTransaccion(transaccionId)->getEstado();
+    if (estado == EstadoTransaccion::COMPLETADA || estado == EstadoTransaccion::CANCELADA) {
+        throw OperacionInvalidaException("La transacción " + transaccionId + " ya terminó");
+    }
+
+    {
+        std::lock_guard<std::mutex> bloqueo(mutexEnVuelo);
+        if (!enVuelo.insert(transaccionId).second) {
+            throw OperacionInvalidaException("La transacción " + transaccionId + " ya está en el pipeline");
+        }
+    }
+    // Las etapas siguen el orden de EstadoTransaccion
+    if (!colas[static_cast<std::size_t>(estado)]->agregar(transaccionId)) {
+        terminar(transaccionId, false, "El pipeline se detuvo");
+        throw OperacionInvalidaException("El pipeline se detuvo");
+    }
+}
+
+void PipelineTransacciones::esperarVacio() {
+    std::unique_lock<std::mutex> bloqueo(mutexEnVuelo);
+    sinPendientes.wait(bloqueo, [&] { return enVuelo.empty(); });
+}
+
+void PipelineTransacciones::trabajar(std::size_t etapa) {
+    std::string transaccionId;
+    while (colas[etapa]->extraer(transaccionId)) {
+        procesar(etapa, transaccionId);
+    }
+}
+
+void PipelineTransacciones::procesar(std::size_t etapa, const std::string& transaccionId) {
+    const EstadoTransaccion estadoEtapa = static_cast<EstadoTransaccion>(etapa);
+    bool fallo = false;
+    bool fueraDeEtapa = false; // Otro la avanzó, canceló o completó mientras estaba en la cola
+    std::string error;
+    try {
+        const Transaccion& transaccion = *sistema.buscarTransaccion(transaccionId);
+        if (transaccion.getEstado() != estadoEtapa) {
+            fallo = true;
+            fueraDeEtapa = true;
+            error = "La transacción " + transaccionId + " ya no está en la etapa " +
+                    etapaToString(static_cast<EtapaPipeline>(etapa));
+        } else {
+            if (ganchos[etapa]) {
+                ganchos[etapa](transaccion);
+            }
+            // Un saldo insuficiente es un rechazo habitual: se informa sin
+            // excepción. El estado se vuelve a comprobar bajo el bloqueo de la
+            // transacción, porque el gancho pudo tardar.
+            Resultado<void> avance = sistema.intentarAvanzarEtapaTransaccion(transaccionId, estadoEtapa);
+            if (!avance) {
+                fallo = true;
+                fueraDeEtapa = avance.getCodigo() == CodigoError::OPERACION_INVALIDA;
+                error = avance.getError().getMensaje();
+            }
+        }
+    } catch (const std::exception& e) {
+        // Los ganchos son código del usuario: cualquier excepción cancela la
+        // transacción; si escapara del hilo, enVuelo no bajaría nunca
+        fallo = true;
+        error = e.what();
+    } catch (...) {
+        fallo = true;
+    }
+
+    if (fallo) {
+        if (error.empty()) {
+            error = "Error desconocido en la etapa " + etapaToString(static_cast<EtapaPipeline>(etapa));
+        }
+        contadores[etapa].fallidas.fetch_add(1, std::memory_order_relaxed);
+        // Si ya no está en esta etapa no es del pipeline cancelarla
+        if (!fueraDeEtapa) {
+            try {
+                sistema.cancelarTransaccion(transaccionId, error);
+            } catch (const std::exception&) {
+                // Ya estaba cancelada o completada: no hay nada que devolver
+            }
+        }
+        terminar(transaccionId, false, error);
+        return;
+    }
+    contadores[etapa].procesadas.fetch_add(1, std::memory_order_relaxed);
+
+    if (etapa + 1 < NUM_ETAPAS_PIPELINE) {
+        // Contrapresión: si la siguiente etapa está llena, esta espera
+        if (colas[etapa + 1]->agregar(transaccionId)) {
+            return;
+        }
+        terminar(transaccionId, false, "El pipeline se detuvo");
+        return;
+    }
+    terminar(transaccionId, true, "");
+}
+
+void PipelineTransacciones::terminar(const std::string& transaccionId, bool exito, const std::string& error) {
+    if (avisoFin) {
+        try {
+            avisoFin(transaccionId, exito, error);
+        } catch (...) {
+            // Un aviso que falla no puede dejar la transacción en vuelo para siempre
+        }
+    }
+    std::lock_guard<std::mutex> bloqueo(mutexEnVuelo);
+    enVuelo.erase(transaccionId);
+    if (enVuelo.empty()) {
+        sinPendientes.notify_all();
+    }
+}
+
+std::vector<EstadisticasEtapa> PipelineTransacciones::getEstadisticas() const {
+    double segundos = iniciado ? std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count() : 0.0;
+    std::vector<EstadisticasEtapa> estadisticas;
+    estadisticas.reserve(NUM_ETAPAS_PIPELINE);
+    for (std::size_t etapa = 0; etapa < NUM_ETAPAS_PIPELINE; ++etapa) {
+        std::uint64_t procesadas = contadores[etapa].procesadas.load(std::memory_order_relaxed);
+        estadisticas.push_back({etapaToString(static_cast<EtapaPipeline>(etapa)),
+                                colas[etapa]->size(),
+                                colas[etapa]->getCapacidad(),
+                                procesadas,
+                                contadores[etapa].fallidas.load(std::memory_order_relaxed),
+                                segundos > 0 ? procesadas / segundos : 0.0});
+    }
+    return estadisticas;
+}
+
+std::string PipelineTransacciones::etapaToString(EtapaPipeline etapa) {
+    switch (etapa) {
+        case EtapaPipeline::PREPARACION: return "Preparación";
+        case EtapaPipeline::RECOJO: return "Recojo";
+        case EtapaPipeline::TRANSPORTE: return "Transporte";
+        case EtapaPipeline::ENTREGA: return "Entrega";
+        default: return "Desconocida";
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef PIPELINE_TRANSACCIONES_H
+#define PIPELINE_TRANSACCIONES_H
+
+#include "cola_acotada.h"
+#include "sistema_bovedas.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// Etapas del ciclo de vida; cada una atiende a las transacciones que están
+// en el EstadoTransaccion del mismo nombre y las deja en el siguiente
+enum class EtapaPipeline {
+    PREPARACION, // Retiro de la bóveda de origen
+    RECOJO,
+    TRANSPORTE,
+    ENTREGA      // Abono a la bóveda de destino
+};
+
+constexpr std::size_t NUM_ETAPAS_PIPELINE = 4;
+
+struct EstadisticasEtapa {
+    std::string nombre;
+    std::size_t enCola;
+    std::size_t capacidad;
+    std::uint64_t procesadas;
+    std::uint64_t fallidas;
+    double porSegundo; // Procesadas desde iniciar()
+};
+
+// Procesa transacciones de forma asíncrona: cada etapa tiene su propia cola
+// acotada y su grupo de hilos, así que miles de transacciones avanzan a la
+// vez y una etapa lenta (una firma de la transportadora, una verificación)
+// solo retiene a las transacciones que están en ella. Si una etapa o su
+// gancho fallan (con un error o con cualquier excepción), la transacción se
+// cancela (con devolución al origen si ya se retiró) y se reporta como
+// fallida. Una transacción que otro movió de estado mientras esperaba en una
+// cola se reporta como fallida sin cancelarla.
+class PipelineTransacciones {
+public:
+    // Gancho de etapa: se ejecuta antes de avanzar; si lanza lo que sea, la transacción se cancela
+    using Gancho = std::function<void(const Transaccion&)>;
+    // Aviso de fin: exito = false si se canceló por un error
+    using AvisoFin = std::function<void(const std::string& transaccionId, bool exito, const std::string& error)>;
+
+private:
+    struct alignas(64) ContadoresEtapa {
+        std::atomic<std::uint64_t> procesadas{0};
+        std::atomic<std::uint64_t> fallidas{0};
+    };
+
+    SistemaBovedas& sistema;
+    std::size_t hilosPorEtapa;
+    std::array<std::unique_ptr<ColaAcotada<std::string>>, NUM_ETAPAS_PIPELINE> colas;
+    std::array<Gancho, NUM_ETAPAS_PIPELINE> ganchos;
+    std::array<ContadoresEtapa, NUM_ETAPAS_PIPELINE> contadores;
+    AvisoFin avisoFin;
+    std::vector<std::thread> hilos;
+    std::chrono::steady_clock::time_point inicio;
+    bool iniciado;
+
+    // Transacciones aceptadas que todavía no terminaron
+    std::mutex mutexEnVuelo;
+    std::condition_variable sinPendientes;
+    std::unordered_set<std::string> enVuelo;
+
+    void trabajar(std::size_t etapa);
+    void procesar(std::size_t etapa, const std::string& transaccionId);
+    void terminar(const std::string& transaccionId, bool exito, const std::string& error);
+
+public:
+    PipelineTransacciones(SistemaBovedas& sistema, std::size_t hilosPorEtapa = 2, std::size_t capacidadCola = 1024);
+    ~PipelineTransacciones();
+
+    PipelineTransacciones(const PipelineTransacciones&) = delete;
+    PipelineTransacciones& operator=(const PipelineTransacciones&) = delete;
+
+    // Configuración; solo antes de iniciar()
+    void setGancho(EtapaPipeline etapa, Gancho gancho);
+    void setAvisoFin(AvisoFin aviso);
+
+    void iniciar();
+    // Espera a que terminen las transacciones aceptadas y detiene los hilos
+    void detener();
+
+    // Encola la transacción en la etapa que corresponde a su estado actual;
+    // bloquea si esa cola está llena. Lanza OperacionInvalidaException si ya
+    // está en el pipeline.
+    void enviar(const std::string& transaccionId);
+    // Espera a que todas las transacciones enviadas terminen
+    void esperarVacio();
+
+    std::vector<EstadisticasEtapa> getEstadisticas() const;
+    static std::string etapaToString(EtapaPipeline etapa);
+};
+
+#endif // PIPELINE_TRANSACCIONES_H
@@ -0,0 +1,58 @@
+#ifndef PRUEBA_H
+#define PRUEBA_H
+
+#include <cstdio>
+#include <exception>
+#include <string>
+
+// Lo mínimo para las pruebas del núcleo: cada verificación fallida se
+// informa con su ubicación y el programa termina con código distinto de
+// cero (así lo interpreta ctest). No se detiene en el primer fallo.
+inline int fallosPrueba = 0;
+
+inline void informarFallo(const char* archivo, int linea, const std::string& detalle) {
+    std::fprintf(stderr, "%s:%d: %s\n", archivo, linea, detalle.c_str());
+    ++fallosPrueba;
+}
+
+#define VERIFICAR(condicion)                                                   \
+    do {                                                                       \
+        if (!(condicion)) {                                                    \
+            informarFallo(__FILE__, __LINE__, "falló: " #condicion);           \
+        }                                                                      \
+    } while (0)
+
+#define VERIFICAR_LANZA(expresion, Excepcion)                                  \
+    do {                                                                       \
+        bool lanzo = false;                                                    \
+        try {                                                                  \
+            expresion;                                                         \
+        } catch (const Excepcion&) {                                           \
+            lanzo = true;                                                      \
+        }                                                                      \
+        if (!lanzo) {                                                          \
+            informarFallo(__FILE__, __LINE__, "no lanzó " #Excepcion ": " #expresion); \
+        }                                                                      \
+    } while (0)
+
+// Ejecuta una prueba; una excepción inesperada cuenta como fallo
+template <typename Prueba>
+void ejecutarPrueba(const char* nombre, Prueba prueba) {
+    int antes = fallosPrueba;
+    try {
+        prueba();
+    } catch (const std::exception& e) {
+        informarFallo(nombre, 0, std::string("excepción inesperada: ") + e.what());
+    }
+    std::printf("%s %s\n", fallosPrueba == antes ? "[ OK ]" : "[FALLO]", nombre);
+}
+
+inline int terminarPruebas() {
+    if (fallosPrueba > 0) {
+        std::printf("%d verificaciones fallidas\n", fallosPrueba);
+        return 1;
+    }
+    return 0;
+}
+
+#endif // PRUEBA_H
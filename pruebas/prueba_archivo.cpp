@@ -0,0 +1,77 @@
+// Pruebas del archivo de transacciones: las entradas del índice que dejó una
+// pasada sin sincronizar no se confunden con registros nuevos, y las cadenas
+// que no caben en el formato se rechazan en vez de recortarse.
+
+#include "prueba.h"
+#include "archivo_transacciones.h"
+#include "exceptions.h"
+#include <cstdio>
+#include <string>
+
+namespace {
+
+const char* const RUTA_ARCHIVO = "prueba_archivo.bin";
+
+TransaccionArchivada archivada(std::uint64_t numero) {
+    TransaccionArchivada transaccion;
+    transaccion.numero = numero;
+    transaccion.bancoOrigenCodigo = "BCP";
+    transaccion.bovedaOrigenId = "BCP-001";
+    transaccion.bancoDestinoCodigo = "BBVA";
+    transaccion.bovedaDestinoId = "BBVA-001";
+    transaccion.transportadora = "Transportes Seguros SA";
+    transaccion.centesimas = 100 * static_cast<std::int64_t>(numero);
+    return transaccion;
+}
+
+void borrarArchivo() {
+    std::remove(RUTA_ARCHIVO);
+    std::remove((std::string(RUTA_ARCHIVO) + ".idx").c_str());
+}
+
+void pruebaPasadaDescartada() {
+    borrarArchivo();
+    {
+        ArchivoTransacciones archivo(RUTA_ARCHIVO);
+        VERIFICAR(archivo.agregar(archivada(1)));
+        archivo.sincronizar();
+        // No se confirma: al reabrir se descartan los datos, pero no el índice
+        VERIFICAR(archivo.agregar(archivada(5)));
+    }
+    ArchivoTransacciones archivo(RUTA_ARCHIVO);
+    VERIFICAR(archivo.getCantidad() == 1);
+    VERIFICAR(!archivo.contiene(5));
+    // El 2 ocupa el lugar que tenía el 5
+    VERIFICAR(archivo.agregar(archivada(2)));
+    VERIFICAR(archivo.agregar(archivada(3)));
+    VERIFICAR(!archivo.contiene(5));
+    VERIFICAR(archivo.agregar(archivada(5)));
+
+    TransaccionArchivada leida;
+    VERIFICAR(archivo.leer(5, leida) && leida.centesimas == 500);
+    VERIFICAR(archivo.leer(2, leida) && leida.centesimas == 200);
+    borrarArchivo();
+}
+
+void pruebaCadenaDemasiadoLarga() {
+    borrarArchivo();
+    ArchivoTransacciones archivo(RUTA_ARCHIVO);
+    TransaccionArchivada larga = archivada(1);
+    larga.observaciones.assign(UINT16_MAX + 1, 'x');
+    VERIFICAR_LANZA(archivo.agregar(larga), DatosInvalidosException);
+    VERIFICAR(!archivo.contiene(1));
+
+    larga.observaciones.pop_back();
+    VERIFICAR(archivo.agregar(larga));
+    TransaccionArchivada leida;
+    VERIFICAR(archivo.leer(1, leida) && leida.observaciones == larga.observaciones);
+    borrarArchivo();
+}
+
+} // namespace
+
+int main() {
+    ejecutarPrueba("pasada descartada", pruebaPasadaDescartada);
+    ejecutarPrueba("cadena demasiado larga", pruebaCadenaDemasiadoLarga);
+    return terminarPruebas();
+}
@@ -0,0 +1,498 @@
+// Pruebas del diario: formato (ida y vuelta, final truncado o corrupto,
+// textos demasiado largos), recuperación de SistemaBovedas con el diario
+// cortado en cada frontera de registro, como si el proceso hubiera caído ahí,
+// rotación del diario al guardar una instantánea y error de escritura.
+
+#include "prueba.h"
+#include "diario.h"
+#include "exceptions.h"
+#include "sistema_bovedas.h"
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+namespace {
+
+const char* const RUTA = "prueba_diario.bin";
+const char* const RUTA_CORTADO = "prueba_diario_cortado.bin";
+const char* const RUTA_INSTANTANEA = "prueba_diario.snap";
+const std::size_t TAM_CABECERA = 16; // "BVDJ" + versión + LSN base
+
+std::vector<char> leerArchivo(const std::string& ruta) {
+    std::ifstream archivo(ruta, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(archivo)), std::istreambuf_iterator<char>());
+}
+
+void escribirArchivo(const std::string& ruta, const std::vector<char>& datos, std::size_t longitud) {
+    std::ofstream archivo(ruta, std::ios::binary | std::ios::trunc);
+    archivo.write(datos.data(), static_cast<std::streamsize>(longitud));
+}
+
+// Desplazamiento del final de cada registro completo del archivo
+std::vector<std::size_t> fronterasDeRegistros(const std::vector<char>& datos) {
+    std::vector<std::size_t> fronteras;
+    std::size_t posicion = TAM_CABECERA;
+    while (datos.size() - posicion >= 2 * sizeof(std::uint32_t)) {
+        std::uint32_t longitud = 0;
+        std::memcpy(&longitud, datos.data() + posicion, sizeof(longitud));
+        if (datos.size() - posicion - 2 * sizeof(std::uint32_t) < longitud) {
+            break;
+        }
+        posicion += 2 * sizeof(std::uint32_t) + longitud;
+        fronteras.push_back(posicion);
+    }
+    return fronteras;
+}
+
+std::vector<RegistroDiario> leerTodos(const std::string& ruta) {
+    std::vector<RegistroDiario> registros;
+    Diario::leer(ruta, [&](const RegistroDiario& registro) { registros.push_back(registro); });
+    return registros;
+}
+
+RegistroDiario iniciar(std::uint64_t numero) {
+    RegistroDiario registro;
+    registro.tipo = TipoRegistroDiario::INICIAR;
+    registro.numeroTransaccion = numero;
+    registro.bancoOrigenCodigo = "BCP";
+    registro.bovedaOrigenId = "BCP-001";
+    registro.bancoDestinoCodigo = "BBVA";
+    registro.bovedaDestinoId = "BBVA-002";
+    registro.transportadora = "Transportes Ñandú";
+    registro.porcentajeComision = 0.025;
+    registro.tasaADolares = 1.0;
+    registro.tipoActivo = TipoActivo::DOLARES;
+    registro.centesimas = 123456;
+    return registro;
+}
+
+RegistroDiario movimiento(std::int64_t centesimas) {
+    RegistroDiario registro;
+    registro.tipo = TipoRegistroDiario::MOVIMIENTO;
+    registro.codigoBanco = "SCOTIA";
+    registro.idBoveda = "SCOTIA-002";
+    registro.tipoActivo = TipoActivo::JOYAS;
+    registro.centesimas = centesimas;
+    registro.instante = 1700000000123456789;
+    return registro;
+}
+
+void verificarIniciar(const RegistroDiario& leido, const RegistroDiario& esperado) {
+    VERIFICAR(leido.tipo == TipoRegistroDiario::INICIAR);
+    VERIFICAR(leido.numeroTransaccion == esperado.numeroTransaccion);
+    VERIFICAR(leido.bancoOrigenCodigo == esperado.bancoOrigenCodigo);
+    VERIFICAR(leido.bovedaOrigenId == esperado.bovedaOrigenId);
+    VERIFICAR(leido.bancoDestinoCodigo == esperado.bancoDestinoCodigo);
+    VERIFICAR(leido.bovedaDestinoId == esperado.bovedaDestinoId);
+    VERIFICAR(leido.transportadora == esperado.transportadora);
+    VERIFICAR(leido.porcentajeComision == esperado.porcentajeComision);
+    VERIFICAR(leido.tasaADolares == esperado.tasaADolares);
+    VERIFICAR(leido.tipoActivo == esperado.tipoActivo);
+    VERIFICAR(leido.centesimas == esperado.centesimas);
+}
+
+void pruebaIdaYVuelta() {
+    std::remove(RUTA);
+    RegistroDiario avanzar;
+    avanzar.tipo = TipoRegistroDiario::AVANZAR;
+    avanzar.numeroTransaccion = 7;
+    avanzar.instante = 42;
+    RegistroDiario cancelar;
+    cancelar.tipo = TipoRegistroDiario::CANCELAR;
+    cancelar.numeroTransaccion = 8;
+    cancelar.razon = "Ruta bloqueada";
+    cancelar.instante = -5;
+    RegistroDiario forzar;
+    forzar.tipo = TipoRegistroDiario::FORZAR_AVANCE;
+    forzar.numeroTransaccion = 9;
+    RegistroDiario lote;
+    lote.tipo = TipoRegistroDiario::LOTE;
+    lote.lote = {iniciar(10), iniciar(11), iniciar(12)};
+    {
+        Diario diario(RUTA);
+        VERIFICAR(diario.agregar(iniciar(1)) == 1);
+        diario.agregar(avanzar);
+        diario.agregar(cancelar);
+        diario.agregar(movimiento(-250));
+        diario.agregar(forzar);
+        std::uint64_t lsn = diario.agregar(lote);
+        VERIFICAR(lsn == 6);
+        diario.esperarDurable(lsn);
+    }
+
+    std::vector<RegistroDiario> leidos = leerTodos(RUTA);
+    VERIFICAR(leidos.size() == 6);
+    if (leidos.size() != 6) {
+        return;
+    }
+    verificarIniciar(leidos[0], iniciar(1));
+    VERIFICAR(leidos[1].tipo == TipoRegistroDiario::AVANZAR);
+    VERIFICAR(leidos[1].numeroTransaccion == 7 && leidos[1].instante == 42);
+    VERIFICAR(leidos[2].tipo == TipoRegistroDiario::CANCELAR);
+    VERIFICAR(leidos[2].numeroTransaccion == 8 && leidos[2].instante == -5);
+    VERIFICAR(leidos[2].razon == "Ruta bloqueada");
+    VERIFICAR(leidos[3].tipo == TipoRegistroDiario::MOVIMIENTO);
+    VERIFICAR(leidos[3].codigoBanco == "SCOTIA" && leidos[3].idBoveda == "SCOTIA-002");
+    VERIFICAR(leidos[3].tipoActivo == TipoActivo::JOYAS);
+    VERIFICAR(leidos[3].centesimas == -250 && leidos[3].instante == 1700000000123456789);
+    VERIFICAR(leidos[4].tipo == TipoRegistroDiario::FORZAR_AVANCE && leidos[4].numeroTransaccion == 9);
+    VERIFICAR(leidos[5].tipo == TipoRegistroDiario::LOTE && leidos[5].lote.size() == 3);
+    for (std::size_t i = 0; i < leidos[5].lote.size() && i < 3; ++i) {
+        verificarIniciar(leidos[5].lote[i], iniciar(10 + i));
+    }
+
+    // Se puede seguir anexando después de leer
+    {
+        Diario diario(RUTA);
+        diario.esperarDurable(diario.agregar(movimiento(1)));
+    }
+    VERIFICAR(leerTodos(RUTA).size() == 7);
+}
+
+void pruebaFinalTruncado() {
+    std::remove(RUTA);
+    {
+        Diario diario(RUTA);
+        for (std::uint64_t i = 1; i <= 3; ++i) {
+            diario.agregar(iniciar(i));
+        }
+        diario.esperarDurable(3);
+    }
+    std::vector<char> datos = leerArchivo(RUTA);
+    std::vector<std::size_t> fronteras = fronterasDeRegistros(datos);
+    VERIFICAR(fronteras.size() == 3);
+
+    // Cualquier corte dentro del último registro lo descarta y deja el archivo en la frontera anterior
+    for (std::size_t corte = fronteras[1] + 1; corte < fronteras[2]; ++corte) {
+        escribirArchivo(RUTA_CORTADO, datos, corte);
+        VERIFICAR(leerTodos(RUTA_CORTADO).size() == 2);
+        VERIFICAR(leerArchivo(RUTA_CORTADO).size() == fronteras[1]);
+    }
+
+    // Un byte alterado en el segundo registro invalida su CRC: se conserva solo el primero
+    std::vector<char> alterados = datos;
+    alterados[fronteras[0] + 12] ^= 0x20;
+    escribirArchivo(RUTA_CORTADO, alterados, alterados.size());
+    VERIFICAR(leerTodos(RUTA_CORTADO).size() == 1);
+    VERIFICAR(leerArchivo(RUTA_CORTADO).size() == fronteras[0]);
+
+    // Otra versión del formato no se lee
+    std::vector<char> otraVersion = datos;
+    otraVersion[4] = 1;
+    escribirArchivo(RUTA_CORTADO, otraVersion, otraVersion.size());
+    VERIFICAR_LANZA(leerTodos(RUTA_CORTADO), ConfiguracionInvalidaException);
+    std::remove(RUTA_CORTADO);
+}
+
+void pruebaTextoDemasiadoLargo() {
+    std::remove(RUTA);
+    {
+        Diario diario(RUTA);
+        diario.agregar(iniciar(1));
+        RegistroDiario largo = iniciar(2);
+        largo.transportadora.assign(Diario::LONGITUD_MAXIMA_TEXTO + 1, 'x');
+        VERIFICAR_LANZA(diario.agregar(largo), DatosInvalidosException);
+        RegistroDiario loteLargo;
+        loteLargo.tipo = TipoRegistroDiario::LOTE;
+        loteLargo.lote = {iniciar(2), largo};
+        VERIFICAR_LANZA(diario.agregar(loteLargo), DatosInvalidosException);
+
+        // El límite exacto entra, y lo rechazado no dejó nada a medias
+        RegistroDiario justo = iniciar(2);
+        justo.transportadora.assign(Diario::LONGITUD_MAXIMA_TEXTO, 'y');
+        VERIFICAR(diario.agregar(justo) == 2);
+        diario.esperarDurable(diario.agregar(iniciar(3)));
+    }
+    std::vector<RegistroDiario> leidos = leerTodos(RUTA);
+    VERIFICAR(leidos.size() == 3);
+    if (leidos.size() == 3) {
+        VERIFICAR(leidos[1].transportadora.size() == Diario::LONGITUD_MAXIMA_TEXTO);
+        VERIFICAR(leidos[2].numeroTransaccion == 3);
+    }
+
+    // El sistema lo rechaza antes de tocar nada
+    std::remove(RUTA);
+    SistemaBovedas sistema;
+    sistema.crearBancosIniciales();
+    sistema.habilitarDiario(RUTA);
+    sistema.asignarActivosAleatorios(3);
+    std::string id = sistema.iniciarTransferencia("BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::SOLES, 10.0);
+    Resultado<std::string> rechazada = sistema.intentarIniciarTransferencia(
+        "BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::SOLES, 10.0,
+        std::string(Diario::LONGITUD_MAXIMA_TEXTO + 1, 't'));
+    VERIFICAR(!rechazada && rechazada.getCodigo() == CodigoError::DATOS_INVALIDOS);
+    VERIFICAR_LANZA(sistema.cancelarTransaccion(id, std::string(Diario::LONGITUD_MAXIMA_TEXTO + 1, 'r')),
+                    DatosInvalidosException);
+    VERIFICAR(sistema.buscarTransaccion(id)->getEstado() == EstadoTransaccion::PREPARACION);
+    VERIFICAR(sistema.getCantidadTransacciones() == 1);
+}
+
+// Operaciones que cubren todos los caminos con efectos en los saldos:
+// retiro, entrega, devolución y movimientos directos. avanzarEstadoTransaccion
+// mueve el estado sin tocar saldos, así que va en una prueba aparte.
+void escenario(SistemaBovedas& sistema) {
+    sistema.asignarActivosAleatorios(11);
+    std::string t1 = sistema.iniciarTransferencia("BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::SOLES, 100.0);
+    std::string t2 = sistema.iniciarTransferencia("BBVA", "BBVA-002", "SCOTIA", "SCOTIA-001", TipoActivo::DOLARES, 50.0);
+    std::vector<ResultadoTransferencia> lote = sistema.iniciarTransferenciasLote({
+        {"SCOTIA", "SCOTIA-001", "BCP", "BCP-002", TipoActivo::DOLARES, 30.0},
+        {"BCP", "BCP-003", "BBVA", "BBVA-003", TipoActivo::JOYAS, 2.0},
+        {"BCP", "BCP-001", "BCP", "BCP-002", TipoActivo::SOLES, 5.0},
+    });
+    sistema.avanzarEtapaTransaccion(t1);
+    sistema.procesarTransaccion(t2);
+    sistema.avanzarEtapaTransaccion(lote[0].transaccionId);
+    sistema.avanzarEtapaTransaccion(lote[0].transaccionId);
+    sistema.cancelarTransaccion(lote[0].transaccionId, "Ruta bloqueada");
+    sistema.cancelarTransaccion(lote[1].transaccionId, "Sin transporte");
+    sistema.procesarTransaccion(lote[2].transaccionId);
+    Boveda* boveda = sistema.buscarBanco("BCP")->buscarBoveda("BCP-001");
+    boveda->agregarActivo(Activo(TipoActivo::SOLES, 25.0));
+    boveda->retirarActivo(Activo(TipoActivo::SOLES, 10.0));
+    sistema.procesarTransaccion(t1);
+    sistema.procesarTransaccion(sistema.iniciarTransferencia("SCOTIA", "SCOTIA-002", "BCP", "BCP-003",
+                                                             TipoActivo::JOYAS, 1.0));
+}
+
+// Lo que entró con movimientos directos está en las bóvedas, en tránsito
+// (retirado del origen y sin entregar) o se cobró como comisión
+void verificarConservacion(SistemaBovedas& sistema, const SaldosBoveda& depositado) {
+    SaldosBoveda contado{};
+    for (const auto& [codigo, banco] : sistema.getBancos()) {
+        for (const auto& boveda : banco->getBovedas()) {
+            SaldosBoveda saldos = boveda->getCopiaActivos();
+            for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+                VERIFICAR(!saldos[i].esNegativo());
+                contado[i] += saldos[i];
+            }
+        }
+    }
+    for (Transaccion* transaccion : sistema.getTodasLasTransacciones()) {
+        std::size_t i = Activo::indice(transaccion->getActivo().getTipo());
+        switch (transaccion->getEstado()) {
+            case EstadoTransaccion::RECOJO:
+            case EstadoTransaccion::TRANSPORTE:
+            case EstadoTransaccion::ENTREGA:
+                contado[i] += transaccion->getActivo().getMonto();
+                break;
+            case EstadoTransaccion::COMPLETADA:
+                contado[i] += transaccion->getActivo().getMonto() - transaccion->getActivoNeto().getMonto();
+                break;
+            default:
+                break;
+        }
+    }
+    VERIFICAR(contado == depositado);
+    VERIFICAR(sistema.verificarTotales());
+}
+
+void pruebaRecuperacionEnCadaFrontera() {
+    std::remove(RUTA);
+    std::string estadoFinal;
+    {
+        SistemaBovedas sistema;
+        sistema.crearBancosIniciales();
+        sistema.habilitarDiario(RUTA, ModoDurabilidad::SINCRONO);
+        escenario(sistema);
+        estadoFinal = sistema.getEstadoBancos();
+    }
+    std::vector<char> datos = leerArchivo(RUTA);
+    std::vector<std::size_t> fronteras = fronterasDeRegistros(datos);
+    fronteras.insert(fronteras.begin(), TAM_CABECERA);
+    VERIFICAR(fronteras.back() == datos.size());
+
+    for (std::size_t k = 0; k < fronteras.size(); ++k) {
+        // Un corte en medio del registro siguiente se recupera igual que la frontera
+        std::size_t corte = k + 1 < fronteras.size() ? fronteras[k] + 5 : fronteras[k];
+        escribirArchivo(RUTA_CORTADO, datos, corte);
+
+        SaldosBoveda depositado{};
+        std::size_t registros = Diario::leer(RUTA_CORTADO, [&](const RegistroDiario& registro) {
+            if (registro.tipo == TipoRegistroDiario::MOVIMIENTO) {
+                depositado[Activo::indice(registro.tipoActivo)] += Monto::desdeCentesimas(registro.centesimas);
+            }
+        });
+        VERIFICAR(registros == k);
+
+        SistemaBovedas recuperado;
+        recuperado.crearBancosIniciales();
+        recuperado.habilitarDiario(RUTA_CORTADO, ModoDurabilidad::SINCRONO);
+        verificarConservacion(recuperado, depositado);
+
+        // Terminar lo que quedó en curso tampoco puede crear ni perder activos
+        for (Transaccion* transaccion : recuperado.getTransaccionesActivas()) {
+            Resultado<void> resultado = recuperado.intentarProcesarTransaccion(std::string(transaccion->getId()));
+            if (!resultado) {
+                recuperado.cancelarTransaccion(std::string(transaccion->getId()), "Sin fondos tras recuperar");
+            }
+        }
+        verificarConservacion(recuperado, depositado);
+    }
+
+    // El diario completo reproduce exactamente el estado final
+    SistemaBovedas recuperado;
+    recuperado.crearBancosIniciales();
+    recuperado.habilitarDiario(RUTA);
+    VERIFICAR(recuperado.getEstadoBancos() == estadoFinal);
+    std::remove(RUTA_CORTADO);
+    std::remove(RUTA);
+}
+
+void pruebaRecuperacionAvanceForzado() {
+    std::remove(RUTA);
+    std::string saldos;
+    {
+        SistemaBovedas sistema;
+        sistema.crearBancosIniciales();
+        sistema.habilitarDiario(RUTA);
+        sistema.asignarActivosAleatorios(5);
+        std::string id = sistema.iniciarTransferencia("BCP", "BCP-002", "SCOTIA", "SCOTIA-002", TipoActivo::SOLES, 8.0);
+        sistema.avanzarEstadoTransaccion(id);
+        sistema.avanzarEstadoTransaccion(id);
+        saldos = sistema.getEstadoBancos();
+    }
+    SistemaBovedas recuperado;
+    recuperado.crearBancosIniciales();
+    recuperado.habilitarDiario(RUTA);
+    VERIFICAR(recuperado.buscarTransaccion("TXN-000001")->getEstado() == EstadoTransaccion::TRANSPORTE);
+    VERIFICAR(recuperado.getEstadoBancos() == saldos);
+    std::remove(RUTA);
+}
+
+std::uint64_t baseDelSegmento(const std::string& ruta) {
+    std::vector<char> datos = leerArchivo(ruta);
+    std::uint64_t base = 0;
+    if (datos.size() >= TAM_CABECERA) {
+        std::memcpy(&base, datos.data() + TAM_CABECERA - sizeof(base), sizeof(base));
+    }
+    return base;
+}
+
+void pruebaRotacionConInstantanea() {
+    std::remove(RUTA);
+    std::remove(RUTA_INSTANTANEA);
+    std::vector<char> diarioAntesDeRotar;
+    std::string estadoInstantanea;
+    std::string estadoFinal;
+    std::uint64_t lsnInstantanea = 0;
+    {
+        SistemaBovedas sistema;
+        sistema.crearBancosIniciales();
+        sistema.habilitarDiario(RUTA);
+        escenario(sistema);
+        diarioAntesDeRotar = leerArchivo(RUTA);
+        estadoInstantanea = sistema.getEstadoBancos();
+        sistema.guardarInstantanea(RUTA_INSTANTANEA);
+
+        // El diario queda vacío y empieza donde termina la instantánea
+        lsnInstantanea = Instantanea(RUTA_INSTANTANEA).getRegistrosDiario();
+        VERIFICAR(lsnInstantanea == fronterasDeRegistros(diarioAntesDeRotar).size());
+        VERIFICAR(leerArchivo(RUTA).size() == TAM_CABECERA);
+        VERIFICAR(baseDelSegmento(RUTA) == lsnInstantanea);
+
+        std::string id = sistema.iniciarTransferencia("BCP", "BCP-002", "SCOTIA", "SCOTIA-002", TipoActivo::SOLES, 3.0);
+        sistema.procesarTransaccion(id);
+        estadoFinal = sistema.getEstadoBancos();
+    }
+    std::size_t registrosNuevos = fronterasDeRegistros(leerArchivo(RUTA)).size();
+    VERIFICAR(registrosNuevos > 0);
+    VERIFICAR(Diario::leer(RUTA, [](const RegistroDiario&) {}, lsnInstantanea) == lsnInstantanea + registrosNuevos);
+
+    // Instantánea + segmento nuevo reproducen el estado final
+    {
+        SistemaBovedas recuperado;
+        recuperado.cargarInstantanea(RUTA_INSTANTANEA);
+        recuperado.habilitarDiario(RUTA);
+        VERIFICAR(recuperado.getEstadoBancos() == estadoFinal);
+    }
+
+    // Sin la instantánea faltan los registros anteriores al segmento
+    {
+        SistemaBovedas sinInstantanea;
+        sinInstantanea.crearBancosIniciales();
+        VERIFICAR_LANZA(sinInstantanea.habilitarDiario(RUTA), ConfiguracionInvalidaException);
+    }
+
+    // Caída entre el rename de la instantánea y la rotación: el diario viejo
+    // se reaplica solo después de la instantánea, o sea nada
+    escribirArchivo(RUTA, diarioAntesDeRotar, diarioAntesDeRotar.size());
+    {
+        SistemaBovedas recuperado;
+        recuperado.cargarInstantanea(RUTA_INSTANTANEA);
+        recuperado.habilitarDiario(RUTA);
+        VERIFICAR(recuperado.getEstadoBancos() == estadoInstantanea);
+    }
+
+    // Diario que perdió su final (modo diferido): queda atrás de la
+    // instantánea, se rota al abrirlo y lo nuevo se numera después de ella
+    std::vector<std::size_t> fronteras = fronterasDeRegistros(diarioAntesDeRotar);
+    escribirArchivo(RUTA, diarioAntesDeRotar, fronteras[fronteras.size() / 2]);
+    {
+        SistemaBovedas recuperado;
+        recuperado.cargarInstantanea(RUTA_INSTANTANEA);
+        recuperado.habilitarDiario(RUTA);
+        VERIFICAR(recuperado.getEstadoBancos() == estadoInstantanea);
+        VERIFICAR(baseDelSegmento(RUTA) == lsnInstantanea);
+        std::string id = recuperado.iniciarTransferencia("BCP", "BCP-002", "SCOTIA", "SCOTIA-002", TipoActivo::SOLES, 3.0);
+        recuperado.procesarTransaccion(id);
+        VERIFICAR(recuperado.getEstadoBancos() == estadoFinal);
+    }
+    {
+        SistemaBovedas recuperado;
+        recuperado.cargarInstantanea(RUTA_INSTANTANEA);
+        recuperado.habilitarDiario(RUTA);
+        VERIFICAR(recuperado.getEstadoBancos() == estadoFinal);
+    }
+    std::remove(RUTA);
+    std::remove(RUTA_INSTANTANEA);
+}
+
+// Un límite de tamaño de archivo hace que el escritor falle a mitad de un
+// registro; después de eso ningún LSN posterior se da por durable
+void pruebaErrorDeEscritura() {
+    std::remove(RUTA);
+    std::signal(SIGXFSZ, SIG_IGN);
+    struct rlimit original;
+    VERIFICAR(::getrlimit(RLIMIT_FSIZE, &original) == 0);
+    {
+        Diario diario(RUTA);
+        std::uint64_t primero = diario.agregar(movimiento(100));
+        diario.esperarDurable(primero);
+        
+        struct rlimit limitado = original;
+        limitado.rlim_cur = leerArchivo(RUTA).size() + 10;
+        VERIFICAR(::setrlimit(RLIMIT_FSIZE, &limitado) == 0);
+        std::uint64_t fallido = diario.agregar(iniciar(2));
+        VERIFICAR_LANZA(diario.esperarDurable(fallido), ErrorInternoSistemaException);
+        VERIFICAR(::setrlimit(RLIMIT_FSIZE, &original) == 0);
+        
+        // Con el disco disponible otra vez el error sigue: nada nuevo entra
+        VERIFICAR_LANZA(diario.agregar(movimiento(300)), ErrorInternoSistemaException);
+        VERIFICAR_LANZA(diario.esperarDurable(fallido), ErrorInternoSistemaException);
+        diario.esperarDurable(primero);
+    }
+    
+    // La recuperación se detiene en el marco a medias: solo queda el primero
+    std::vector<RegistroDiario> registros = leerTodos(RUTA);
+    VERIFICAR(registros.size() == 1);
+    VERIFICAR(registros.front().centesimas == 100);
+    std::remove(RUTA);
+}
+
+} // namespace
+
+int main() {
+    ejecutarPrueba("ida y vuelta", pruebaIdaYVuelta);
+    ejecutarPrueba("final truncado o corrupto", pruebaFinalTruncado);
+    ejecutarPrueba("texto demasiado largo", pruebaTextoDemasiadoLargo);
+    ejecutarPrueba("recuperación en cada frontera", pruebaRecuperacionEnCadaFrontera);
+    ejecutarPrueba("recuperación de un avance forzado", pruebaRecuperacionAvanceForzado);
+    ejecutarPrueba("rotación con instantánea", pruebaRotacionConInstantanea);
+    ejecutarPrueba("error de escritura", pruebaErrorDeEscritura);
+    return terminarPruebas();
+}
@@ -0,0 +1,112 @@
+// Pruebas del historial de saldos: retención por bóveda y persistencia en la
+// instantánea (las consultas anteriores a la instantánea siguen funcionando
+// después de cargarla).
+
+#include "prueba.h"
+#include "exceptions.h"
+#include "historial_saldos.h"
+#include "sistema_bovedas.h"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace {
+
+const char* const RUTA_INSTANTANEA = "prueba_historial.snap";
+const char* const RUTA_DIARIO = "prueba_historial.bin";
+constexpr std::size_t INTERVALO = HistorialSaldos::INTERVALO_PUNTOS_CONTROL;
+
+void pruebaRetencion() {
+    VERIFICAR_LANZA(HistorialSaldos(INTERVALO - 1), DatosInvalidosException);
+
+    Boveda boveda("BCP-001", "Lima");
+    HistorialSaldos historial(2 * INTERVALO);
+    historial.iniciarBoveda(&boveda, SaldosBoveda{}, 0);
+    const std::int64_t total = 10 * INTERVALO;
+    for (std::int64_t i = 1; i <= total; ++i) {
+        historial.registrarMovimiento(&boveda, TipoActivo::SOLES, Monto::desdeCentesimas(1), i);
+        VERIFICAR(historial.getCantidadEventos(&boveda) <= 2 * INTERVALO);
+    }
+    VERIFICAR(historial.getCantidadEventos(&boveda) >= INTERVALO);
+
+    // Lo descartado ya no se puede consultar; lo que queda da lo mismo que antes
+    VERIFICAR_LANZA(historial.getSaldosEn(&boveda, 5), OperacionInvalidaException);
+    VERIFICAR(historial.getSaldosEn(&boveda, total)[0] == Monto::desdeCentesimas(total));
+    VERIFICAR(historial.getSaldosEn(&boveda, total - 7)[0] == Monto::desdeCentesimas(total - 7));
+
+    HistorialSaldos::SerieGuardada serie;
+    VERIFICAR(historial.exportarSerie(&boveda, serie));
+    VERIFICAR(serie.eventos.size() == historial.getCantidadEventos(&boveda));
+    VERIFICAR(serie.saldos[0] == Monto::desdeCentesimas(serie.inicio));
+
+    // Restaurada con menos retención se descarta lo que sobra y llega a lo mismo
+    Boveda copia("BCP-002", "Lima");
+    HistorialSaldos reducido(INTERVALO);
+    VERIFICAR(reducido.restaurarBoveda(&copia, serie)[0] == Monto::desdeCentesimas(total));
+    VERIFICAR(reducido.getCantidadEventos(&copia) <= INTERVALO);
+    VERIFICAR(reducido.getSaldosEn(&copia, total - 3)[0] == Monto::desdeCentesimas(total - 3));
+}
+
+std::chrono::system_clock::time_point marcar() {
+    // Separa los instantes de las operaciones de los de las consultas
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    auto instante = std::chrono::system_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    return instante;
+}
+
+void pruebaPersistenciaEnInstantanea() {
+    std::remove(RUTA_INSTANTANEA);
+    std::remove(RUTA_DIARIO);
+    std::chrono::system_clock::time_point antes;
+    std::chrono::system_clock::time_point durante;
+    std::chrono::system_clock::time_point despues;
+    SaldosBoveda saldosAntes;
+    SaldosBoveda saldosDurante;
+    SaldosBoveda saldosDespues;
+    {
+        SistemaBovedas sistema;
+        sistema.habilitarHistorial();
+        sistema.crearBancosIniciales();
+        sistema.habilitarDiario(RUTA_DIARIO);
+        sistema.asignarActivosAleatorios(7);
+        antes = marcar();
+        std::string id = sistema.iniciarTransferencia("BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::SOLES, 40.0);
+        sistema.avanzarEtapaTransaccion(id);
+        durante = marcar();
+        sistema.procesarTransaccion(id);
+        sistema.guardarInstantanea(RUTA_INSTANTANEA);
+        // Esto solo queda en el diario
+        sistema.buscarBanco("BCP")->buscarBoveda("BCP-001")->agregarActivo(Activo(TipoActivo::SOLES, 5.0));
+        despues = marcar();
+        saldosAntes = sistema.getSaldosBovedaEn("BCP", "BCP-001", antes);
+        saldosDurante = sistema.getSaldosBovedaEn("BCP", "BCP-001", durante);
+        saldosDespues = sistema.getSaldosBovedaEn("BCP", "BCP-001", despues);
+    }
+    VERIFICAR(saldosAntes != saldosDurante);
+
+    SistemaBovedas recuperado;
+    recuperado.habilitarHistorial();
+    recuperado.cargarInstantanea(RUTA_INSTANTANEA);
+    recuperado.habilitarDiario(RUTA_DIARIO);
+    VERIFICAR(recuperado.getSaldosBovedaEn("BCP", "BCP-001", antes) == saldosAntes);
+    VERIFICAR(recuperado.getSaldosBovedaEn("BCP", "BCP-001", durante) == saldosDurante);
+    VERIFICAR(recuperado.getSaldosBovedaEn("BCP", "BCP-001", despues) == saldosDespues);
+    VERIFICAR(recuperado.getSaldosBovedaEn("BCP", "BCP-001", despues) ==
+              recuperado.buscarBanco("BCP")->buscarBoveda("BCP-001")->getCopiaActivos());
+
+    // Sin historial habilitado la instantánea se carga igual
+    SistemaBovedas sinHistorial;
+    sinHistorial.cargarInstantanea(RUTA_INSTANTANEA);
+    VERIFICAR_LANZA(sinHistorial.getSaldosBovedaEn("BCP", "BCP-001", antes), OperacionInvalidaException);
+    std::remove(RUTA_INSTANTANEA);
+    std::remove(RUTA_DIARIO);
+}
+
+} // namespace
+
+int main() {
+    ejecutarPrueba("retención", pruebaRetencion);
+    ejecutarPrueba("persistencia en la instantánea", pruebaPersistenciaEnInstantanea);
+    return terminarPruebas();
+}
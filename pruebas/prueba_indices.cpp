@@ -0,0 +1,90 @@
+// Pruebas de los índices de transacciones en curso: varios hilos los
+// actualizan a la vez sin perder altas ni bajas, y las claves que se quedan
+// sin transacciones no dejan conjuntos vacíos atrás.
+
+#include "prueba.h"
+#include "indices_transacciones.h"
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t HILOS = 4;
+constexpr std::size_t POR_HILO = 500;
+
+ClaveIndice claveDe(std::size_t numero, std::string_view transportadora) {
+    HandleBoveda origen = static_cast<HandleBoveda>(numero % 7);
+    HandleBoveda destino = static_cast<HandleBoveda>(7 + numero % 5);
+    return {numero, origen, destino, origen % 2, 2 + destino % 2, transportadora};
+}
+
+void pruebaHilosConcurrentes() {
+    IndicesTransacciones indices;
+    std::vector<std::string> transportadoras;
+    for (std::size_t hilo = 0; hilo < HILOS; ++hilo) {
+        transportadoras.push_back("Transportadora " + std::to_string(hilo));
+    }
+
+    std::vector<std::thread> hilos;
+    for (std::size_t hilo = 0; hilo < HILOS; ++hilo) {
+        hilos.emplace_back([&, hilo] {
+            for (std::size_t i = 0; i < POR_HILO; ++i) {
+                std::size_t numero = 1 + hilo * POR_HILO + i;
+                ClaveIndice clave = claveDe(numero, transportadoras[hilo]);
+                indices.agregar(clave, EstadoTransaccion::PREPARACION);
+                indices.cambiarEstado(clave, EstadoTransaccion::PREPARACION, EstadoTransaccion::RECOJO);
+                // La mitad termina
+                if (numero % 2 == 0) {
+                    indices.cambiarEstado(clave, EstadoTransaccion::RECOJO, EstadoTransaccion::COMPLETADA);
+                }
+            }
+        });
+    }
+    for (auto& hilo : hilos) {
+        hilo.join();
+    }
+
+    const std::size_t total = HILOS * POR_HILO;
+    auto conteo = indices.getConteo();
+    VERIFICAR(conteo[static_cast<std::size_t>(EstadoTransaccion::PREPARACION)] == 0);
+    VERIFICAR(conteo[static_cast<std::size_t>(EstadoTransaccion::RECOJO)] == total / 2);
+    VERIFICAR(conteo[static_cast<std::size_t>(EstadoTransaccion::COMPLETADA)] == total / 2);
+
+    std::vector<std::size_t> enCurso = indices.getEnCurso();
+    std::sort(enCurso.begin(), enCurso.end());
+    VERIFICAR(enCurso.size() == total / 2);
+    VERIFICAR(std::all_of(enCurso.begin(), enCurso.end(), [](std::size_t numero) { return numero % 2 == 1; }));
+    VERIFICAR(indices.getEnEstado(EstadoTransaccion::RECOJO).size() == total / 2);
+    VERIFICAR(indices.getDeTransportadora(transportadoras[1]).size() == POR_HILO / 2);
+
+    std::size_t deBovedaCero = 0;
+    for (std::size_t numero = 1; numero <= total; numero += 2) {
+        deBovedaCero += numero % 7 == 0 ? 1 : 0;
+    }
+    VERIFICAR(indices.getDeBoveda(0).size() == deBovedaCero);
+}
+
+void pruebaClavesVacias() {
+    IndicesTransacciones indices;
+    ClaveIndice clave = claveDe(3, "Única");
+    indices.agregar(clave, EstadoTransaccion::PREPARACION);
+    VERIFICAR(indices.getDeTransportadora("Única").size() == 1);
+    indices.cambiarEstado(clave, EstadoTransaccion::PREPARACION, EstadoTransaccion::CANCELADA);
+    VERIFICAR(indices.getDeTransportadora("Única").empty());
+    VERIFICAR(indices.getDeBoveda(clave.origen).empty());
+    VERIFICAR(indices.getDeBanco(clave.bancoDestino).empty());
+    // Vuelve a indexarse sin problema después de borrar los conjuntos
+    indices.agregar(claveDe(64 + 3, "Única"), EstadoTransaccion::PREPARACION);
+    VERIFICAR(indices.getDeTransportadora("Única").size() == 1);
+}
+
+} // namespace
+
+int main() {
+    ejecutarPrueba("hilos concurrentes", pruebaHilosConcurrentes);
+    ejecutarPrueba("claves vacías", pruebaClavesVacias);
+    return terminarPruebas();
+}
@@ -0,0 +1,119 @@
+// Pruebas del pipeline: una excepción cualquiera en un gancho cancela la
+// transacción (con devolución) y no deja el pipeline esperando para siempre;
+// una transacción no entra dos veces ni se avanza si otro la movió de etapa.
+
+#include "prueba.h"
+#include "pipeline_transacciones.h"
+#include "exceptions.h"
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+void pruebaGanchoQueLanzaCualquierExcepcion() {
+    SistemaBovedas sistema;
+    sistema.crearBancosIniciales();
+    sistema.asignarActivosAleatorios(9);
+    std::string estadoInicial = sistema.getEstadoBancos();
+
+    std::mutex mutex;
+    std::vector<std::string> errores;
+    std::size_t exitosas = 0;
+    PipelineTransacciones pipeline(sistema, 1, 8);
+    pipeline.setGancho(EtapaPipeline::TRANSPORTE, [](const Transaccion& transaccion) {
+        if (transaccion.getId() == "TXN-000001") {
+            throw std::runtime_error("Camión averiado");
+        }
+        if (transaccion.getId() == "TXN-000002") {
+            throw 42;
+        }
+    });
+    pipeline.setAvisoFin([&](const std::string&, bool exito, const std::string& error) {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        if (exito) {
+            ++exitosas;
+        } else {
+            errores.push_back(error);
+        }
+    });
+    pipeline.iniciar();
+    for (int i = 0; i < 2; ++i) {
+        pipeline.enviar(sistema.iniciarTransferencia("BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::SOLES, 1.0));
+    }
+    pipeline.esperarVacio(); // Antes se quedaba esperando para siempre
+    pipeline.detener();
+
+    VERIFICAR(exitosas == 0);
+    VERIFICAR(errores.size() == 2);
+    VERIFICAR(sistema.buscarTransaccion("TXN-000001")->getEstado() == EstadoTransaccion::CANCELADA);
+    VERIFICAR(sistema.buscarTransaccion("TXN-000002")->getEstado() == EstadoTransaccion::CANCELADA);
+    // Lo retirado en PREPARACION se devolvió al cancelar
+    VERIFICAR(sistema.getEstadoBancos() == estadoInicial);
+    VERIFICAR(sistema.verificarTotales());
+    VERIFICAR(pipeline.getEstadisticas()[static_cast<std::size_t>(EtapaPipeline::TRANSPORTE)].fallidas == 2);
+}
+
+void pruebaTransaccionMovidaFueraDelPipeline() {
+    SistemaBovedas sistema;
+    sistema.crearBancosIniciales();
+    sistema.asignarActivosAleatorios(9);
+
+    std::promise<void> liberar;
+    std::shared_future<void> liberada = liberar.get_future().share();
+    std::mutex mutex;
+    std::vector<std::string> errores;
+    std::size_t exitosas = 0;
+    PipelineTransacciones pipeline(sistema, 1, 8);
+    pipeline.setGancho(EtapaPipeline::PREPARACION, [&](const Transaccion& transaccion) {
+        if (transaccion.getId() == "TXN-000001") {
+            liberada.wait(); // Retiene la etapa mientras se envían las demás
+        }
+        if (transaccion.getId() == "TXN-000003") {
+            sistema.avanzarEtapaTransaccion(std::string(transaccion.getId())); // Otro la avanza durante el gancho
+        }
+    });
+    pipeline.setAvisoFin([&](const std::string&, bool exito, const std::string& error) {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        if (exito) {
+            ++exitosas;
+        } else {
+            errores.push_back(error);
+        }
+    });
+    pipeline.iniciar();
+
+    std::string retenida = sistema.iniciarTransferencia("BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::SOLES, 1.0);
+    pipeline.enviar(retenida);
+    VERIFICAR_LANZA(pipeline.enviar(retenida), OperacionInvalidaException);
+
+    // Avanzada fuera del pipeline mientras espera en la cola de PREPARACION
+    std::string enCola = sistema.iniciarTransferencia("BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::SOLES, 1.0);
+    pipeline.enviar(enCola);
+    sistema.avanzarEtapaTransaccion(enCola);
+
+    std::string enGancho = sistema.iniciarTransferencia("BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::SOLES, 1.0);
+    pipeline.enviar(enGancho);
+    liberar.set_value();
+    pipeline.esperarVacio();
+    pipeline.detener();
+
+    VERIFICAR(exitosas == 1);
+    VERIFICAR(errores.size() == 2);
+    VERIFICAR(sistema.buscarTransaccion(retenida)->estaCompletada());
+    // Ni se avanzaron otra vez ni se cancelaron: siguen donde las dejó el otro
+    VERIFICAR(sistema.buscarTransaccion(enCola)->getEstado() == EstadoTransaccion::RECOJO);
+    VERIFICAR(sistema.buscarTransaccion(enGancho)->getEstado() == EstadoTransaccion::RECOJO);
+    VERIFICAR(sistema.verificarTotales());
+    VERIFICAR(pipeline.getEstadisticas()[static_cast<std::size_t>(EtapaPipeline::PREPARACION)].fallidas == 2);
+}
+
+} // namespace
+
+int main() {
+    ejecutarPrueba("gancho que lanza cualquier excepción", pruebaGanchoQueLanzaCualquierExcepcion);
+    ejecutarPrueba("transacción movida fuera del pipeline", pruebaTransaccionMovidaFueraDelPipeline);
+    return terminarPruebas();
+}
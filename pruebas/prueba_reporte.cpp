@@ -0,0 +1,120 @@
+// Pruebas del reporte de texto: lo que escribe EscritorReporte es idéntico,
+// byte por byte, al texto que se armaba antes con el getResumen de cada
+// banco y transacción.
+
+#include "prueba.h"
+#include "sistema_bovedas.h"
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* const RUTA_ARCHIVO = "prueba_reporte.archivo";
+
+void borrarArchivo() {
+    std::remove(RUTA_ARCHIVO);
+    std::remove((std::string(RUTA_ARCHIVO) + ".idx").c_str());
+}
+
+// Texto esperado, armado como lo hacía el sistema antes del escritor
+std::string resumenGeneralEsperado(const SistemaBovedas& sistema) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << "=== SISTEMA DE BÓVEDAS ===\n\n";
+    ss << "Bancos registrados: " << sistema.getBancos().size() << "\n";
+    ss << "Transacciones totales: " << sistema.getCantidadTransacciones() << "\n\n";
+    ss << "Valor total en el sistema: $ " << sistema.getTotales().getValorEnDolares() << "\n\n";
+    return ss.str();
+}
+
+std::string estadoBancosEsperado(const SistemaBovedas& sistema) {
+    std::stringstream ss;
+    for (const auto& [codigo, banco] : sistema.getBancos()) {
+        ss << banco->getResumen() << "\n";
+    }
+    return ss.str();
+}
+
+// 'retenidas': las transacciones que siguen en memoria, en orden de número
+std::string estadoTransaccionesEsperado(SistemaBovedas& sistema, const std::vector<std::string>& retenidas,
+                                        const std::size_t* archivadas) {
+    std::stringstream ss;
+    ss << "=== TRANSACCIONES ===\n\n";
+    if (archivadas) {
+        ss << "Transacciones archivadas: " << *archivadas << "\n\n";
+    }
+    for (const std::string& id : retenidas) {
+        ss << sistema.buscarTransaccion(id)->getResumen() << "\n";
+    }
+    if (sistema.getCantidadTransacciones() == 0) {
+        ss << "No hay transacciones registradas.\n";
+    }
+    return ss.str();
+}
+
+void verificarReporte(SistemaBovedas& sistema, const std::vector<std::string>& retenidas,
+                      const std::size_t* archivadas) {
+    VERIFICAR(sistema.getResumenGeneral() == resumenGeneralEsperado(sistema));
+    VERIFICAR(sistema.getEstadoBancos() == estadoBancosEsperado(sistema));
+    VERIFICAR(sistema.getEstadoTransacciones() == estadoTransaccionesEsperado(sistema, retenidas, archivadas));
+}
+
+void pruebaSistemaVacio() {
+    SistemaBovedas sistema;
+    verificarReporte(sistema, {}, nullptr);
+    sistema.crearBancosIniciales();
+    verificarReporte(sistema, {}, nullptr);
+}
+
+void pruebaConTransacciones() {
+    SistemaBovedas sistema;
+    sistema.crearBancosIniciales();
+    sistema.asignarActivosAleatorios(11);
+    sistema.buscarBanco("BCP")->buscarBoveda("BCP-001")->agregarActivo(Activo(TipoActivo::JOYAS, 3.0));
+
+    std::vector<std::string> ids;
+    ids.push_back(sistema.iniciarTransferencia("BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::SOLES, 12.34));
+    ids.push_back(sistema.iniciarTransferencia("BCP", "BCP-001", "BCP", "BCP-002", TipoActivo::JOYAS, 2.0,
+                                               "Transportes \"Rápidos\", SAC", 0.07));
+    ids.push_back(sistema.iniciarTransferencia("BBVA", "BBVA-001", "BCP", "BCP-001", TipoActivo::DOLARES, 0.5));
+    sistema.procesarTransaccion(ids[0]);
+    sistema.avanzarEtapaTransaccion(ids[1]);
+    sistema.cancelarTransaccion(ids[2], "Ruta bloqueada, se reprograma");
+    verificarReporte(sistema, ids, nullptr);
+}
+
+void pruebaConArchivo() {
+    borrarArchivo();
+    SistemaBovedas sistema;
+    sistema.crearBancosIniciales();
+    sistema.asignarActivosAleatorios(5);
+    sistema.habilitarArchivo(RUTA_ARCHIVO, 2);
+
+    // Con el archivo habilitado la línea aparece aunque no haya nada archivado
+    std::size_t archivadas = 0;
+    verificarReporte(sistema, {}, &archivadas);
+
+    std::vector<std::string> ids;
+    for (int i = 0; i < 4; ++i) {
+        ids.push_back(sistema.iniciarTransferencia("BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::SOLES, 1.0));
+        sistema.procesarTransaccion(ids.back());
+    }
+    verificarReporte(sistema, ids, &archivadas);
+
+    archivadas = sistema.archivarTerminadas();
+    VERIFICAR(archivadas == 2);
+    verificarReporte(sistema, {ids[2], ids[3]}, &archivadas);
+    borrarArchivo();
+}
+
+} // namespace
+
+int main() {
+    ejecutarPrueba("sistema vacío", pruebaSistemaVacio);
+    ejecutarPrueba("con transacciones", pruebaConTransacciones);
+    ejecutarPrueba("con archivo", pruebaConArchivo);
+    return terminarPruebas();
+}
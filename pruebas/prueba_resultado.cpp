@@ -0,0 +1,103 @@
+// Pruebas de Resultado y ErrorBoveda: el camino sin excepciones y el que
+// lanza rechazan lo mismo con el mismo mensaje, y los textos de error no
+// dependen de la vida de quien los armó. También el tope de las cantidades
+// y los saldos que se desbordarían.
+
+#include "prueba.h"
+#include "acumulador_saldos.h"
+#include "exceptions.h"
+#include "resultado.h"
+#include "sistema_bovedas.h"
+#include <limits>
+#include <string>
+
+namespace {
+
+void pruebaCantidadFueraDeRango() {
+    const double enorme = 1e300;
+    Resultado<Monto> monto = Monto::intentarDesdeUnidades(enorme);
+    VERIFICAR(!monto && monto.getCodigo() == CodigoError::DATOS_INVALIDOS);
+    const std::string esperado = "Cantidad fuera de rango: " + std::to_string(enorme);
+    VERIFICAR(monto.getError().getMensaje() == esperado);
+
+    std::string lanzado;
+    try {
+        Monto::desdeUnidades(enorme);
+    } catch (const DatosInvalidosException& e) {
+        lanzado = e.what();
+    }
+    VERIFICAR(lanzado.find(esperado) != std::string::npos);
+
+    VERIFICAR(!Monto::intentarDesdeUnidades(std::numeric_limits<double>::quiet_NaN()));
+    VERIFICAR(Monto::intentarDesdeUnidades(12.345).valor() == Monto::desdeCentesimas(1235));
+
+    Resultado<Activo> negativo = Activo::intentarCrear(TipoActivo::SOLES, -1.0);
+    VERIFICAR(!negativo && negativo.getCodigo() == CodigoError::DATOS_INVALIDOS);
+
+    // La operación del sistema informa el mismo mensaje que Monto
+    SistemaBovedas sistema;
+    sistema.crearBancosIniciales();
+    Resultado<std::string> transferencia = sistema.intentarIniciarTransferencia(
+        "BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::SOLES, enorme);
+    VERIFICAR(!transferencia && transferencia.getError().getMensaje() == esperado);
+}
+
+void pruebaTextosDeError() {
+    ErrorBoveda literal(CodigoError::OPERACION_INVALIDA, "Texto fijo");
+    VERIFICAR(literal.getMensaje() == "Texto fijo");
+
+    // Un const char* que no es un literal se copia como sujeto
+    ErrorBoveda copiado;
+    {
+        std::string temporal = "BCP-009";
+        const char* puntero = temporal.c_str();
+        copiado = ErrorBoveda(CodigoError::BOVEDA_NO_ENCONTRADA, puntero);
+        temporal.assign(temporal.size(), 'x');
+    }
+    VERIFICAR(copiado.getMensaje() == "Bóveda no encontrada: BCP-009");
+
+    ErrorBoveda armado = ErrorBoveda::conMensaje(CodigoError::DATOS_INVALIDOS, "Mensaje " + std::to_string(7));
+    VERIFICAR(armado.getMensaje() == "Mensaje 7");
+    VERIFICAR_LANZA(armado.lanzar(), DatosInvalidosException);
+}
+
+void pruebaSaldoQueSeDesbordaria() {
+    VERIFICAR(Monto::intentarDesdeUnidades(1e15).valor() == Monto::desdeCentesimas(Monto::MAXIMO_UNIDADES * 100));
+    VERIFICAR(!Monto::intentarDesdeUnidades(1e15 + 1));
+    VERIFICAR(!Monto::intentarDesdeUnidades(-1e15 - 1));
+
+    const Monto casiLleno = Monto::desdeCentesimas(std::numeric_limits<std::int64_t>::max() - 50);
+    const Activo cien(TipoActivo::SOLES, Monto::desdeCentesimas(100));
+
+    // La bóveda rechaza sin tocar su saldo ni el acumulador
+    AcumuladorSaldos acumulador;
+    Boveda llena("B-1", "Lima");
+    llena.setAcumulador(&acumulador);
+    llena.agregarActivo(Activo(TipoActivo::SOLES, casiLleno));
+    VERIFICAR_LANZA(llena.agregarActivo(cien), DatosInvalidosException);
+    VERIFICAR(llena.getSaldo(TipoActivo::SOLES) == casiLleno);
+    VERIFICAR(acumulador.getTotal(TipoActivo::SOLES) == casiLleno);
+
+    // El acumulador se desbordaría aunque cada bóveda quepa
+    Boveda otra("B-2", "Cusco");
+    otra.setAcumulador(&acumulador);
+    VERIFICAR_LANZA(otra.agregarActivo(Activo(TipoActivo::SOLES, casiLleno)), DatosInvalidosException);
+    VERIFICAR(otra.getSaldo(TipoActivo::SOLES).esCero());
+    VERIFICAR(acumulador.getTotal(TipoActivo::SOLES) == casiLleno);
+
+    // Una transferencia a una bóveda llena devuelve lo retirado al origen
+    Boveda origen("B-3", "Arequipa");
+    origen.agregarActivo(cien);
+    VERIFICAR_LANZA(Boveda::transferir(origen, llena, cien), DatosInvalidosException);
+    VERIFICAR(origen.getSaldo(TipoActivo::SOLES) == cien.getMonto());
+    VERIFICAR(llena.getSaldo(TipoActivo::SOLES) == casiLleno);
+}
+
+} // namespace
+
+int main() {
+    ejecutarPrueba("cantidad fuera de rango", pruebaCantidadFueraDeRango);
+    ejecutarPrueba("textos de error", pruebaTextosDeError);
+    ejecutarPrueba("saldo que se desbordaría", pruebaSaldoQueSeDesbordaria);
+    return terminarPruebas();
+}
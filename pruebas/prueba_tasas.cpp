@@ -0,0 +1,129 @@
+// Pruebas del proveedor de tasas: una versión tomada sigue valiendo después
+// de publicar otra, y se libera cuando nadie la usa. La valuación guardada
+// solo se recalcula si cambian los saldos o la época, y la comisión de las
+// joyas queda fija con la tasa del día en que se creó la transacción.
+
+#include "prueba.h"
+#include "exceptions.h"
+#include "banco.h"
+#include "sistema_bovedas.h"
+#include "tasas_cambio.h"
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+const char* const RUTA_DIARIO = "prueba_tasas.bin";
+const char* const RUTA_INSTANTANEA = "prueba_tasas.snap";
+const char* const RUTA_ARCHIVO = "prueba_tasas.archivo";
+
+void borrarArchivos() {
+    std::remove(RUTA_DIARIO);
+    std::remove(RUTA_INSTANTANEA);
+    std::remove(RUTA_ARCHIVO);
+    std::remove((std::string(RUTA_ARCHIVO) + ".idx").c_str());
+}
+
+void pruebaVersionesLiberadas() {
+    ProveedorTasas proveedor;
+    std::shared_ptr<const TasasCambio> primera = proveedor.getActuales();
+    VERIFICAR(primera->epoca == 1);
+
+    std::weak_ptr<const TasasCambio> intermedia;
+    for (int i = 0; i < 100; ++i) {
+        proveedor.actualizarTasa(TipoActivo::JOYAS, 60.0 + i);
+        if (i == 0) {
+            intermedia = proveedor.getActuales();
+        }
+    }
+    // La que se tomó antes no cambia; las que nadie tiene ya se liberaron
+    VERIFICAR(primera->getTasa(TipoActivo::JOYAS) == 50.0);
+    VERIFICAR(intermedia.expired());
+    VERIFICAR(proveedor.getEpoca() == 101);
+    VERIFICAR(proveedor.getActuales()->getTasa(TipoActivo::JOYAS) == 159.0);
+
+    std::weak_ptr<const TasasCambio> soltada = primera;
+    primera.reset();
+    VERIFICAR(soltada.expired());
+    VERIFICAR_LANZA(proveedor.actualizarTasa(TipoActivo::DOLARES, 2.0), DatosInvalidosException);
+}
+
+void pruebaValuacionPorEpoca() {
+    ProveedorTasas proveedor;
+    Banco banco("Banco de Prueba", "BDP");
+    banco.agregarBoveda(std::make_unique<Boveda>("BDP-001", "Lima"));
+    Boveda& boveda = *banco.buscarBoveda("BDP-001");
+    boveda.agregarActivo(Activo(TipoActivo::JOYAS, 2.0));
+
+    ValuacionSaldos deBoveda;
+    ValuacionSaldos deBanco;
+    std::shared_ptr<const TasasCambio> tasas = proveedor.getActuales();
+    VERIFICAR(boveda.valuar(deBoveda, *tasas) && banco.valuar(deBanco, *tasas));
+    VERIFICAR(deBoveda.getValor() == 100.0 && deBanco.getValor() == 100.0);
+    // Sin cambios no hay nada que avisar
+    VERIFICAR(!boveda.valuar(deBoveda, *tasas) && !banco.valuar(deBanco, *tasas));
+
+    boveda.agregarActivo(Activo(TipoActivo::DOLARES, 5.0));
+    VERIFICAR(boveda.valuar(deBoveda, *tasas) && deBoveda.getValor() == 105.0);
+
+    // Otra época se aplica a los saldos guardados, sin leer la bóveda
+    proveedor.actualizarTasa(TipoActivo::JOYAS, 10.0);
+    tasas = proveedor.getActuales();
+    boveda.agregarActivo(Activo(TipoActivo::DOLARES, 1.0));
+    VERIFICAR(deBoveda.revaluar(*tasas) && deBoveda.getValor() == 25.0);
+    VERIFICAR(deBoveda.getEpoca() == tasas->epoca);
+    VERIFICAR(!deBoveda.revaluar(*tasas));
+    VERIFICAR(boveda.valuar(deBoveda, *tasas) && deBoveda.getValor() == 26.0);
+}
+
+void pruebaComisionDeJoyasCongelada() {
+    borrarArchivos();
+    ProveedorTasas& global = ProveedorTasas::getGlobal();
+    const std::array<double, NUM_TIPOS_ACTIVO> referencia = global.getActuales()->aDolares;
+    // 2 unidades a 50 USD con el 5%
+    const Monto esperada = Monto::desdeUnidades(5.0);
+    std::string id;
+    {
+        SistemaBovedas sistema;
+        sistema.crearBancosIniciales();
+        sistema.habilitarDiario(RUTA_DIARIO);
+        sistema.buscarBanco("BCP")->buscarBoveda("BCP-001")->agregarActivo(Activo(TipoActivo::JOYAS, 10.0));
+        id = sistema.iniciarTransferencia("BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::JOYAS, 2.0);
+        std::array<double, NUM_TIPOS_ACTIVO> nuevas = referencia;
+        nuevas[Activo::indice(TipoActivo::JOYAS)] = 80.0;
+        sistema.actualizarTasas(nuevas);
+        VERIFICAR(sistema.buscarTransaccion(id)->getComision() == esperada);
+    }
+
+    // Reaplicada desde el diario con otras tasas vigentes
+    SistemaBovedas recuperado;
+    recuperado.crearBancosIniciales();
+    recuperado.habilitarDiario(RUTA_DIARIO);
+    VERIFICAR(recuperado.buscarTransaccion(id)->getTasaADolares() == 50.0);
+    VERIFICAR(recuperado.buscarTransaccion(id)->getComision() == esperada);
+
+    recuperado.guardarInstantanea(RUTA_INSTANTANEA);
+    {
+        SistemaBovedas cargado;
+        cargado.cargarInstantanea(RUTA_INSTANTANEA);
+        VERIFICAR(cargado.buscarTransaccion(id)->getComision() == esperada);
+    }
+
+    recuperado.habilitarArchivo(RUTA_ARCHIVO, 1);
+    recuperado.procesarTransaccion(id);
+    recuperado.iniciarTransferencia("BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::JOYAS, 1.0);
+    VERIFICAR(recuperado.archivarTerminadas() == 1);
+    VERIFICAR(recuperado.buscarTransaccionArchivada(id)->getComision() == esperada);
+
+    global.publicar(referencia);
+    borrarArchivos();
+}
+
+} // namespace
+
+int main() {
+    ejecutarPrueba("versiones liberadas", pruebaVersionesLiberadas);
+    ejecutarPrueba("valuación por época", pruebaValuacionPorEpoca);
+    ejecutarPrueba("comisión de joyas congelada", pruebaComisionDeJoyasCongelada);
+    return terminarPruebas();
+}
@@ -0,0 +1,48 @@
+// Pruebas de los datos de texto libre de una transacción: las observaciones
+// leídas no dependen de cancelaciones posteriores y las transportadoras no se
+// acumulan en la tabla de símbolos ni en los índices.
+
+#include "prueba.h"
+#include "sistema_bovedas.h"
+#include "tabla_simbolos.h"
+#include <string>
+
+namespace {
+
+void pruebaObservacionesLeidasAntesDeCancelar() {
+    Transaccion transaccion("TXN-000001", "BCP", "BCP-001", "BBVA", "BBVA-001", Activo(TipoActivo::SOLES, 10.0));
+    VERIFICAR(transaccion.getObservaciones().empty());
+    transaccion.restaurar(EstadoTransaccion::RECOJO, transaccion.getFechaCreacion(), {}, "Primera nota");
+    std::string leida = transaccion.getObservaciones();
+    transaccion.cancelar(std::string(200, 'x'));
+    VERIFICAR(leida == "Primera nota");
+    VERIFICAR(transaccion.getObservaciones() == std::string(200, 'x'));
+    VERIFICAR(transaccion.getResumen().find("Observaciones: xxx") != std::string::npos);
+}
+
+void pruebaTransportadorasLibres() {
+    SistemaBovedas sistema;
+    sistema.crearBancosIniciales();
+    sistema.asignarActivosAleatorios(3);
+    std::size_t simbolos = TablaSimbolos::global().size();
+
+    std::string id = sistema.iniciarTransferencia("BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::SOLES, 1.0,
+                                                  "Transportadora única 1");
+    sistema.iniciarTransferencia("BCP", "BCP-001", "BBVA", "BBVA-001", TipoActivo::SOLES, 1.0,
+                                 "Transportadora única 2");
+    VERIFICAR(TablaSimbolos::global().size() == simbolos);
+    VERIFICAR(sistema.getTransaccionesEnCursoDeTransportadora("Transportadora única 1").size() == 1);
+    VERIFICAR(sistema.getTransaccionesEnCursoDeTransportadora("Nunca usada").empty());
+
+    sistema.procesarTransaccion(id);
+    VERIFICAR(sistema.getTransaccionesEnCursoDeTransportadora("Transportadora única 1").empty());
+    VERIFICAR(sistema.getTransaccionesEnCursoDeTransportadora("Transportadora única 2").size() == 1);
+}
+
+} // namespace
+
+int main() {
+    ejecutarPrueba("observaciones leídas antes de cancelar", pruebaObservacionesLeidasAntesDeCancelar);
+    ejecutarPrueba("transportadoras libres", pruebaTransportadorasLibres);
+    return terminarPruebas();
+}
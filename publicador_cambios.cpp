@@ -0,0 +1,140 @@
+#include "publicador_cambios.h"
+#include <algorithm>
+
+PublicadorCambios::PublicadorCambios(std::chrono::milliseconds intervalo)
+    : intervalo(intervalo), ultimaCreada(0), epocaTasas(0), hayPendientes(false), siguienteId(1),
+      ultimaPublicada(0), epocaPublicada(0), secuencia(0), cerrando(false) {
+    hilo = std::thread(&PublicadorCambios::bucle, this);
+}
+
+PublicadorCambios::~PublicadorCambios() {
+    {
+        std::lock_guard<std::mutex> bloqueo(mutexHilo);
+        cerrando = true;
+    }
+    despertar.notify_one();
+    hilo.join();
+}
+
+std::size_t PublicadorCambios::suscribir(Suscriptor suscriptor) {
+    std::lock_guard<std::mutex> bloqueo(mutexEntrega);
+    std::size_t id = siguienteId++;
+    suscriptores.emplace(id, std::move(suscriptor));
+    return id;
+}
+
+void PublicadorCambios::desuscribir(std::size_t id) {
+    // Espera a que termine la entrega en curso, si la hay
+    std::lock_guard<std::mutex> bloqueo(mutexEntrega);
+    suscriptores.erase(id);
+}
+
+template <typename T>
+PublicadorCambios::Franja& PublicadorCambios::franjaDe(const T& clave) {
+    // Hash de Fibonacci: los punteros alineados y los números consecutivos
+    // se reparten igual entre las franjas
+    std::uint64_t h = static_cast<std::uint64_t>(std::hash<T>{}(clave)) * 0x9E3779B97F4A7C15ull;
+    return franjas[static_cast<std::size_t>(h >> 60) % NUM_FRANJAS];
+}
+
+void PublicadorCambios::saldoModificado(const Boveda* boveda) {
+    Franja& franja = franjaDe(boveda);
+    {
+        std::lock_guard<std::mutex> bloqueo(franja.mutex);
+        franja.bovedas.insert(boveda);
+    }
+    avisar();
+}
+
+void PublicadorCambios::estadoModificado(std::size_t numeroTransaccion) {
+    Franja& franja = franjaDe(numeroTransaccion);
+    {
+        std::lock_guard<std::mutex> bloqueo(franja.mutex);
+        franja.transacciones.insert(numeroTransaccion);
+    }
+    avisar();
+}
+
+void PublicadorCambios::transaccionCreada(std::size_t numeroTransaccion) {
+    ultimaCreada.store(numeroTransaccion, std::memory_order_release);
+    avisar();
+}
+
+void PublicadorCambios::tasasModificadas(std::uint64_t epoca) {
+    // Las épocas solo avanzan: si dos publicaciones se cruzan queda la mayor
+    std::uint64_t anterior = epocaTasas.load(std::memory_order_relaxed);
+    while (anterior < epoca && !epocaTasas.compare_exchange_weak(anterior, epoca, std::memory_order_relaxed)) {
+    }
+    avisar();
+}
+
+void PublicadorCambios::avisar() {
+    // Solo el primer cambio de cada lote despierta al hilo
+    if (hayPendientes.exchange(true)) {
+        return;
+    }
+    std::lock_guard<std::mutex> bloqueo(mutexHilo);
+    despertar.notify_one();
+}
+
+void PublicadorCambios::publicar() {
+    std::lock_guard<std::mutex> entrega(mutexEntrega);
+    // Se apaga antes de vaciar: lo que se marque desde aquí vuelve a avisar
+    hayPendientes.store(false);
+
+    LoteCambios lote;
+    for (Franja& franja : franjas) {
+        std::lock_guard<std::mutex> bloqueo(franja.mutex);
+        lote.bovedas.insert(lote.bovedas.end(), franja.bovedas.begin(), franja.bovedas.end());
+        lote.transaccionesModificadas.insert(lote.transaccionesModificadas.end(),
+                                             franja.transacciones.begin(), franja.transacciones.end());
+        franja.bovedas.clear();
+        franja.transacciones.clear();
+    }
+    std::sort(lote.transaccionesModificadas.begin(), lote.transaccionesModificadas.end());
+
+    std::size_t creada = ultimaCreada.load(std::memory_order_acquire);
+    if (creada > ultimaPublicada) {
+        lote.primeraCreada = ultimaPublicada + 1;
+        lote.ultimaCreada = creada;
+        ultimaPublicada = creada;
+    }
+    std::uint64_t epoca = epocaTasas.load(std::memory_order_relaxed);
+    if (epoca > epocaPublicada) {
+        lote.epocaTasas = epoca;
+        epocaPublicada = epoca;
+    }
+
+    if (lote.vacio()) {
+        return;
+    }
+    lote.secuencia = secuencia.fetch_add(1, std::memory_order_relaxed) + 1;
+    for (auto& [id, suscriptor] : suscriptores) {
+        suscriptor(lote);
+    }
+}
+
+std::uint64_t PublicadorCambios::getLotesPublicados() const {
+    return secuencia.load(std::memory_order_relaxed);
+}
+
+void PublicadorCambios::bucle() {
+    auto ultimoLote = std::chrono::steady_clock::now() - intervalo;
+    std::unique_lock<std::mutex> bloqueo(mutexHilo);
+    while (true) {
+        despertar.wait(bloqueo, [&] { return cerrando || hayPendientes.load(); });
+        if (cerrando) {
+            break;
+        }
+
+        // Lo que llegue hasta cumplir el intervalo viaja en este mismo lote
+        despertar.wait_until(bloqueo, ultimoLote + intervalo, [&] { return cerrando; });
+        if (cerrando) {
+            break;
+        }
+        bloqueo.unlock();
+        publicar();
+        ultimoLote = std::chrono::steady_clock::now();
+        bloqueo.lock();
+    }
+}
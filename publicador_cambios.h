@@ -0,0 +1,103 @@
+#ifndef PUBLICADOR_CAMBIOS_H
+#define PUBLICADOR_CAMBIOS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+class Boveda;
+
+// Cambios acumulados desde el lote anterior, agrupados por tipo. Una bóveda
+// o transacción aparece una sola vez aunque haya cambiado muchas veces: el
+// suscriptor vuelve a leer su estado actual.
+struct LoteCambios {
+    std::uint64_t secuencia = 0;
+    std::vector<const Boveda*> bovedas;              // Saldo modificado
+    std::vector<std::size_t> transaccionesModificadas; // Cambio de estado (números, en orden)
+    std::size_t primeraCreada = 0;                   // Creadas: números primeraCreada..ultimaCreada
+    std::size_t ultimaCreada = 0;                    // (0 si no hubo altas)
+    std::uint64_t epocaTasas = 0;                    // Nueva época de tasas de cambio (0 si no cambió)
+
+    bool vacio() const {
+        return bovedas.empty() && transaccionesModificadas.empty() && ultimaCreada == 0 && epocaTasas == 0;
+    }
+};
+
+// Publica los cambios del núcleo en lotes. Los productores (las operaciones
+// del sistema, con sus bloqueos tomados) solo marcan qué cambió: una
+// inserción en un conjunto repartido en franjas y, la primera vez en cada
+// lote, un aviso al hilo publicador. Ese hilo junta lo marcado como mucho una
+// vez por 'intervalo' y entrega el lote a cada suscriptor.
+//
+// Los suscriptores se invocan en el hilo publicador, de a uno y en orden de
+// secuencia; no deben llamar a suscribir/desuscribir desde el aviso.
+class PublicadorCambios {
+public:
+    using Suscriptor = std::function<void(const LoteCambios&)>;
+
+    explicit PublicadorCambios(std::chrono::milliseconds intervalo = std::chrono::milliseconds(50));
+    ~PublicadorCambios();
+
+    PublicadorCambios(const PublicadorCambios&) = delete;
+    PublicadorCambios& operator=(const PublicadorCambios&) = delete;
+
+    // Devuelve el identificador para desuscribir. Al volver desuscribir(), el
+    // suscriptor ya no se está ejecutando ni se volverá a invocar.
+    std::size_t suscribir(Suscriptor suscriptor);
+    void desuscribir(std::size_t id);
+
+    // Lado productor; pueden llamarse desde cualquier hilo
+    void saldoModificado(const Boveda* boveda);
+    void estadoModificado(std::size_t numeroTransaccion);
+    // Las altas llegan en orden de número (el sistema las serializa)
+    void transaccionCreada(std::size_t numeroTransaccion);
+    void tasasModificadas(std::uint64_t epoca);
+
+    // Publica ya lo pendiente, sin esperar al intervalo
+    void publicar();
+
+    std::chrono::milliseconds getIntervalo() const { return intervalo; }
+    std::uint64_t getLotesPublicados() const;
+
+private:
+    static constexpr std::size_t NUM_FRANJAS = 16;
+
+    struct alignas(64) Franja {
+        std::mutex mutex;
+        std::unordered_set<const Boveda*> bovedas;
+        std::unordered_set<std::size_t> transacciones;
+    };
+
+    std::chrono::milliseconds intervalo;
+    std::array<Franja, NUM_FRANJAS> franjas;
+    std::atomic<std::size_t> ultimaCreada;
+    std::atomic<std::uint64_t> epocaTasas;
+    std::atomic<bool> hayPendientes; // Se enciende con el primer cambio de cada lote
+
+    // Entrega: serializa publicar() entre el hilo y las llamadas directas
+    std::mutex mutexEntrega;
+    std::map<std::size_t, Suscriptor> suscriptores;
+    std::size_t siguienteId;
+    std::size_t ultimaPublicada; // Última alta ya entregada
+    std::uint64_t epocaPublicada;
+    std::atomic<std::uint64_t> secuencia;
+
+    std::mutex mutexHilo;
+    std::condition_variable despertar;
+    bool cerrando;
+    std::thread hilo;
+
+    void avisar();
+    void bucle();
+    template <typename T> Franja& franjaDe(const T& clave);
+};
+
+#endif // PUBLICADOR_CAMBIOS_H
@@ -0,0 +1,126 @@
+#include "registro_bovedas.h"
+#include "exceptions.h"
+
+HandleBanco RegistroBovedas::registrarBanco(Banco* banco) {
+    if (!banco) {
+        throw DatosInvalidosException("No se puede registrar un banco nulo");
+    }
+    
+    std::unique_lock<std::shared_mutex> bloqueo(mutex);
+    auto [it, insertado] = indiceBancos.emplace(banco->getCodigo(), static_cast<HandleBanco>(bancos.size()));
+    if (!insertado) {
+        throw OperacionInvalidaException("Ya existe un banco registrado con código: " + banco->getCodigo());
+    }
+    
+    HandleBanco handle = it->second;
+    bancos.push_back(banco);
+    indiceBovedas.emplace_back();
+    
+    for (const auto& boveda : banco->getBovedas()) {
+        registrarBovedaSinBloqueo(handle, boveda.get());
+    }
+    return handle;
+}
+
+HandleBoveda RegistroBovedas::registrarBoveda(HandleBanco handleBanco, Boveda* boveda) {
+    std::unique_lock<std::shared_mutex> bloqueo(mutex);
+    return registrarBovedaSinBloqueo(handleBanco, boveda);
+}
+
+HandleBoveda RegistroBovedas::registrarBovedaSinBloqueo(HandleBanco handleBanco, Boveda* boveda) {
+    if (!boveda) {
+        throw DatosInvalidosException("No se puede registrar una bóveda nula");
+    }
+    if (handleBanco >= bancos.size()) {
+        throw EntidadBancariaNoEncontradaException("Handle de banco inválido: " + std::to_string(handleBanco));
+    }
+    
+    auto [it, insertado] = indiceBovedas[handleBanco].emplace(boveda->getId(), static_cast<HandleBoveda>(bovedas.size()));
+    if (!insertado) {
+        return it->second;
+    }
+    
+    bovedas.push_back(boveda);
+    bancoDeBoveda.push_back(handleBanco);
+    return it->second;
+}
+
+HandleBanco RegistroBovedas::resolverBanco(const std::string& codigo) const {
+    return intentarResolverBanco(codigo).valor();
+}
+
+HandleBoveda RegistroBovedas::resolverBoveda(HandleBanco handleBanco, const std::string& idBoveda) {
+    return intentarResolverBoveda(handleBanco, idBoveda).valor();
+}
+
+Resultado<HandleBanco> RegistroBovedas::intentarResolverBanco(const std::string& codigo) const {
+    std::shared_lock<std::shared_mutex> bloqueo(mutex);
+    auto it = indiceBancos.find(codigo);
+    if (it == indiceBancos.end()) {
+        return ErrorBoveda(CodigoError::BANCO_NO_ENCONTRADO, codigo);
+    }
+    return it->second;
+}
+
+Resultado<HandleBoveda> RegistroBovedas::intentarResolverBoveda(HandleBanco handleBanco, const std::string& idBoveda) {
+    Banco* banco = nullptr;
+    {
+        std::shared_lock<std::shared_mutex> bloqueo(mutex);
+        if (handleBanco >= bancos.size()) {
+            throw EntidadBancariaNoEncontradaException("Handle de banco inválido: " + std::to_string(handleBanco));
+        }
+        
+        const auto& indice = indiceBovedas[handleBanco];
+        auto it = indice.find(idBoveda);
+        if (it != indice.end()) {
+            return it->second;
+        }
+        banco = bancos[handleBanco];
+    }
+    
+    // La bóveda pudo agregarse al banco después de registrarlo: se busca en
+    // el banco y queda registrada para las siguientes consultas
+    Resultado<Boveda*> boveda = banco->intentarBuscarBoveda(idBoveda);
+    if (!boveda) {
+        return boveda.getError();
+    }
+    return registrarBoveda(handleBanco, boveda.valor());
+}
+
+HandleBoveda RegistroBovedas::resolverBoveda(const std::string& codigoBanco, const std::string& idBoveda) {
+    return resolverBoveda(resolverBanco(codigoBanco), idBoveda);
+}
+
+Banco* RegistroBovedas::getBanco(HandleBanco handle) const {
+    std::shared_lock<std::shared_mutex> bloqueo(mutex);
+    if (handle >= bancos.size()) {
+        throw EntidadBancariaNoEncontradaException("Handle de banco inválido: " + std::to_string(handle));
+    }
+    return bancos[handle];
+}
+
+Boveda* RegistroBovedas::getBoveda(HandleBoveda handle) const {
+    std::shared_lock<std::shared_mutex> bloqueo(mutex);
+    if (handle >= bovedas.size()) {
+        throw BovedaNoEncontradaException("Handle de bóveda inválido: " + std::to_string(handle));
+    }
+    return bovedas[handle];
+}
+
+HandleBanco RegistroBovedas::getBancoDeBoveda(HandleBoveda handle) const {
+    std::shared_lock<std::shared_mutex> bloqueo(mutex);
+    if (handle >= bancoDeBoveda.size()) {
+        throw BovedaNoEncontradaException("Handle de bóveda inválido: " + std::to_string(handle));
+    }
+    return bancoDeBoveda[handle];
+}
+
+std::size_t RegistroBovedas::getCantidadBancos() const {
+    std::shared_lock<std::shared_mutex> bloqueo(mutex);
+    return bancos.size();
+}
+
+std::size_t RegistroBovedas::getCantidadBovedas() const {
+    std::shared_lock<std::shared_mutex> bloqueo(mutex);
+    return bovedas.size();
+}
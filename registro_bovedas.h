@@ -0,0 +1,48 @@
+#ifndef REGISTRO_BOVEDAS_H
+#define REGISTRO_BOVEDAS_H
+
+#include "banco.h"
+#include "handles.h"
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Registro global que traduce códigos de banco e IDs de bóveda a handles.
+// Cada extremo de una transferencia se resuelve una sola vez y a partir de
+// ahí se trabaja con el handle, sin volver a comparar cadenas.
+// Las consultas pueden hacerse desde varios hilos; el registro perezoso de
+// bóvedas nuevas toma el bloqueo exclusivo.
+class RegistroBovedas {
+private:
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, HandleBanco> indiceBancos;
+    std::vector<Banco*> bancos;
+    std::vector<std::unordered_map<std::string, HandleBoveda>> indiceBovedas; // Uno por banco
+    std::vector<Boveda*> bovedas;
+    std::vector<HandleBanco> bancoDeBoveda;
+    
+    HandleBoveda registrarBovedaSinBloqueo(HandleBanco handleBanco, Boveda* boveda);
+
+public:
+    // Registra el banco junto con todas las bóvedas que tenga en ese momento
+    HandleBanco registrarBanco(Banco* banco);
+    HandleBoveda registrarBoveda(HandleBanco handleBanco, Boveda* boveda);
+    
+    // Resolución de identificadores (lanzan si no existen)
+    HandleBanco resolverBanco(const std::string& codigo) const;
+    HandleBoveda resolverBoveda(HandleBanco handleBanco, const std::string& idBoveda);
+    HandleBoveda resolverBoveda(const std::string& codigoBanco, const std::string& idBoveda);
+    // Igual que las anteriores pero sin lanzar si el banco o la bóveda no existen
+    Resultado<HandleBanco> intentarResolverBanco(const std::string& codigo) const;
+    Resultado<HandleBoveda> intentarResolverBoveda(HandleBanco handleBanco, const std::string& idBoveda);
+    
+    // Acceso por handle
+    Banco* getBanco(HandleBanco handle) const;
+    Boveda* getBoveda(HandleBoveda handle) const;
+    HandleBanco getBancoDeBoveda(HandleBoveda handle) const;
+    std::size_t getCantidadBancos() const;
+    std::size_t getCantidadBovedas() const;
+};
+
+#endif // REGISTRO_BOVEDAS_H
@@ -0,0 +1,529 @@
+#include "reporte.h"
+#include "banco.h"
+#include "exceptions.h"
+#include "tasas_cambio.h"
+#include "transaccion.h"
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Nombres de columna de cada tipo de activo, en el orden de TipoActivo
+const std::string_view COLUMNAS_ACTIVO[NUM_TIPOS_ACTIVO] = {"soles", "dolares", "joyas"};
+
+const char* const ENCABEZADO_RESUMEN_CSV = "bancos,transacciones,valor_usd\n";
+const char* const ENCABEZADO_BANCOS_CSV = "registro,banco,boveda,nombre,soles,dolares,joyas,valor_usd\n";
+const char* const ENCABEZADO_TRANSACCIONES_CSV =
+    "id,tipo,estado,banco_origen,boveda_origen,banco_destino,boveda_destino,"
+    "activo,cantidad,transportadora,comision_pct,comision,observaciones\n";
+
+} // namespace
+
+SalidaDescriptor::SalidaDescriptor(int descriptor) : descriptor(descriptor) {}
+
+void SalidaDescriptor::escribir(const char* datos, std::size_t longitud) {
+    while (longitud > 0) {
+#ifdef _WIN32
+        int escritos = ::_write(descriptor, datos, static_cast<unsigned int>(longitud));
+#else
+        ssize_t escritos = ::write(descriptor, datos, longitud);
+#endif
+        if (escritos < 0) {
+            if (errno == EINTR) continue;
+            throw ErrorInternoSistemaException(std::string("Error al escribir el reporte: ") + std::strerror(errno));
+        }
+        datos += escritos;
+        longitud -= static_cast<std::size_t>(escritos);
+    }
+}
+
+SalidaCadena::SalidaCadena(std::string& destino) : destino(destino) {}
+
+void SalidaCadena::escribir(const char* datos, std::size_t longitud) {
+    destino.append(datos, longitud);
+}
+
+EscritorReporte::EscritorReporte(SalidaReporte& salida, FormatoReporte formato)
+    : salida(salida), formato(formato), tasas(ProveedorTasas::getGlobal().getActuales()), bufer(CAPACIDAD),
+      usados(0), seccion(Seccion::NINGUNA), secciones(0), primerRegistro(true), conTotales(false),
+      totalTransacciones(0), transaccionesArchivadas(0), terminado(false) {}
+
+void EscritorReporte::resumen(std::size_t bancos, std::size_t transacciones, const SaldosBoveda& totales) {
+    abrirSeccion(Seccion::RESUMEN);
+    double valorTotal = tasas->valuar(totales);
+    switch (formato) {
+        case FormatoReporte::TEXTO:
+            anexar("=== SISTEMA DE BÓVEDAS ===\n\n");
+            anexar("Bancos registrados: ");
+            anexarEntero(bancos);
+            anexar("\nTransacciones totales: ");
+            anexarEntero(transacciones);
+            anexar("\n\nValor total en el sistema: $ ");
+            anexarDecimal(valorTotal);
+            anexar("\n\n");
+            break;
+        case FormatoReporte::CSV:
+            anexarEntero(bancos);
+            anexar(',');
+            anexarEntero(transacciones);
+            anexar(',');
+            anexarDecimal(valorTotal);
+            anexar('\n');
+            break;
+        case FormatoReporte::JSON:
+            anexarClave("bancos");
+            anexarEntero(bancos);
+            anexar(',');
+            anexarClave("transacciones");
+            anexarEntero(transacciones);
+            anexar(',');
+            anexarClave("valor_usd");
+            anexarDecimal(valorTotal);
+            break;
+    }
+}
+
+void EscritorReporte::banco(const Banco& banco) {
+    abrirSeccion(Seccion::BANCOS);
+    separarRegistro();
+
+    SaldosBoveda totales;
+    for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+        totales[i] = banco.getTotalPorTipo(static_cast<TipoActivo>(i));
+    }
+    const auto& bovedas = banco.getBovedas();
+
+    switch (formato) {
+        case FormatoReporte::TEXTO:
+            anexar("=== ");
+            anexar(banco.getNombre());
+            anexar(" (");
+            anexar(banco.getCodigo());
+            anexar(") ===\nActivos totales: $ ");
+            anexarDecimal(tasas->valuar(totales));
+            anexar("\nNúmero de bóvedas: ");
+            anexarEntero(bovedas.size());
+            anexar("\n\n");
+            for (const auto& boveda : bovedas) {
+                SaldosBoveda saldos = boveda->getCopiaActivos();
+                anexar("Bóveda: ");
+                anexar(boveda->getId());
+                anexar(" (");
+                anexar(boveda->getUbicacion());
+                anexar(")\n  Soles: S/ ");
+                anexarMonto(saldos[Activo::indice(TipoActivo::SOLES)]);
+                anexar("\n  Dólares: $ ");
+                anexarMonto(saldos[Activo::indice(TipoActivo::DOLARES)]);
+                anexar("\n  Joyas: ");
+                anexarMonto(saldos[Activo::indice(TipoActivo::JOYAS)]);
+                anexar(" unidades\n  Valor total: $ ");
+                anexarDecimal(tasas->valuar(saldos));
+                anexar("\n\n");
+            }
+            anexar('\n');
+            break;
+        case FormatoReporte::CSV: {
+            std::string codigo = banco.getCodigo();
+            anexar("banco,");
+            anexarCampo(codigo);
+            anexar(",,");
+            anexarCampo(banco.getNombre());
+            for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+                anexar(',');
+                anexarMonto(totales[i]);
+            }
+            anexar(',');
+            anexarDecimal(tasas->valuar(totales));
+            anexar('\n');
+            for (const auto& boveda : bovedas) {
+                SaldosBoveda saldos = boveda->getCopiaActivos();
+                anexar("boveda,");
+                anexarCampo(codigo);
+                anexar(',');
+                anexarCampo(boveda->getId());
+                anexar(',');
+                anexarCampo(boveda->getUbicacion());
+                for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+                    anexar(',');
+                    anexarMonto(saldos[i]);
+                }
+                anexar(',');
+                anexarDecimal(tasas->valuar(saldos));
+                anexar('\n');
+            }
+            break;
+        }
+        case FormatoReporte::JSON:
+            anexar('{');
+            anexarClave("codigo");
+            anexarCampo(banco.getCodigo());
+            anexar(',');
+            anexarClave("nombre");
+            anexarCampo(banco.getNombre());
+            for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+                anexar(',');
+                anexarClave(COLUMNAS_ACTIVO[i]);
+                anexarMonto(totales[i]);
+            }
+            anexar(',');
+            anexarClave("valor_usd");
+            anexarDecimal(tasas->valuar(totales));
+            anexar(',');
+            anexarClave("bovedas");
+            anexar('[');
+            for (std::size_t b = 0; b < bovedas.size(); ++b) {
+                SaldosBoveda saldos = bovedas[b]->getCopiaActivos();
+                anexar(b == 0 ? "{" : ",{");
+                anexarClave("id");
+                anexarCampo(bovedas[b]->getId());
+                anexar(',');
+                anexarClave("ubicacion");
+                anexarCampo(bovedas[b]->getUbicacion());
+                for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+                    anexar(',');
+                    anexarClave(COLUMNAS_ACTIVO[i]);
+                    anexarMonto(saldos[i]);
+                }
+                anexar(',');
+                anexarClave("valor_usd");
+                anexarDecimal(tasas->valuar(saldos));
+                anexar('}');
+            }
+            anexar("]}");
+            break;
+    }
+}
+
+void EscritorReporte::inicioTransacciones(std::size_t total, bool conArchivo, std::size_t archivadas) {
+    if (seccion == Seccion::TRANSACCIONES) {
+        throw OperacionInvalidaException("La sección de transacciones ya está abierta");
+    }
+    abrirSeccion(Seccion::TRANSACCIONES);
+    conTotales = true;
+    totalTransacciones = total;
+    transaccionesArchivadas = archivadas;
+    // En JSON los totales van al cerrar la sección, después de los registros
+    if (formato == FormatoReporte::TEXTO) {
+        anexar("=== TRANSACCIONES ===\n\n");
+        if (conArchivo) {
+            anexar("Transacciones archivadas: ");
+            anexarEntero(archivadas);
+            anexar("\n\n");
+        }
+    }
+}
+
+void EscritorReporte::transaccion(const Transaccion& transaccion) {
+    abrirSeccion(Seccion::TRANSACCIONES);
+    separarRegistro();
+
+    Activo activo = transaccion.getActivo();
+    double porcentaje = transaccion.getPorcentajeComision() * 100;
+    std::string observaciones = transaccion.getObservaciones();
+
+    switch (formato) {
+        case FormatoReporte::TEXTO:
+            anexar("Transacción ID: ");
+            anexar(transaccion.getId());
+            anexar("\nTipo: ");
+            anexar(transaccion.getTipoString());
+            anexar("\nEstado: ");
+            anexar(transaccion.getEstadoString());
+            anexar("\nOrigen: ");
+            anexar(transaccion.getBancoOrigenCodigo());
+            anexar(" - Bóveda ");
+            anexar(transaccion.getBovedaOrigenId());
+            anexar("\nDestino: ");
+            anexar(transaccion.getBancoDestinoCodigo());
+            anexar(" - Bóveda ");
+            anexar(transaccion.getBovedaDestinoId());
+            anexar("\nActivo: ");
+            anexarMonto(activo.getMonto());
+            anexar(' ');
+            anexar(activo.getTipoString());
+            anexar("\nTransportadora: ");
+            anexar(transaccion.getTransportadora());
+            anexar("\nComisión: ");
+            anexarDecimal(porcentaje);
+            anexar("% ($ ");
+            anexarMonto(transaccion.getComision());
+            anexar(")\n");
+            if (!observaciones.empty()) {
+                anexar("Observaciones: ");
+                anexar(observaciones);
+                anexar('\n');
+            }
+            anexar('\n');
+            break;
+        case FormatoReporte::CSV:
+            anexarCampo(transaccion.getId());
+            anexar(',');
+            anexarCampo(transaccion.getTipoString());
+            anexar(',');
+            anexarCampo(transaccion.getEstadoString());
+            anexar(',');
+            anexarCampo(transaccion.getBancoOrigenCodigo());
+            anexar(',');
+            anexarCampo(transaccion.getBovedaOrigenId());
+            anexar(',');
+            anexarCampo(transaccion.getBancoDestinoCodigo());
+            anexar(',');
+            anexarCampo(transaccion.getBovedaDestinoId());
+            anexar(',');
+            anexarCampo(activo.getTipoString());
+            anexar(',');
+            anexarMonto(activo.getMonto());
+            anexar(',');
+            anexarCampo(transaccion.getTransportadora());
+            anexar(',');
+            anexarDecimal(porcentaje);
+            anexar(',');
+            anexarMonto(transaccion.getComision());
+            anexar(',');
+            anexarCampo(observaciones);
+            anexar('\n');
+            break;
+        case FormatoReporte::JSON:
+            anexar('{');
+            anexarClave("id");
+            anexarCampo(transaccion.getId());
+            anexar(',');
+            anexarClave("tipo");
+            anexarCampo(transaccion.getTipoString());
+            anexar(',');
+            anexarClave("estado");
+            anexarCampo(transaccion.getEstadoString());
+            anexar(',');
+            anexarClave("banco_origen");
+            anexarCampo(transaccion.getBancoOrigenCodigo());
+            anexar(',');
+            anexarClave("boveda_origen");
+            anexarCampo(transaccion.getBovedaOrigenId());
+            anexar(',');
+            anexarClave("banco_destino");
+            anexarCampo(transaccion.getBancoDestinoCodigo());
+            anexar(',');
+            anexarClave("boveda_destino");
+            anexarCampo(transaccion.getBovedaDestinoId());
+            anexar(',');
+            anexarClave("activo");
+            anexarCampo(activo.getTipoString());
+            anexar(',');
+            anexarClave("cantidad");
+            anexarMonto(activo.getMonto());
+            anexar(',');
+            anexarClave("transportadora");
+            anexarCampo(transaccion.getTransportadora());
+            anexar(',');
+            anexarClave("comision_pct");
+            anexarDecimal(porcentaje);
+            anexar(',');
+            anexarClave("comision");
+            anexarMonto(transaccion.getComision());
+            anexar(',');
+            anexarClave("observaciones");
+            anexarCampo(observaciones);
+            anexar('}');
+            break;
+    }
+}
+
+void EscritorReporte::terminar() {
+    if (terminado) {
+        return;
+    }
+    cerrarSeccion();
+    if (formato == FormatoReporte::JSON) {
+        anexar(secciones == 0 ? "{}\n" : "}\n");
+    }
+    vaciar();
+    terminado = true;
+}
+
+void EscritorReporte::abrirSeccion(Seccion nueva) {
+    if (terminado) {
+        throw OperacionInvalidaException("El reporte ya fue terminado");
+    }
+    if (nueva == seccion) {
+        return;
+    }
+    cerrarSeccion();
+
+    switch (formato) {
+        case FormatoReporte::TEXTO:
+            break;
+        case FormatoReporte::CSV:
+            if (secciones > 0) {
+                anexar('\n');
+            }
+            anexar(nueva == Seccion::RESUMEN ? ENCABEZADO_RESUMEN_CSV
+                   : nueva == Seccion::BANCOS ? ENCABEZADO_BANCOS_CSV
+                                              : ENCABEZADO_TRANSACCIONES_CSV);
+            break;
+        case FormatoReporte::JSON:
+            anexar(secciones == 0 ? '{' : ',');
+            anexar(nueva == Seccion::RESUMEN ? "\"resumen\":{"
+                   : nueva == Seccion::BANCOS ? "\"bancos\":["
+                                              : "\"transacciones\":{\"registros\":[");
+            break;
+    }
+    seccion = nueva;
+    ++secciones;
+    primerRegistro = true;
+    conTotales = false;
+}
+
+void EscritorReporte::cerrarSeccion() {
+    switch (seccion) {
+        case Seccion::NINGUNA:
+            return;
+        case Seccion::RESUMEN:
+            if (formato == FormatoReporte::JSON) {
+                anexar('}');
+            }
+            break;
+        case Seccion::BANCOS:
+            if (formato == FormatoReporte::JSON) {
+                anexar(']');
+            }
+            break;
+        case Seccion::TRANSACCIONES:
+            if (formato == FormatoReporte::TEXTO && conTotales && totalTransacciones == 0) {
+                anexar("No hay transacciones registradas.\n");
+            } else if (formato == FormatoReporte::JSON) {
+                anexar(']');
+                if (conTotales) {
+                    anexar(',');
+                    anexarClave("total");
+                    anexarEntero(totalTransacciones);
+                    anexar(',');
+                    anexarClave("archivadas");
+                    anexarEntero(transaccionesArchivadas);
+                }
+                anexar('}');
+            }
+            break;
+    }
+    seccion = Seccion::NINGUNA;
+}
+
+void EscritorReporte::separarRegistro() {
+    if (formato == FormatoReporte::JSON && !primerRegistro) {
+        anexar(',');
+    }
+    primerRegistro = false;
+}
+
+void EscritorReporte::vaciar() {
+    if (usados > 0) {
+        salida.escribir(bufer.data(), usados);
+        usados = 0;
+    }
+}
+
+void EscritorReporte::anexar(std::string_view texto) {
+    if (usados + texto.size() > bufer.size()) {
+        vaciar();
+        if (texto.size() > bufer.size()) {
+            salida.escribir(texto.data(), texto.size());
+            return;
+        }
+    }
+    std::memcpy(bufer.data() + usados, texto.data(), texto.size());
+    usados += texto.size();
+}
+
+void EscritorReporte::anexar(char caracter) {
+    if (usados == bufer.size()) {
+        vaciar();
+    }
+    bufer[usados++] = caracter;
+}
+
+void EscritorReporte::anexarEntero(unsigned long long valor) {
+    char numero[24];
+    auto [fin, error] = std::to_chars(numero, numero + sizeof(numero), valor);
+    anexar(std::string_view(numero, static_cast<std::size_t>(fin - numero)));
+}
+
+void EscritorReporte::anexarMonto(Monto monto) {
+    // Desde el entero, igual que Monto::toString
+    std::int64_t centesimas = monto.getCentesimas();
+    unsigned long long absoluto = centesimas < 0 ? 0 - static_cast<unsigned long long>(centesimas)
+                                                 : static_cast<unsigned long long>(centesimas);
+    if (centesimas < 0) {
+        anexar('-');
+    }
+    anexarEntero(absoluto / Monto::ESCALA);
+    unsigned long long resto = absoluto % Monto::ESCALA;
+    char decimales[3] = {'.', static_cast<char>('0' + resto / 10), static_cast<char>('0' + resto % 10)};
+    anexar(std::string_view(decimales, sizeof(decimales)));
+}
+
+void EscritorReporte::anexarDecimal(double valor) {
+    // Alcanza para cualquier double en notación fija con dos decimales
+    char numero[352];
+    auto [fin, error] = std::to_chars(numero, numero + sizeof(numero), valor, std::chars_format::fixed, 2);
+    if (error != std::errc()) {
+        throw ErrorInternoSistemaException("No se pudo formatear un valor del reporte");
+    }
+    anexar(std::string_view(numero, static_cast<std::size_t>(fin - numero)));
+}
+
+void EscritorReporte::anexarCampo(std::string_view texto) {
+    switch (formato) {
+        case FormatoReporte::TEXTO:
+            anexar(texto);
+            break;
+        case FormatoReporte::CSV:
+            if (texto.find_first_of(",\"\r\n") == std::string_view::npos) {
+                anexar(texto);
+                break;
+            }
+            anexar('"');
+            for (char c : texto) {
+                if (c == '"') {
+                    anexar('"');
+                }
+                anexar(c);
+            }
+            anexar('"');
+            break;
+        case FormatoReporte::JSON:
+            anexar('"');
+            for (char c : texto) {
+                unsigned char u = static_cast<unsigned char>(c);
+                if (c == '"' || c == '\\') {
+                    anexar('\\');
+                    anexar(c);
+                } else if (c == '\n') {
+                    anexar("\\n");
+                } else if (c == '\r') {
+                    anexar("\\r");
+                } else if (c == '\t') {
+                    anexar("\\t");
+                } else if (u < 0x20) {
+                    const char* hex = "0123456789abcdef";
+                    char escape[6] = {'\\', 'u', '0', '0', hex[u >> 4], hex[u & 0xf]};
+                    anexar(std::string_view(escape, sizeof(escape)));
+                } else {
+                    anexar(c); // UTF-8 tal cual
+                }
+            }
+            anexar('"');
+            break;
+    }
+}
+
+void EscritorReporte::anexarClave(std::string_view clave) {
+    anexar('"');
+    anexar(clave);
+    anexar("\":");
+}
@@ -0,0 +1,109 @@
+#ifndef REPORTE_H
+#define REPORTE_H
+
+#include "boveda.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Banco;
+class Transaccion;
+struct TasasCambio;
+
+// Destino de un reporte: recibe bloques ya formateados, en orden
+class SalidaReporte {
+public:
+    virtual ~SalidaReporte() = default;
+    virtual void escribir(const char* datos, std::size_t longitud) = 0;
+};
+
+// Escribe en un descriptor de archivo abierto (no lo cierra)
+class SalidaDescriptor : public SalidaReporte {
+private:
+    int descriptor;
+
+public:
+    explicit SalidaDescriptor(int descriptor);
+    void escribir(const char* datos, std::size_t longitud) override;
+};
+
+// Anexa a una cadena del llamador
+class SalidaCadena : public SalidaReporte {
+private:
+    std::string& destino;
+
+public:
+    explicit SalidaCadena(std::string& destino);
+    void escribir(const char* datos, std::size_t longitud) override;
+};
+
+enum class FormatoReporte {
+    TEXTO, // El mismo texto que getResumen de cada entidad
+    CSV,   // Una tabla por sección, con encabezado, separadas por una línea en blanco
+    JSON   // Un único objeto con las secciones como campos
+};
+
+// Escritor de reportes en streaming. Cada registro (banco con sus bóvedas,
+// transacción) se formatea en un búfer de tamaño fijo que se vacía en la
+// salida al llenarse, así que la memoria no depende del tamaño del reporte.
+// Los números se formatean con std::to_chars: los montos desde su entero
+// en centésimas y los valores en dólares con dos decimales.
+//
+// Las secciones (resumen, bancos, transacciones) se abren solas con su
+// primer registro; terminar() cierra la última y vacía el búfer, y debe
+// llamarse antes de descartar el escritor. Todo el reporte se valúa con
+// las tasas de cambio vigentes al construirlo.
+class EscritorReporte {
+private:
+    enum class Seccion { NINGUNA, RESUMEN, BANCOS, TRANSACCIONES };
+
+    static constexpr std::size_t CAPACIDAD = 64 * 1024;
+
+    SalidaReporte& salida;
+    FormatoReporte formato;
+    std::shared_ptr<const TasasCambio> tasas;
+    std::vector<char> bufer;
+    std::size_t usados;
+    Seccion seccion;
+    std::size_t secciones;     // Secciones abiertas hasta ahora
+    bool primerRegistro;       // JSON: el próximo registro de la sección no lleva coma
+    bool conTotales;           // Se llamó a inicioTransacciones() en esta sección
+    std::size_t totalTransacciones;
+    std::size_t transaccionesArchivadas;
+    bool terminado;
+
+    void abrirSeccion(Seccion nueva);
+    void cerrarSeccion();
+    void separarRegistro();
+
+    void vaciar();
+    void anexar(std::string_view texto);
+    void anexar(char caracter);
+    void anexarEntero(unsigned long long valor);
+    void anexarMonto(Monto monto);
+    void anexarDecimal(double valor); // Dos decimales fijos
+    // Texto libre: entre comillas y escapado en JSON, entre comillas si hace falta en CSV
+    void anexarCampo(std::string_view texto);
+    void anexarClave(std::string_view clave); // JSON: "clave":
+
+public:
+    EscritorReporte(SalidaReporte& salida, FormatoReporte formato);
+
+    EscritorReporte(const EscritorReporte&) = delete;
+    EscritorReporte& operator=(const EscritorReporte&) = delete;
+
+    void resumen(std::size_t bancos, std::size_t transacciones, const SaldosBoveda& totales);
+    void banco(const Banco& banco); // Incluye sus bóvedas
+    // Abre la sección de transacciones con los totales del sistema; es
+    // opcional, sin ella la sección se abre con la primera transacción.
+    // Con 'conArchivo' el texto informa las archivadas aunque sean cero.
+    void inicioTransacciones(std::size_t total, bool conArchivo, std::size_t archivadas);
+    void transaccion(const Transaccion& transaccion);
+    void terminar();
+
+    FormatoReporte getFormato() const { return formato; }
+};
+
+#endif // REPORTE_H
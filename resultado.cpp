@@ -0,0 +1,73 @@
+#include "resultado.h"
+#include "exceptions.h"
+
+ErrorBoveda::ErrorBoveda()
+    : codigo(CodigoError::NINGUNO), descripcion(nullptr), sujetoEsMensaje(false), tipoActivo(TipoActivo::SOLES) {}
+
+ErrorBoveda::ErrorBoveda(CodigoError codigo, std::string sujeto)
+    : codigo(codigo), descripcion(nullptr), sujeto(std::move(sujeto)), sujetoEsMensaje(false),
+      tipoActivo(TipoActivo::SOLES) {}
+
+ErrorBoveda ErrorBoveda::conMensaje(CodigoError codigo, std::string mensaje) {
+    ErrorBoveda error(codigo, std::move(mensaje));
+    error.sujetoEsMensaje = true;
+    return error;
+}
+
+ErrorBoveda ErrorBoveda::saldoInsuficiente(std::string idBoveda, TipoActivo tipo, Monto disponible, Monto solicitado) {
+    ErrorBoveda error(CodigoError::SALDO_INSUFICIENTE, std::move(idBoveda));
+    error.tipoActivo = tipo;
+    error.disponible = disponible;
+    error.solicitado = solicitado;
+    return error;
+}
+
+std::string ErrorBoveda::getMensaje() const {
+    if (descripcion) {
+        return descripcion;
+    }
+    if (sujetoEsMensaje) {
+        return sujeto;
+    }
+    switch (codigo) {
+        case CodigoError::NINGUNO:
+            return "";
+        case CodigoError::SALDO_INSUFICIENTE:
+            return "Saldo insuficiente de " + Activo::tipoActivoToString(tipoActivo) +
+                   " en bóveda " + sujeto + ". Disponible: " + disponible.toString() +
+                   ", Solicitado: " + solicitado.toString();
+        case CodigoError::BOVEDA_NO_ENCONTRADA:
+            return "Bóveda no encontrada: " + sujeto;
+        case CodigoError::BANCO_NO_ENCONTRADO:
+            return "Banco no encontrado: " + sujeto;
+        case CodigoError::TRANSACCION_NO_ENCONTRADA:
+            return "Transacción no encontrada: " + sujeto;
+        case CodigoError::TRANSACCION_ARCHIVADA:
+            return "La transacción está archivada: " + sujeto;
+        case CodigoError::DATOS_INVALIDOS:
+            return "Datos inválidos: " + sujeto;
+        case CodigoError::OPERACION_INVALIDA:
+            return "Operación inválida: " + sujeto;
+    }
+    return "Error desconocido";
+}
+
+void ErrorBoveda::lanzar() const {
+    switch (codigo) {
+        case CodigoError::SALDO_INSUFICIENTE:
+            throw SaldoInsuficienteException(getMensaje());
+        case CodigoError::BOVEDA_NO_ENCONTRADA:
+            throw BovedaNoEncontradaException(getMensaje());
+        case CodigoError::BANCO_NO_ENCONTRADO:
+            throw EntidadBancariaNoEncontradaException(getMensaje());
+        case CodigoError::DATOS_INVALIDOS:
+            throw DatosInvalidosException(getMensaje());
+        case CodigoError::TRANSACCION_NO_ENCONTRADA:
+        case CodigoError::TRANSACCION_ARCHIVADA:
+        case CodigoError::OPERACION_INVALIDA:
+            throw OperacionInvalidaException(getMensaje());
+        case CodigoError::NINGUNO:
+            break;
+    }
+    throw ErrorInternoSistemaException("Se intentó lanzar un resultado sin error");
+}
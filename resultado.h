@@ -0,0 +1,107 @@
+#ifndef RESULTADO_H
+#define RESULTADO_H
+
+#include "activo.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <variant>
+
+// Camino sin excepciones para los rechazos habituales (saldo insuficiente,
+// entidades inexistentes, datos inválidos). Las operaciones "intentar..."
+// devuelven un Resultado; las de siempre lo convierten en la excepción
+// equivalente de exceptions.h, así que la interfaz gráfica no cambia.
+
+enum class CodigoError : std::uint8_t {
+    NINGUNO,
+    SALDO_INSUFICIENTE,
+    BOVEDA_NO_ENCONTRADA,
+    BANCO_NO_ENCONTRADO,
+    TRANSACCION_NO_ENCONTRADA,
+    TRANSACCION_ARCHIVADA, // Terminada y movida al archivo: solo se puede consultar
+    DATOS_INVALIDOS,
+    OPERACION_INVALIDA
+};
+
+// Error con sus datos, no con su texto: el mensaje se arma recién en
+// getMensaje() (o al lanzar), así que rechazar no cuesta formateo
+class ErrorBoveda {
+private:
+    CodigoError codigo;
+    const char* descripcion; // Literal; si es nulo el mensaje se arma con el código
+    std::string sujeto;      // ID de la entidad involucrada, o el mensaje completo (conMensaje)
+    bool sujetoEsMensaje;
+    TipoActivo tipoActivo;
+    Monto disponible;
+    Monto solicitado;
+
+public:
+    ErrorBoveda();
+    // Texto fijo: solo acepta literales (un arreglo, no un const char*), que
+    // viven todo el programa, así que guardar el puntero es seguro. Un
+    // const char* cualquiera cae en el constructor con sujeto y se copia.
+    template <std::size_t N>
+    ErrorBoveda(CodigoError codigo, const char (&descripcion)[N]) : ErrorBoveda(codigo, std::string()) {
+        this->descripcion = descripcion;
+    }
+    ErrorBoveda(CodigoError codigo, std::string sujeto);
+
+    // Mensaje armado en tiempo de ejecución, tal cual
+    static ErrorBoveda conMensaje(CodigoError codigo, std::string mensaje);
+
+    static ErrorBoveda saldoInsuficiente(std::string idBoveda, TipoActivo tipo, Monto disponible, Monto solicitado);
+
+    CodigoError getCodigo() const { return codigo; }
+    bool hayError() const { return codigo != CodigoError::NINGUNO; }
+    std::string getMensaje() const;
+
+    // Lanza la excepción de exceptions.h que corresponde al código
+    [[noreturn]] void lanzar() const;
+};
+
+template <typename T>
+class [[nodiscard]] Resultado {
+private:
+    std::variant<T, ErrorBoveda> contenido;
+
+public:
+    Resultado(T valor) : contenido(std::in_place_index<0>, std::move(valor)) {}
+    Resultado(ErrorBoveda error) : contenido(std::in_place_index<1>, std::move(error)) {}
+
+    bool ok() const { return contenido.index() == 0; }
+    explicit operator bool() const { return ok(); }
+    CodigoError getCodigo() const { return ok() ? CodigoError::NINGUNO : std::get<1>(contenido).getCodigo(); }
+    const ErrorBoveda& getError() const { return std::get<1>(contenido); }
+
+    // Lanza la excepción equivalente si hubo error
+    T& valor() {
+        if (!ok()) std::get<1>(contenido).lanzar();
+        return std::get<0>(contenido);
+    }
+    const T& valor() const {
+        if (!ok()) std::get<1>(contenido).lanzar();
+        return std::get<0>(contenido);
+    }
+};
+
+template <>
+class [[nodiscard]] Resultado<void> {
+private:
+    ErrorBoveda error;
+
+public:
+    Resultado() = default;
+    Resultado(ErrorBoveda error) : error(std::move(error)) {}
+
+    bool ok() const { return !error.hayError(); }
+    explicit operator bool() const { return ok(); }
+    CodigoError getCodigo() const { return error.getCodigo(); }
+    const ErrorBoveda& getError() const { return error; }
+
+    void valor() const {
+        if (!ok()) error.lanzar();
+    }
+};
+
+#endif // RESULTADO_H
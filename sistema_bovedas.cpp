@@ -1,10 +1,129 @@
 #include "sistema_bovedas.h"
 #include "exceptions.h"
+#include "generador_topologia.h"
+#include "tasas_cambio.h"
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <charconv>
+#include <limits>
+#include <unordered_map>
 
-SistemaBovedas::SistemaBovedas() : generador(std::random_device{}()), contadorTransacciones(1) {
+namespace {
+
+std::int64_t instanteActual() {
+    return Instantanea::desdeFecha(std::chrono::system_clock::now());
+}
+
+// Paso de una transacción en curso en este hilo: sus movimientos de saldo no
+// se registran en el diario (van implícitos en el AVANZAR o CANCELAR) y el
+// historial los recibe con el instante del paso
+struct PasoEnCurso {
+    bool activo = false;
+    std::int64_t instante = 0;
+};
+thread_local PasoEnCurso pasoEnCurso;
+
+class PasoDeTransaccion {
+private:
+    PasoEnCurso anterior;
+
+public:
+    explicit PasoDeTransaccion(std::int64_t instante) : anterior(pasoEnCurso) {
+        pasoEnCurso.activo = true;
+        pasoEnCurso.instante = instante;
+    }
+    ~PasoDeTransaccion() {
+        pasoEnCurso = anterior;
+    }
+    PasoDeTransaccion(const PasoDeTransaccion&) = delete;
+    PasoDeTransaccion& operator=(const PasoDeTransaccion&) = delete;
+};
+
+// Reglas de una solicitud que no dependen del registro ni de los saldos;
+// las comparten la creación individual y la creación por lotes
+Resultado<Activo> validarSolicitud(const std::string& bancoOrigenCodigo, const std::string& bovedaOrigenId,
+                                   const std::string& bancoDestinoCodigo, const std::string& bovedaDestinoId,
+                                   TipoActivo tipoActivo, double cantidad, const std::string& transportadora,
+                                   double porcentajeComision) {
+    Resultado<Activo> activo = Activo::intentarCrear(tipoActivo, cantidad);
+    if (!activo) {
+        return activo;
+    }
+    if (porcentajeComision < 0 || porcentajeComision > 1) {
+        return ErrorBoveda(CodigoError::DATOS_INVALIDOS, "El porcentaje de comisión debe estar entre 0 y 1");
+    }
+    if (bancoOrigenCodigo == bancoDestinoCodigo && bovedaOrigenId == bovedaDestinoId) {
+        return ErrorBoveda(CodigoError::OPERACION_INVALIDA, "La bóveda de origen no puede ser la misma que la de destino");
+    }
+    if (transportadora.size() > Diario::LONGITUD_MAXIMA_TEXTO) {
+        return ErrorBoveda(CodigoError::DATOS_INVALIDOS, "El nombre de la transportadora es demasiado largo");
+    }
+    return activo;
+}
+
+// Valida el registro de la instantánea y construye la transacción con
+// 'crear' (en un arena o suelta)
+template <typename Crear>
+auto crearDesdeInstantanea(const Instantanea& instantanea, const TransaccionInstantanea& guardada,
+                           const std::string& id, Crear crear) {
+    // Los registros se validan al materializarlos, no al abrir la instantánea
+    if (guardada.bovedaOrigen >= instantanea.getCantidadBovedas() ||
+        guardada.bovedaDestino >= instantanea.getCantidadBovedas() ||
+        guardada.tipoActivo >= NUM_TIPOS_ACTIVO ||
+        guardada.estado > static_cast<std::uint8_t>(EstadoTransaccion::CANCELADA)) {
+        throw ConfiguracionInvalidaException("Instantánea inconsistente: transacción " + id);
+    }
+    const BovedaInstantanea& origen = instantanea.getBoveda(guardada.bovedaOrigen);
+    const BovedaInstantanea& destino = instantanea.getBoveda(guardada.bovedaDestino);
+    auto transaccion = crear(
+        id,
+        instantanea.getCadena(instantanea.getBanco(origen.banco).codigo),
+        instantanea.getCadena(origen.id),
+        instantanea.getCadena(instantanea.getBanco(destino.banco).codigo),
+        instantanea.getCadena(destino.id),
+        Activo(static_cast<TipoActivo>(guardada.tipoActivo), Monto::desdeCentesimas(guardada.centesimas)),
+        instantanea.getCadena(guardada.transportadora),
+        guardada.porcentajeComision);
+    transaccion->restaurar(static_cast<EstadoTransaccion>(guardada.estado),
+                           Instantanea::aFecha(guardada.fechaCreacion),
+                           Instantanea::aFecha(guardada.fechaCompletada),
+                           std::string(instantanea.getCadena(guardada.observaciones)));
+    transaccion->restaurarTasaADolares(guardada.tasaADolares);
+    return transaccion;
+}
+
+std::unique_ptr<Transaccion> copiarTransaccion(const Transaccion& transaccion) {
+    auto copia = std::make_unique<Transaccion>(std::string(transaccion.getId()),
+                                               transaccion.getBancoOrigenCodigo(), transaccion.getBovedaOrigenId(),
+                                               transaccion.getBancoDestinoCodigo(), transaccion.getBovedaDestinoId(),
+                                               transaccion.getActivo(), transaccion.getTransportadora(),
+                                               transaccion.getPorcentajeComision());
+    copia->restaurar(transaccion.getEstado(), transaccion.getFechaCreacion(), transaccion.getFechaCompletada(),
+                     transaccion.getObservaciones());
+    copia->restaurarTasaADolares(transaccion.getTasaADolares());
+    return copia;
+}
+
+// Reporte de texto completo en una cadena
+template <typename Escribir>
+std::string reporteEnTexto(Escribir escribir) {
+    std::string texto;
+    SalidaCadena salida(texto);
+    EscritorReporte escritor(salida, FormatoReporte::TEXTO);
+    escribir(escritor);
+    escritor.terminar();
+    return texto;
+}
+
+} // namespace
+
+SistemaBovedas::SistemaBovedas()
+    : generador(std::random_device{}()), contadorTransacciones(1),
+      instanteReaplicado(0), primeraEnInstantanea(1), ultimaEnInstantanea(0),
+      transaccionesMaterializadas(std::make_unique<ArenaTransacciones>()), ventanaArchivo(0), primeraRetenida(1) {
+    // La posición 0 queda vacía porque los IDs comienzan en TXN-000001
+    indiceTransacciones.agregar({nullptr, 0, 0, 0, nullptr, nullptr});
 }
 
 void SistemaBovedas::inicializarSistema() {
@@ -12,6 +131,14 @@ void SistemaBovedas::inicializarSistema() {
     asignarActivosAleatorios();
 }
 
+void SistemaBovedas::inicializarSistema(const std::string& rutaDiario, ModoDurabilidad modo) {
+    crearBancosIniciales();
+    if (!habilitarDiario(rutaDiario, modo)) {
+        // Los depósitos iniciales también quedan en el diario
+        asignarActivosAleatorios();
+    }
+}
+
 void SistemaBovedas::crearBancosIniciales() {
     // Crear los 3 bancos peruanos principales
     auto bcp = std::make_unique<Banco>("Banco de Crédito del Perú", "BCP");
@@ -33,47 +160,19 @@ void SistemaBovedas::crearBancosIniciales() {
     agregarBanco(std::move(bbva));
 }
 
+void SistemaBovedas::inicializarSistema(const ConfiguracionTopologia& topologia) {
+    GeneradorTopologia(topologia).generar(*this);
+}
+
 void SistemaBovedas::asignarActivosAleatorios() {
-    // Distribución para generar valores aleatorios entre 10M y 100M USD equivalentes
-    std::uniform_real_distribution<double> distribValorTotal(10000000.0, 100000000.0);
-    std::uniform_real_distribution<double> distribPorcentaje(0.0, 1.0);
-    
-    for (auto& [codigo, banco] : bancos) {
-        double valorTotalBanco = distribValorTotal(generador);
-        
-        // Dividir los activos entre las bóvedas del banco
-        const auto& bovedas = banco->getBovedas();
-        for (const auto& boveda : bovedas) {
-            // Asignar una porción del valor total del banco a cada bóveda
-            double valorBoveda = valorTotalBanco / bovedas.size();
-            
-            // Distribuir entre los tipos de activos
-            double porcentajeSoles = distribPorcentaje(generador) * 0.4; // 0-40%
-            double porcentajeDolares = distribPorcentaje(generador) * 0.5; // 0-50%
-            double porcentajeJoyas = 1.0 - porcentajeSoles - porcentajeDolares;
-            
-            if (porcentajeJoyas < 0) {
-                porcentajeJoyas = 0.1; // Mínimo 10% en joyas
-                porcentajeDolares = 0.9 - porcentajeSoles;
-            }
-            
-            // Convertir valores a cantidades (considerando tasas de cambio)
-            double cantidadSoles = (valorBoveda * porcentajeSoles) / 0.27; // 1 USD = 3.7 PEN aprox
-            double cantidadDolares = valorBoveda * porcentajeDolares;
-            double cantidadJoyas = (valorBoveda * porcentajeJoyas) / 50.0; // 1 joya = 50 USD aprox
-            
-            // Agregar activos a la bóveda
-            if (cantidadSoles > 0) {
-                boveda->agregarActivo(Activo(TipoActivo::SOLES, cantidadSoles));
-            }
-            if (cantidadDolares > 0) {
-                boveda->agregarActivo(Activo(TipoActivo::DOLARES, cantidadDolares));
-            }
-            if (cantidadJoyas > 0) {
-                boveda->agregarActivo(Activo(TipoActivo::JOYAS, cantidadJoyas));
-            }
-        }
-    }
+    asignarActivosAleatorios(generador());
+}
+
+void SistemaBovedas::asignarActivosAleatorios(std::uint64_t semilla) {
+    // Valores entre 10M y 100M USD equivalentes por banco
+    ConfiguracionTopologia topologia;
+    topologia.semilla = semilla;
+    GeneradorTopologia(topologia).asignarActivos(*this);
 }
 
 void SistemaBovedas::agregarBanco(std::unique_ptr<Banco> banco) {
@@ -85,22 +184,696 @@ void SistemaBovedas::agregarBanco(std::unique_ptr<Banco> banco) {
     if (bancos.find(codigo) != bancos.end()) {
         throw OperacionInvalidaException("Ya existe un banco con código: " + codigo);
     }
+    // El diario y el archivo guardan estos textos con longitud de 16 bits
+    if (codigo.size() > Diario::LONGITUD_MAXIMA_TEXTO) {
+        throw DatosInvalidosException("El código del banco es demasiado largo");
+    }
+    for (const auto& boveda : banco->getBovedas()) {
+        if (boveda->getId().size() > Diario::LONGITUD_MAXIMA_TEXTO) {
+            throw DatosInvalidosException("El ID de la bóveda es demasiado largo");
+        }
+    }
     
+    registro.registrarBanco(banco.get());
+    banco->getAcumulador().setPadre(&totales);
+    banco->setObservador(this);
     bancos[codigo] = std::move(banco);
 }
 
 Banco* SistemaBovedas::buscarBanco(const std::string& codigo) {
-    auto it = bancos.find(codigo);
-    if (it == bancos.end()) {
-        throw EntidadBancariaNoEncontradaException("Banco no encontrado: " + codigo);
-    }
-    return it->second.get();
+    return registro.getBanco(registro.resolverBanco(codigo));
 }
 
 const std::map<std::string, std::unique_ptr<Banco>>& SistemaBovedas::getBancos() const {
     return bancos;
 }
 
+HandleBoveda SistemaBovedas::resolverBoveda(const std::string& codigoBanco, const std::string& idBoveda) {
+    return registro.resolverBoveda(codigoBanco, idBoveda);
+}
+
+const RegistroBovedas& SistemaBovedas::getRegistro() const {
+    return registro;
+}
+
+void SistemaBovedas::habilitarAlmacenColumnar() {
+    if (!almacen) {
+        almacen = std::make_unique<AlmacenSaldos>();
+    }
+    
+    // Registrar las bóvedas que se agregaron a un banco después de registrarlo
+    for (const auto& [codigo, banco] : bancos) {
+        HandleBanco handleBanco = registro.resolverBanco(codigo);
+        for (const auto& boveda : banco->getBovedas()) {
+            registro.resolverBoveda(handleBanco, boveda->getId());
+        }
+    }
+    
+    for (HandleBoveda handle = static_cast<HandleBoveda>(almacen->getCantidadBovedas());
+         handle < registro.getCantidadBovedas(); ++handle) {
+        almacen->agregarBoveda(handle, registro.getBancoDeBoveda(handle));
+        registro.getBoveda(handle)->conectarAlmacen(almacen.get(), handle);
+    }
+    
+    for (const auto& [codigo, banco] : bancos) {
+        banco->conectarAlmacen(almacen.get(), registro.resolverBanco(codigo));
+    }
+}
+
+const AlmacenSaldos* SistemaBovedas::getAlmacen() const {
+    return almacen.get();
+}
+
+bool SistemaBovedas::habilitarDiario(const std::string& ruta, ModoDurabilidad modo) {
+    if (diario) {
+        throw OperacionInvalidaException("El diario ya está habilitado");
+    }
+    
+    // La reaplicación pasa por las operaciones normales; sin diario abierto no se
+    // vuelve a registrar. Los registros que ya refleja la instantánea se saltan.
+    const std::uint64_t lsnInstantanea = instantanea ? instantanea->getRegistrosDiario() : 0;
+    std::uint64_t ultimoLsn = Diario::leer(ruta, [this](const RegistroDiario& registro) {
+        aplicarRegistroDiario(registro);
+    }, lsnInstantanea);
+    
+    diario = std::make_unique<Diario>(ruta, modo, std::max(ultimoLsn, lsnInstantanea));
+    if (ultimoLsn < lsnInstantanea) {
+        // La instantánea se guardó pero el diario no llegó a rotarse (o perdió
+        // su final): todo lo que tiene ya está en ella, se empieza de nuevo
+        diario->rotar();
+    }
+    return ultimoLsn > lsnInstantanea || instantanea;
+}
+
+void SistemaBovedas::aplicarRegistroDiario(const RegistroDiario& registroDiario) {
+    switch (registroDiario.tipo) {
+        case TipoRegistroDiario::MOVIMIENTO: {
+            Boveda* boveda = registro.getBoveda(resolverBoveda(registroDiario.codigoBanco, registroDiario.idBoveda));
+            Monto delta = Monto::desdeCentesimas(registroDiario.centesimas);
+            // El historial recibe el instante original del movimiento
+            instanteReaplicado = registroDiario.instante;
+            try {
+                if (delta.esPositivo()) {
+                    boveda->agregarActivo(Activo(registroDiario.tipoActivo, delta));
+                } else if (delta.esNegativo()) {
+                    boveda->retirarActivo(Activo(registroDiario.tipoActivo, -delta));
+                }
+            } catch (...) {
+                instanteReaplicado = 0;
+                throw;
+            }
+            instanteReaplicado = 0;
+            break;
+        }
+        case TipoRegistroDiario::INICIAR:
+        case TipoRegistroDiario::LOTE: {
+            const RegistroDiario* altas = &registroDiario;
+            std::size_t cantidad = 1;
+            if (registroDiario.tipo == TipoRegistroDiario::LOTE) {
+                altas = registroDiario.lote.data();
+                cantidad = registroDiario.lote.size();
+            }
+            std::vector<TransaccionNueva> nuevas;
+            nuevas.reserve(cantidad);
+            for (std::size_t k = 0; k < cantidad; ++k) {
+                const RegistroDiario& alta = altas[k];
+                if (alta.numeroTransaccion != static_cast<std::uint64_t>(contadorTransacciones) + k) {
+                    throw ErrorInternoSistemaException("El diario no es consistente: se esperaba la transacción " +
+                                                       std::to_string(contadorTransacciones + k));
+                }
+                nuevas.push_back({alta.bancoOrigenCodigo, alta.bovedaOrigenId, alta.bancoDestinoCodigo, alta.bovedaDestinoId,
+                                  Activo(alta.tipoActivo, Monto::desdeCentesimas(alta.centesimas)),
+                                  alta.transportadora, alta.porcentajeComision,
+                                  resolverBoveda(alta.bancoOrigenCodigo, alta.bovedaOrigenId),
+                                  resolverBoveda(alta.bancoDestinoCodigo, alta.bovedaDestinoId),
+                                  alta.tasaADolares});
+            }
+            std::lock_guard<std::mutex> bloqueo(mutexCreacion);
+            crearTransaccionesSinBloqueo(nuevas.data(), nuevas.size());
+            break;
+        }
+        case TipoRegistroDiario::AVANZAR:
+        case TipoRegistroDiario::CANCELAR:
+        case TipoRegistroDiario::FORZAR_AVANCE: {
+            std::size_t numero = static_cast<std::size_t>(registroDiario.numeroTransaccion);
+            if (numero == 0 || numero > getCantidadTransacciones() ||
+                (numero < primeraRetenida && rezagadas.find(numero) == rezagadas.end())) {
+                throw ErrorInternoSistemaException("El diario no es consistente: transacción desconocida " +
+                                                   std::to_string(registroDiario.numeroTransaccion));
+            }
+            EntradaTransaccion entrada = entradaEn(numero);
+            if (registroDiario.tipo == TipoRegistroDiario::FORZAR_AVANCE) {
+                EstadoTransaccion anterior = entrada.transaccion->getEstado();
+                entrada.transaccion->avanzarEstado();
+                actualizarIndices(entrada, anterior);
+                break;
+            }
+            
+            // Los movimientos del paso se vuelven a ejecutar con su instante original
+            instanteReaplicado = registroDiario.instante;
+            try {
+                if (registroDiario.tipo == TipoRegistroDiario::CANCELAR) {
+                    cancelarSinBloqueo(entrada, registroDiario.razon);
+                } else if (!avanzarEtapaSinBloqueo(entrada)) {
+                    throw ErrorInternoSistemaException("El diario no es consistente: no se puede avanzar la transacción " +
+                                                       std::to_string(registroDiario.numeroTransaccion));
+                }
+            } catch (...) {
+                instanteReaplicado = 0;
+                throw;
+            }
+            instanteReaplicado = 0;
+            break;
+        }
+    }
+}
+
+void SistemaBovedas::saldoModificado(const Boveda& boveda, TipoActivo tipo, Monto delta) {
+    if (publicador) {
+        publicador->saldoModificado(&boveda);
+    }
+    if (!diario && !historial) {
+        return;
+    }
+    std::int64_t instante = pasoEnCurso.activo ? pasoEnCurso.instante
+                          : instanteReaplicado != 0 ? instanteReaplicado
+                          : instanteActual();
+    if (historial) {
+        historial->registrarMovimiento(&boveda, tipo, delta, instante);
+    }
+    if (!diario || pasoEnCurso.activo) {
+        return;
+    }
+    
+    RegistroDiario registroDiario;
+    registroDiario.tipo = TipoRegistroDiario::MOVIMIENTO;
+    registroDiario.codigoBanco = boveda.getCodigoBanco();
+    registroDiario.idBoveda = boveda.getId();
+    registroDiario.tipoActivo = tipo;
+    registroDiario.centesimas = delta.getCentesimas();
+    registroDiario.instante = instante;
+    diario->agregar(registroDiario);
+}
+
+void SistemaBovedas::observacionIniciada(const Boveda& boveda, const SaldosBoveda& saldos) {
+    if (!historial) {
+        return;
+    }
+    // Una bóveda vacía se considera vacía desde siempre; una con saldos parte
+    // de la fecha de la instantánea de la que vienen o, si no, de ahora
+    bool vacia = std::all_of(saldos.begin(), saldos.end(), [](const Monto& m) { return m.esCero(); });
+    std::int64_t instante = vacia ? std::numeric_limits<std::int64_t>::min()
+                          : instantanea ? Instantanea::desdeFecha(instantanea->getFecha())
+                          : instanteActual();
+    historial->iniciarBoveda(&boveda, saldos, instante);
+}
+
+void SistemaBovedas::habilitarHistorial(std::size_t eventosPorBoveda) {
+    if (historial) {
+        return;
+    }
+    historial = std::make_unique<HistorialSaldos>(eventosPorBoveda);
+    // Volver a asignar el observador abre la serie de cada bóveda con sus saldos actuales
+    for (const auto& [codigo, banco] : bancos) {
+        banco->setObservador(this);
+    }
+}
+
+const HistorialSaldos* SistemaBovedas::getHistorial() const {
+    return historial.get();
+}
+
+void SistemaBovedas::restaurarHistorial(const Instantanea& cargada, const SerieHistorialInstantanea& guardada,
+                                        const Boveda& boveda) {
+    HistorialSaldos::SerieGuardada serie;
+    serie.inicio = guardada.inicio;
+    for (std::size_t k = 0; k < NUM_TIPOS_ACTIVO; ++k) {
+        serie.saldos[k] = Monto::desdeCentesimas(guardada.centesimas[k]);
+    }
+    const EventoHistorialInstantanea* eventos = cargada.getEventosHistorial(guardada);
+    serie.eventos.reserve(static_cast<std::size_t>(guardada.cantidadEventos));
+    for (std::uint64_t k = 0; k < guardada.cantidadEventos; ++k) {
+        if (eventos[k].tipoActivo >= NUM_TIPOS_ACTIVO) {
+            throw ConfiguracionInvalidaException("Instantánea inconsistente: tipo de activo inválido en el historial");
+        }
+        serie.eventos.push_back({eventos[k].instante, eventos[k].delta, static_cast<TipoActivo>(eventos[k].tipoActivo)});
+    }
+    if (historial->restaurarBoveda(&boveda, serie) != boveda.getCopiaActivos()) {
+        throw ConfiguracionInvalidaException("Instantánea inconsistente: el historial de la bóveda " + boveda.getId() +
+                                             " no coincide con sus saldos");
+    }
+}
+
+void SistemaBovedas::habilitarNotificaciones(std::chrono::milliseconds intervalo) {
+    if (publicador) {
+        return;
+    }
+    publicador = std::make_unique<PublicadorCambios>(intervalo);
+}
+
+PublicadorCambios* SistemaBovedas::getPublicador() {
+    return publicador.get();
+}
+
+std::uint64_t SistemaBovedas::actualizarTasas(const std::array<double, NUM_TIPOS_ACTIVO>& aDolares) {
+    std::uint64_t epoca = ProveedorTasas::getGlobal().publicar(aDolares);
+    if (publicador) {
+        publicador->tasasModificadas(epoca);
+    }
+    return epoca;
+}
+
+SaldosBoveda SistemaBovedas::getSaldosBovedaEn(const std::string& codigoBanco, const std::string& idBoveda,
+                                               std::chrono::system_clock::time_point instante) {
+    if (!historial) {
+        throw OperacionInvalidaException("El historial de saldos no está habilitado");
+    }
+    const Boveda* boveda = registro.getBoveda(resolverBoveda(codigoBanco, idBoveda));
+    return historial->getSaldosEn(boveda, Instantanea::desdeFecha(instante));
+}
+
+SaldosBoveda SistemaBovedas::getSaldosBancoEn(const std::string& codigoBanco,
+                                              std::chrono::system_clock::time_point instante) {
+    if (!historial) {
+        throw OperacionInvalidaException("El historial de saldos no está habilitado");
+    }
+    SaldosBoveda total{};
+    for (const auto& boveda : buscarBanco(codigoBanco)->getBovedas()) {
+        SaldosBoveda saldos = historial->getSaldosEn(boveda.get(), Instantanea::desdeFecha(instante));
+        for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+            total[i] += saldos[i];
+        }
+    }
+    return total;
+}
+
+RegistroDiario SistemaBovedas::registroDeTransaccion(TipoRegistroDiario tipo, const EntradaTransaccion& entrada) {
+    RegistroDiario registroDiario;
+    registroDiario.tipo = tipo;
+    registroDiario.numeroTransaccion = entrada.numero;
+    return registroDiario;
+}
+
+void SistemaBovedas::registrarEnDiario(const RegistroDiario& registroDiario) {
+    if (diario) {
+        diario->agregar(registroDiario);
+    }
+}
+
+std::uint64_t SistemaBovedas::lsnActual() {
+    return diario ? diario->getUltimoLsn() : 0;
+}
+
+void SistemaBovedas::esperarDiario(std::uint64_t lsn) {
+    if (diario && lsn > 0) {
+        diario->esperarDurable(lsn);
+    }
+}
+
+void SistemaBovedas::cargarInstantanea(const std::string& ruta) {
+    if (!bancos.empty() || getCantidadTransacciones() > 0) {
+        throw OperacionInvalidaException("La instantánea solo se puede cargar en un sistema vacío");
+    }
+    if (diario) {
+        throw OperacionInvalidaException("La instantánea debe cargarse antes de habilitar el diario");
+    }
+    
+    auto abierta = std::make_unique<Instantanea>(ruta);
+    const std::size_t cantidadBovedas = abierta->getCantidadBovedas();
+    const std::size_t cantidadTransacciones = abierta->getCantidadTransacciones();
+    const std::size_t primera = static_cast<std::size_t>(abierta->getPrimeraTransaccion());
+    if (primera == 0 || abierta->getContadorTransacciones() != primera + cantidadTransacciones) {
+        throw ConfiguracionInvalidaException("Instantánea inconsistente: contador de transacciones inválido");
+    }
+    // Se publica antes de agregar los bancos: el historial toma de aquí la fecha de los saldos
+    instantanea = std::move(abierta);
+    const Instantanea* cargada = instantanea.get();
+    
+    // Series del historial por posición de bóveda (como mucho una cada una)
+    std::vector<const SerieHistorialInstantanea*> seriesHistorial(historial ? cantidadBovedas : 0);
+    for (std::size_t i = 0; historial && i < cargada->getCantidadSeriesHistorial(); ++i) {
+        seriesHistorial[cargada->getSerieHistorial(i).boveda] = &cargada->getSerieHistorial(i);
+    }
+    
+    // Bancos y bóvedas se materializan ya (son pocos); la posición de cada
+    // bóveda en el archivo se traduce a su handle en el registro
+    std::vector<HandleBoveda> handles(cantidadBovedas);
+    for (std::size_t i = 0; i < cargada->getCantidadBancos(); ++i) {
+        const BancoInstantanea& guardado = cargada->getBanco(i);
+        if (guardado.primeraBoveda > cantidadBovedas || guardado.cantidadBovedas > cantidadBovedas - guardado.primeraBoveda) {
+            throw ConfiguracionInvalidaException("Instantánea inconsistente: bóvedas fuera de rango");
+        }
+        auto banco = std::make_unique<Banco>(std::string(cargada->getCadena(guardado.nombre)),
+                                             std::string(cargada->getCadena(guardado.codigo)));
+        for (std::uint32_t j = guardado.primeraBoveda; j < guardado.primeraBoveda + guardado.cantidadBovedas; ++j) {
+            const BovedaInstantanea& bovedaGuardada = cargada->getBoveda(j);
+            auto boveda = std::make_unique<Boveda>(std::string(cargada->getCadena(bovedaGuardada.id)),
+                                                   std::string(cargada->getCadena(bovedaGuardada.ubicacion)));
+            for (std::size_t k = 0; k < NUM_TIPOS_ACTIVO; ++k) {
+                Monto saldo = Monto::desdeCentesimas(bovedaGuardada.centesimas[k]);
+                if (saldo.esPositivo()) {
+                    boveda->agregarActivo(Activo(static_cast<TipoActivo>(k), saldo));
+                }
+            }
+            // El historial guardado se restaura antes de conectar el observador,
+            // que si no abriría la serie en la fecha de la instantánea
+            if (historial && seriesHistorial[j]) {
+                restaurarHistorial(*cargada, *seriesHistorial[j], *boveda);
+            }
+            banco->agregarBoveda(std::move(boveda));
+        }
+        
+        Banco* bancoAgregado = banco.get();
+        agregarBanco(std::move(banco));
+        HandleBanco handleBanco = registro.resolverBanco(bancoAgregado->getCodigo());
+        for (std::uint32_t j = guardado.primeraBoveda; j < guardado.primeraBoveda + guardado.cantidadBovedas; ++j) {
+            handles[j] = registro.resolverBoveda(handleBanco, std::string(cargada->getCadena(cargada->getBoveda(j).id)));
+        }
+    }
+    
+    // Las transacciones quedan en el archivo hasta que se consultan; abrir la
+    // instantánea no recorre la sección de transacciones
+    handlesInstantanea = std::move(handles);
+    primeraEnInstantanea = primera;
+    ultimaEnInstantanea = primera + cantidadTransacciones - 1;
+    primeraRetenida = primera;
+    materializadas = std::make_unique<std::atomic<Transaccion*>[]>(cantidadTransacciones);
+    contadorTransacciones = static_cast<int>(primera + cantidadTransacciones);
+    
+    // Las rezagadas y las transacciones en curso son pocas: se cargan y se indexan ya
+    for (std::size_t i = 0; i < cargada->getCantidadRezagadas(); ++i) {
+        std::size_t numero = static_cast<std::size_t>(cargada->getNumeroRezagada(i));
+        const TransaccionInstantanea& guardada = cargada->getRezagada(i);
+        if (numero == 0 || numero >= primera) {
+            throw ConfiguracionInvalidaException("Instantánea inconsistente: transacción rezagada " + std::to_string(numero));
+        }
+        TransaccionRezagada rezagada;
+        rezagada.transaccion = crearDesdeInstantanea(*cargada, guardada, formatearIdTransaccion(numero),
+            [](auto&&... datos) { return std::make_unique<Transaccion>(datos...); });
+        HandleBoveda origen = handlesInstantanea[guardada.bovedaOrigen];
+        HandleBoveda destino = handlesInstantanea[guardada.bovedaDestino];
+        rezagada.entrada = {rezagada.transaccion.get(), numero, origen, destino,
+                            registro.getBoveda(origen), registro.getBoveda(destino)};
+        rezagadas.emplace(numero, std::move(rezagada));
+    }
+    std::array<std::size_t, NUM_ESTADOS_TRANSACCION> conteo{};
+    std::size_t totalConteo = 0;
+    for (std::size_t estado = 0; estado < NUM_ESTADOS_TRANSACCION; ++estado) {
+        conteo[estado] = static_cast<std::size_t>(cargada->getTransaccionesEnEstado(estado));
+        totalConteo += conteo[estado];
+    }
+    if (totalConteo != getCantidadTransacciones()) {
+        throw ConfiguracionInvalidaException("Instantánea inconsistente: conteo por estado inválido");
+    }
+    indices.setConteo(conteo);
+    for (std::size_t i = 0; i < cargada->getCantidadActivas(); ++i) {
+        std::size_t numero = static_cast<std::size_t>(cargada->getActiva(i));
+        if (numero == 0 || numero > ultimaEnInstantanea ||
+            (numero < primera && rezagadas.find(numero) == rezagadas.end())) {
+            throw ConfiguracionInvalidaException("Instantánea inconsistente: transacción activa " + std::to_string(numero));
+        }
+        if (numero < primera) {
+            const TransaccionRezagada& rezagada = rezagadas.at(numero);
+            indices.indexar(claveDe(rezagada.entrada), rezagada.transaccion->getEstado());
+            continue;
+        }
+        // Se indexa desde el registro, sin materializar la transacción
+        const TransaccionInstantanea& guardada = cargada->getTransaccion(numero - primera);
+        if (guardada.bovedaOrigen >= handlesInstantanea.size() || guardada.bovedaDestino >= handlesInstantanea.size() ||
+            guardada.estado >= NUM_ESTADOS_EN_CURSO) {
+            throw ConfiguracionInvalidaException("Instantánea inconsistente: transacción activa " + std::to_string(numero));
+        }
+        HandleBoveda origen = handlesInstantanea[guardada.bovedaOrigen];
+        HandleBoveda destino = handlesInstantanea[guardada.bovedaDestino];
+        ClaveIndice clave{numero, origen, destino, registro.getBancoDeBoveda(origen), registro.getBancoDeBoveda(destino),
+                          cargada->getCadena(guardada.transportadora)};
+        indices.indexar(clave, static_cast<EstadoTransaccion>(guardada.estado));
+    }
+}
+
+void SistemaBovedas::guardarInstantanea(const std::string& ruta) {
+    EscritorInstantanea escritor;
+    
+    // Posición en el archivo de cada HandleBoveda
+    std::vector<std::uint32_t> posiciones(registro.getCantidadBovedas());
+    std::uint32_t cantidadBancos = 0;
+    std::uint32_t cantidadBovedas = 0;
+    for (const auto& [codigo, banco] : bancos) {
+        HandleBanco handleBanco = registro.resolverBanco(codigo);
+        BancoInstantanea guardado{};
+        guardado.nombre = escritor.agregarCadena(banco->getNombre());
+        guardado.codigo = escritor.agregarCadena(codigo);
+        guardado.primeraBoveda = cantidadBovedas;
+        guardado.cantidadBovedas = static_cast<std::uint32_t>(banco->getBovedas().size());
+        
+        for (const auto& boveda : banco->getBovedas()) {
+            BovedaInstantanea bovedaGuardada{};
+            bovedaGuardada.id = escritor.agregarCadena(boveda->getId());
+            bovedaGuardada.ubicacion = escritor.agregarCadena(boveda->getUbicacion());
+            bovedaGuardada.banco = cantidadBancos;
+            SaldosBoveda saldos = boveda->getCopiaActivos();
+            for (std::size_t k = 0; k < NUM_TIPOS_ACTIVO; ++k) {
+                bovedaGuardada.centesimas[k] = saldos[k].getCentesimas();
+            }
+            
+            HandleBoveda handle = registro.resolverBoveda(handleBanco, boveda->getId());
+            if (handle >= posiciones.size()) {
+                posiciones.resize(handle + 1);
+            }
+            posiciones[handle] = escritor.agregarBoveda(bovedaGuardada);
+            ++cantidadBovedas;
+            
+            HistorialSaldos::SerieGuardada serie;
+            if (historial && historial->exportarSerie(boveda.get(), serie)) {
+                SerieHistorialInstantanea serieGuardada{};
+                serieGuardada.boveda = posiciones[handle];
+                serieGuardada.inicio = serie.inicio;
+                for (std::size_t k = 0; k < NUM_TIPOS_ACTIVO; ++k) {
+                    serieGuardada.centesimas[k] = serie.saldos[k].getCentesimas();
+                }
+                std::vector<EventoHistorialInstantanea> eventos(serie.eventos.size());
+                for (std::size_t k = 0; k < serie.eventos.size(); ++k) {
+                    eventos[k].instante = serie.eventos[k].instante;
+                    eventos[k].delta = serie.eventos[k].delta;
+                    eventos[k].tipoActivo = static_cast<std::uint8_t>(serie.eventos[k].tipo);
+                }
+                escritor.agregarSerieHistorial(serieGuardada, eventos);
+            }
+        }
+        escritor.agregarBanco(guardado);
+        ++cantidadBancos;
+    }
+    
+    // Las transacciones que nunca se consultaron se copian de la instantánea
+    // anterior sin materializarlas; las archivadas no se guardan
+    std::size_t total = getCantidadTransacciones();
+    escritor.setPrimeraTransaccion(primeraRetenida);
+    escritor.reservarTransacciones(total + 1 - primeraRetenida);
+    for (std::size_t i = primeraRetenida; i <= total; ++i) {
+        if (i > ultimaEnInstantanea) {
+            const EntradaTransaccion& entrada = indiceTransacciones[i - ultimaEnInstantanea];
+            escritor.agregarTransaccion(guardarTransaccion(escritor, *entrada.transaccion,
+                                                           posiciones[entrada.origen], posiciones[entrada.destino]));
+            continue;
+        }
+        
+        const TransaccionInstantanea& anterior = instantanea->getTransaccion(i - primeraEnInstantanea);
+        std::uint32_t bovedaOrigen = posiciones[handlesInstantanea.at(anterior.bovedaOrigen)];
+        std::uint32_t bovedaDestino = posiciones[handlesInstantanea.at(anterior.bovedaDestino)];
+        Transaccion* transaccion = materializadas[i - primeraEnInstantanea].load(std::memory_order_acquire);
+        if (transaccion) {
+            escritor.agregarTransaccion(guardarTransaccion(escritor, *transaccion, bovedaOrigen, bovedaDestino));
+            continue;
+        }
+        TransaccionInstantanea guardada = anterior;
+        guardada.bovedaOrigen = bovedaOrigen;
+        guardada.bovedaDestino = bovedaDestino;
+        guardada.transportadora = escritor.agregarCadena(instantanea->getCadena(anterior.transportadora));
+        guardada.observaciones = escritor.agregarCadena(instantanea->getCadena(anterior.observaciones));
+        escritor.agregarTransaccion(guardada);
+    }
+    
+    for (const auto& [numero, rezagada] : rezagadas) {
+        escritor.agregarRezagada(numero, guardarTransaccion(escritor, *rezagada.transaccion,
+                                                            posiciones[rezagada.entrada.origen],
+                                                            posiciones[rezagada.entrada.destino]));
+    }
+    for (std::size_t numero : indices.getEnCurso()) {
+        escritor.agregarActiva(numero);
+    }
+    auto conteo = indices.getConteo();
+    for (std::size_t estado = 0; estado < NUM_ESTADOS_TRANSACCION; ++estado) {
+        escritor.setTransaccionesEnEstado(estado, conteo[estado]);
+    }
+    
+    escritor.setContadorTransacciones(static_cast<std::uint64_t>(contadorTransacciones));
+    escritor.setRegistrosDiario(diario ? diario->getUltimoLsn() : instantanea ? instantanea->getRegistrosDiario() : 0);
+    escritor.escribir(ruta);
+    // Con la instantánea ya en disco lo anterior del diario sobra
+    if (diario) {
+        diario->rotar();
+    }
+}
+
+const Instantanea* SistemaBovedas::getInstantanea() const {
+    return instantanea.get();
+}
+
+TransaccionInstantanea SistemaBovedas::guardarTransaccion(EscritorInstantanea& escritor, const Transaccion& transaccion,
+                                                          std::uint32_t bovedaOrigen, std::uint32_t bovedaDestino) {
+    TransaccionInstantanea guardada{};
+    Activo activo = transaccion.getActivo();
+    guardada.bovedaOrigen = bovedaOrigen;
+    guardada.bovedaDestino = bovedaDestino;
+    guardada.centesimas = activo.getMonto().getCentesimas();
+    guardada.tipoActivo = static_cast<std::uint8_t>(activo.getTipo());
+    guardada.porcentajeComision = transaccion.getPorcentajeComision();
+    guardada.tasaADolares = transaccion.getTasaADolares();
+    guardada.fechaCreacion = Instantanea::desdeFecha(transaccion.getFechaCreacion());
+    guardada.fechaCompletada = Instantanea::desdeFecha(transaccion.getFechaCompletada());
+    guardada.transportadora = escritor.agregarCadena(transaccion.getTransportadora());
+    guardada.observaciones = escritor.agregarCadena(transaccion.getObservaciones());
+    guardada.estado = static_cast<std::uint8_t>(transaccion.getEstado());
+    return guardada;
+}
+
+void SistemaBovedas::habilitarArchivo(const std::string& ruta, std::size_t ventana) {
+    if (archivo) {
+        throw OperacionInvalidaException("El archivo de transacciones ya está habilitado");
+    }
+    if (ventana == 0) {
+        throw DatosInvalidosException("La ventana del archivo debe conservar al menos una transacción");
+    }
+    archivo = std::make_unique<ArchivoTransacciones>(ruta);
+    ventanaArchivo = ventana;
+}
+
+std::size_t SistemaBovedas::archivarTerminadas() {
+    if (!archivo) {
+        throw OperacionInvalidaException("El archivo de transacciones no está habilitado");
+    }
+    std::size_t total = getCantidadTransacciones();
+    std::size_t nuevaBase = total >= ventanaArchivo ? total - ventanaArchivo + 1 : 1;
+    nuevaBase = std::max(nuevaBase, primeraRetenida);
+    std::size_t archivadas = 0;
+    
+    // Nada se suelta de memoria hasta que el archivo confirma lo escrito; si
+    // la pasada falla, la siguiente vuelve a agregar lo mismo sin duplicar
+    std::vector<std::size_t> rezagadasTerminadas;
+    for (const auto& [numero, rezagada] : rezagadas) {
+        if (estaTerminada(rezagada.transaccion->getEstado())) {
+            archivadas += archivo->agregar(archivadaDe(rezagada.entrada)) ? 1 : 0;
+            rezagadasTerminadas.push_back(numero);
+        }
+    }
+    
+    std::vector<std::pair<std::size_t, TransaccionRezagada>> nuevasRezagadas;
+    for (std::size_t numero = primeraRetenida; numero < nuevaBase; ++numero) {
+        // Las que nunca se consultaron se archivan directo desde la instantánea
+        if (numero <= ultimaEnInstantanea) {
+            std::size_t posicion = numero - primeraEnInstantanea;
+            const TransaccionInstantanea& guardada = instantanea->getTransaccion(posicion);
+            if (!materializadas[posicion].load(std::memory_order_acquire) &&
+                guardada.estado < NUM_ESTADOS_TRANSACCION &&
+                estaTerminada(static_cast<EstadoTransaccion>(guardada.estado))) {
+                archivadas += archivo->agregar(archivadaDeInstantanea(numero, guardada)) ? 1 : 0;
+                continue;
+            }
+        }
+        EntradaTransaccion entrada = entradaEn(numero);
+        if (estaTerminada(entrada.transaccion->getEstado())) {
+            archivadas += archivo->agregar(archivadaDe(entrada)) ? 1 : 0;
+            continue;
+        }
+        // Sigue activa: se copia fuera del bloque que se va a liberar
+        TransaccionRezagada rezagada{copiarTransaccion(*entrada.transaccion), entrada};
+        rezagada.entrada.transaccion = rezagada.transaccion.get();
+        nuevasRezagadas.emplace_back(numero, std::move(rezagada));
+    }
+    archivo->sincronizar();
+    
+    for (std::size_t numero : rezagadasTerminadas) {
+        rezagadas.erase(numero);
+    }
+    for (auto& [numero, rezagada] : nuevasRezagadas) {
+        rezagadas.emplace(numero, std::move(rezagada));
+    }
+    primeraRetenida = nuevaBase;
+    
+    // Se devuelve la memoria de los bloques que quedaron enteros por debajo de la ventana
+    if (primeraRetenida > ultimaEnInstantanea) {
+        std::size_t posicion = primeraRetenida - ultimaEnInstantanea;
+        indiceTransacciones.liberarHasta(posicion);
+        transacciones.liberarHasta(posicion - 1);
+        // La instantánea ya no aporta transacciones: sus materializadas sobran
+        materializadas.reset();
+        transaccionesMaterializadas.reset();
+    }
+    return archivadas;
+}
+
+const ArchivoTransacciones* SistemaBovedas::getArchivo() const {
+    return archivo.get();
+}
+
+TransaccionArchivada SistemaBovedas::archivadaDe(const EntradaTransaccion& entrada) {
+    const Transaccion& transaccion = *entrada.transaccion;
+    Activo activo = transaccion.getActivo();
+    TransaccionArchivada archivada;
+    archivada.numero = entrada.numero;
+    archivada.bancoOrigenCodigo = transaccion.getBancoOrigenCodigo();
+    archivada.bovedaOrigenId = transaccion.getBovedaOrigenId();
+    archivada.bancoDestinoCodigo = transaccion.getBancoDestinoCodigo();
+    archivada.bovedaDestinoId = transaccion.getBovedaDestinoId();
+    archivada.transportadora = transaccion.getTransportadora();
+    archivada.observaciones = transaccion.getObservaciones();
+    archivada.tipoActivo = activo.getTipo();
+    archivada.centesimas = activo.getMonto().getCentesimas();
+    archivada.porcentajeComision = transaccion.getPorcentajeComision();
+    archivada.tasaADolares = transaccion.getTasaADolares();
+    archivada.fechaCreacion = Instantanea::desdeFecha(transaccion.getFechaCreacion());
+    archivada.fechaCompletada = Instantanea::desdeFecha(transaccion.getFechaCompletada());
+    archivada.estado = transaccion.getEstado();
+    return archivada;
+}
+
+TransaccionArchivada SistemaBovedas::archivadaDeInstantanea(std::size_t numero, const TransaccionInstantanea& guardada) const {
+    if (guardada.bovedaOrigen >= instantanea->getCantidadBovedas() ||
+        guardada.bovedaDestino >= instantanea->getCantidadBovedas() ||
+        guardada.tipoActivo >= NUM_TIPOS_ACTIVO) {
+        throw ConfiguracionInvalidaException("Instantánea inconsistente: transacción " + formatearIdTransaccion(numero));
+    }
+    const BovedaInstantanea& origen = instantanea->getBoveda(guardada.bovedaOrigen);
+    const BovedaInstantanea& destino = instantanea->getBoveda(guardada.bovedaDestino);
+    TransaccionArchivada archivada;
+    archivada.numero = numero;
+    archivada.bancoOrigenCodigo = instantanea->getCadena(instantanea->getBanco(origen.banco).codigo);
+    archivada.bovedaOrigenId = instantanea->getCadena(origen.id);
+    archivada.bancoDestinoCodigo = instantanea->getCadena(instantanea->getBanco(destino.banco).codigo);
+    archivada.bovedaDestinoId = instantanea->getCadena(destino.id);
+    archivada.transportadora = instantanea->getCadena(guardada.transportadora);
+    archivada.observaciones = instantanea->getCadena(guardada.observaciones);
+    archivada.tipoActivo = static_cast<TipoActivo>(guardada.tipoActivo);
+    archivada.centesimas = guardada.centesimas;
+    archivada.porcentajeComision = guardada.porcentajeComision;
+    archivada.tasaADolares = guardada.tasaADolares;
+    archivada.fechaCreacion = guardada.fechaCreacion;
+    archivada.fechaCompletada = guardada.fechaCompletada;
+    archivada.estado = static_cast<EstadoTransaccion>(guardada.estado);
+    return archivada;
+}
+
+bool SistemaBovedas::almacenCubreTodasLasBovedas() const {
+    if (!almacen) {
+        return false;
+    }
+    std::size_t totalBovedas = 0;
+    for (const auto& [codigo, banco] : bancos) {
+        totalBovedas += banco->getBovedas().size();
+    }
+    return totalBovedas == almacen->getCantidadBovedas();
+}
+
 std::string SistemaBovedas::iniciarTransferencia(const std::string& bancoOrigenCodigo,
                                                const std::string& bovedaOrigenId,
                                                const std::string& bancoDestinoCodigo,
@@ -109,142 +882,694 @@ std::string SistemaBovedas::iniciarTransferencia(const std::string& bancoOrigenC
                                                double cantidad,
                                                const std::string& transportadora,
                                                double porcentajeComision) {
+    return intentarIniciarTransferencia(bancoOrigenCodigo, bovedaOrigenId, bancoDestinoCodigo, bovedaDestinoId,
+                                        tipoActivo, cantidad, transportadora, porcentajeComision).valor();
+}
+
+Resultado<std::string> SistemaBovedas::intentarIniciarTransferencia(const std::string& bancoOrigenCodigo,
+                                                                   const std::string& bovedaOrigenId,
+                                                                   const std::string& bancoDestinoCodigo,
+                                                                   const std::string& bovedaDestinoId,
+                                                                   TipoActivo tipoActivo,
+                                                                   double cantidad,
+                                                                   const std::string& transportadora,
+                                                                   double porcentajeComision) {
+    return metricas.medir(OperacionMetrica::INICIAR, [&] {
+        return iniciarTransferenciaSinMedir(bancoOrigenCodigo, bovedaOrigenId, bancoDestinoCodigo, bovedaDestinoId,
+                                            tipoActivo, cantidad, transportadora, porcentajeComision);
+    });
+}
+
+Resultado<std::string> SistemaBovedas::iniciarTransferenciaSinMedir(const std::string& bancoOrigenCodigo,
+                                                                    const std::string& bovedaOrigenId,
+                                                                    const std::string& bancoDestinoCodigo,
+                                                                    const std::string& bovedaDestinoId,
+                                                                    TipoActivo tipoActivo,
+                                                                    double cantidad,
+                                                                    const std::string& transportadora,
+                                                                    double porcentajeComision) {
+    Resultado<Activo> activoValidado = validarSolicitud(bancoOrigenCodigo, bovedaOrigenId, bancoDestinoCodigo,
+                                                        bovedaDestinoId, tipoActivo, cantidad, transportadora,
+                                                        porcentajeComision);
+    if (!activoValidado) {
+        return activoValidado.getError();
+    }
+    const Activo& activo = activoValidado.valor();
+    auto validacion = validarTransferencia(bancoOrigenCodigo, bovedaOrigenId,
+                                           bancoDestinoCodigo, bovedaDestinoId, activo);
+    if (!validacion) {
+        return validacion.getError();
+    }
+    auto [origen, destino] = validacion.valor();
     
-    Activo activo(tipoActivo, cantidad);
-    validarTransferencia(bancoOrigenCodigo, bovedaOrigenId, bancoDestinoCodigo, bovedaDestinoId, activo);
+    TransaccionNueva nueva{bancoOrigenCodigo, bovedaOrigenId, bancoDestinoCodigo, bovedaDestinoId,
+                           activo, transportadora, porcentajeComision, origen, destino};
+    std::size_t numero = 0;
+    std::uint64_t lsn = 0;
+    {
+        std::lock_guard<std::mutex> bloqueo(mutexCreacion);
+        numero = crearTransaccionesSinBloqueo(&nueva, 1);
+        lsn = lsnActual();
+    }
+    esperarDiario(lsn);
+    return formatearIdTransaccion(numero);
+}
+
+std::vector<ResultadoTransferencia> SistemaBovedas::iniciarTransferenciasLote(const std::vector<SolicitudTransferencia>& solicitudes,
+                                                                             ModoLote modo) {
+    struct Validada {
+        std::size_t indice;
+        Activo activo;
+        HandleBoveda origen;
+        HandleBoveda destino;
+    };
     
-    std::string transaccionId = generarIdTransaccion();
-    auto transaccion = std::make_unique<Transaccion>(
-        transaccionId, bancoOrigenCodigo, bovedaOrigenId,
-        bancoDestinoCodigo, bovedaDestinoId, activo, transportadora, porcentajeComision
-    );
+    std::vector<ResultadoTransferencia> resultados(solicitudes.size(), ResultadoTransferencia{false, "", ""});
+    std::vector<Validada> validadas;
+    validadas.reserve(solicitudes.size());
     
-    transacciones.push_back(std::move(transaccion));
-    return transaccionId;
+    // Cada banco y cada bóveda distinta se resuelve una sola vez en todo el lote
+    std::unordered_map<std::string, HandleBanco> bancosResueltos;
+    std::unordered_map<HandleBanco, std::unordered_map<std::string, HandleBoveda>> bovedasResueltas;
+    auto resolver = [&](const std::string& codigoBanco, const std::string& idBoveda) -> Resultado<HandleBoveda> {
+        auto itBanco = bancosResueltos.find(codigoBanco);
+        if (itBanco == bancosResueltos.end()) {
+            Resultado<HandleBanco> banco = registro.intentarResolverBanco(codigoBanco);
+            if (!banco) {
+                return banco.getError();
+            }
+            itBanco = bancosResueltos.emplace(codigoBanco, banco.valor()).first;
+        }
+        auto& bovedasDelBanco = bovedasResueltas[itBanco->second];
+        auto itBoveda = bovedasDelBanco.find(idBoveda);
+        if (itBoveda == bovedasDelBanco.end()) {
+            Resultado<HandleBoveda> boveda = registro.intentarResolverBoveda(itBanco->second, idBoveda);
+            if (!boveda) {
+                return boveda.getError();
+            }
+            itBoveda = bovedasDelBanco.emplace(idBoveda, boveda.valor()).first;
+        }
+        return itBoveda->second;
+    };
+    
+    // Salidas ya comprometidas por el lote, por bóveda de origen, y su saldo leído una vez
+    std::unordered_map<HandleBoveda, std::pair<SaldosBoveda, SaldosBoveda>> salidas;
+    bool huboErrores = false;
+    
+    // Los rechazos no lanzan: un lote con muchas solicitudes inválidas no paga
+    // un desenrollado de pila por cada una
+    auto validar = [&](const SolicitudTransferencia& solicitud, std::size_t i) -> Resultado<void> {
+        Resultado<Activo> activoValidado = validarSolicitud(solicitud.bancoOrigenCodigo, solicitud.bovedaOrigenId,
+                                                            solicitud.bancoDestinoCodigo, solicitud.bovedaDestinoId,
+                                                            solicitud.tipoActivo, solicitud.cantidad,
+                                                            solicitud.transportadora, solicitud.porcentajeComision);
+        if (!activoValidado) {
+            return activoValidado.getError();
+        }
+        const Activo& activo = activoValidado.valor();
+        
+        Resultado<HandleBoveda> origen = resolver(solicitud.bancoOrigenCodigo, solicitud.bovedaOrigenId);
+        if (!origen) {
+            return origen.getError();
+        }
+        Resultado<HandleBoveda> destino = resolver(solicitud.bancoDestinoCodigo, solicitud.bovedaDestinoId);
+        if (!destino) {
+            return destino.getError();
+        }
+        
+        auto itSalida = salidas.find(origen.valor());
+        if (itSalida == salidas.end()) {
+            itSalida = salidas.emplace(origen.valor(), std::make_pair(registro.getBoveda(origen.valor())->getCopiaActivos(),
+                                                                      SaldosBoveda{})).first;
+        }
+        std::size_t tipo = Activo::indice(activo.getTipo());
+        const Monto saldo = itSalida->second.first[tipo];
+        Monto& comprometido = itSalida->second.second[tipo];
+        if (saldo - comprometido < activo.getMonto()) {
+            return ErrorBoveda(CodigoError::SALDO_INSUFICIENTE,
+                               "La bóveda de origen no tiene suficientes activos para las transferencias del lote");
+        }
+        comprometido += activo.getMonto();
+        
+        validadas.push_back({i, activo, origen.valor(), destino.valor()});
+        return {};
+    };
+    
+    for (std::size_t i = 0; i < solicitudes.size(); ++i) {
+        Resultado<void> validacion = validar(solicitudes[i], i);
+        if (!validacion) {
+            resultados[i].error = validacion.getError().getMensaje();
+            huboErrores = true;
+        }
+    }
+    
+    if (huboErrores && modo == ModoLote::TODO_O_NADA) {
+        for (auto& resultado : resultados) {
+            if (resultado.error.empty()) {
+                resultado.error = "Lote rechazado: otra solicitud del lote no es válida";
+            }
+        }
+        return resultados;
+    }
+    
+    if (validadas.empty()) {
+        return resultados;
+    }
+    std::vector<TransaccionNueva> nuevas;
+    nuevas.reserve(validadas.size());
+    for (const Validada& v : validadas) {
+        const SolicitudTransferencia& solicitud = solicitudes[v.indice];
+        nuevas.push_back({solicitud.bancoOrigenCodigo, solicitud.bovedaOrigenId,
+                          solicitud.bancoDestinoCodigo, solicitud.bovedaDestinoId,
+                          v.activo, solicitud.transportadora, solicitud.porcentajeComision, v.origen, v.destino});
+    }
+    
+    // Una sola toma del mutex de creación, un solo registro y una sola espera
+    // del diario para todo el lote; si la creación lanza no queda ninguna
+    std::size_t primero = 0;
+    std::uint64_t lsn = 0;
+    {
+        std::lock_guard<std::mutex> bloqueo(mutexCreacion);
+        primero = crearTransaccionesSinBloqueo(nuevas.data(), nuevas.size());
+        lsn = lsnActual();
+    }
+    for (std::size_t k = 0; k < validadas.size(); ++k) {
+        resultados[validadas[k].indice].transaccionId = formatearIdTransaccion(primero + k);
+        resultados[validadas[k].indice].exito = true;
+    }
+    esperarDiario(lsn);
+    return resultados;
 }
 
-void SistemaBovedas::procesarTransaccion(const std::string& transaccionId) {
-    Transaccion* transaccion = buscarTransaccion(transaccionId);
+std::size_t SistemaBovedas::crearTransaccionesSinBloqueo(const TransaccionNueva* nuevas, std::size_t cantidad) {
+    const std::size_t primero = static_cast<std::size_t>(contadorTransacciones);
+    const std::size_t posicionArena = transacciones.size();
+    std::vector<EntradaTransaccion> entradas;
+    entradas.reserve(cantidad);
     
-    if (transaccion->estaCompletada()) {
-        throw OperacionInvalidaException("La transacción ya está completada");
+    // Todo lo que puede fallar va antes de que la transacción sea visible
+    try {
+        for (std::size_t k = 0; k < cantidad; ++k) {
+            const TransaccionNueva& nueva = nuevas[k];
+            Transaccion* transaccion = transacciones.crear(
+                formatearIdTransaccion(primero + k), nueva.bancoOrigenCodigo, nueva.bovedaOrigenId,
+                nueva.bancoDestinoCodigo, nueva.bovedaDestinoId, nueva.activo, nueva.transportadora,
+                nueva.porcentajeComision);
+            if (nueva.tasaADolares != 0.0) {
+                transaccion->restaurarTasaADolares(nueva.tasaADolares);
+            }
+            entradas.push_back({transaccion, primero + k, nueva.origen, nueva.destino,
+                                registro.getBoveda(nueva.origen), registro.getBoveda(nueva.destino)});
+        }
+        indiceTransacciones.reservar(cantidad);
+        
+        // Bajo mutexCreacion: el orden de las altas en el diario es el de los números.
+        // El registro va antes de publicarlas, así que ningún avance de estas
+        // transacciones puede quedar en el diario antes que su alta.
+        if (diario) {
+            RegistroDiario lote;
+            lote.tipo = TipoRegistroDiario::LOTE;
+            lote.lote.resize(cantidad);
+            for (std::size_t k = 0; k < cantidad; ++k) {
+                const TransaccionNueva& nueva = nuevas[k];
+                RegistroDiario& iniciar = lote.lote[k];
+                iniciar.tipo = TipoRegistroDiario::INICIAR;
+                iniciar.numeroTransaccion = primero + k;
+                iniciar.bancoOrigenCodigo = nueva.bancoOrigenCodigo;
+                iniciar.bovedaOrigenId = nueva.bovedaOrigenId;
+                iniciar.bancoDestinoCodigo = nueva.bancoDestinoCodigo;
+                iniciar.bovedaDestinoId = nueva.bovedaDestinoId;
+                iniciar.transportadora = nueva.transportadora;
+                iniciar.porcentajeComision = nueva.porcentajeComision;
+                iniciar.tasaADolares = entradas[k].transaccion->getTasaADolares();
+                iniciar.tipoActivo = nueva.activo.getTipo();
+                iniciar.centesimas = nueva.activo.getMonto().getCentesimas();
+            }
+            diario->agregar(cantidad == 1 ? lote.lote.front() : lote);
+        }
+    } catch (...) {
+        transacciones.descartarDesde(posicionArena);
+        throw;
     }
     
-    if (transaccion->getEstado() == EstadoTransaccion::PREPARACION) {
-        // Retirar activos de la bóveda de origen
-        Banco* bancoOrigen = buscarBanco(transaccion->getBancoOrigenCodigo());
-        Boveda* bovedaOrigen = bancoOrigen->buscarBoveda(transaccion->getBovedaOrigenId());
-        bovedaOrigen->retirarActivo(transaccion->getActivo());
+    contadorTransacciones += static_cast<int>(cantidad);
+    for (const EntradaTransaccion& entrada : entradas) {
+        indiceTransacciones.agregar(entrada);
+        indices.agregar(claveDe(entrada), EstadoTransaccion::PREPARACION);
+        if (publicador) {
+            publicador->transaccionCreada(entrada.numero);
+        }
     }
-    
-    // Avanzar todos los estados hasta completar
-    while (!transaccion->estaCompletada() && transaccion->getEstado() != EstadoTransaccion::CANCELADA) {
-        transaccion->avanzarEstado();
+    return primero;
+}
+
+void SistemaBovedas::procesarTransaccion(const std::string& transaccionId) {
+    intentarProcesarTransaccion(transaccionId).valor();
+}
+
+Resultado<void> SistemaBovedas::intentarProcesarTransaccion(const std::string& transaccionId) {
+    return metricas.medir(OperacionMetrica::PROCESAR, [&] { return procesarTransaccionSinMedir(transaccionId); });
+}
+
+Resultado<void> SistemaBovedas::procesarTransaccionSinMedir(const std::string& transaccionId) {
+    Resultado<EntradaTransaccion> buscada = intentarBuscarEntrada(transaccionId);
+    if (!buscada) {
+        return buscada.getError();
+    }
+    const EntradaTransaccion& entrada = buscada.valor();
+    Transaccion* transaccion = entrada.transaccion;
+    std::uint64_t lsn = 0;
+    {
+        std::lock_guard<std::mutex> bloqueo(bloqueoDe(entrada));
         
         if (transaccion->estaCompletada()) {
-            // Agregar activos a la bóveda de destino (descontando comisión)
-            Banco* bancoDestino = buscarBanco(transaccion->getBancoDestinoCodigo());
-            Boveda* bovedaDestino = bancoDestino->buscarBoveda(transaccion->getBovedaDestinoId());
-            bovedaDestino->agregarActivo(transaccion->getActivoNeto());
+            return ErrorBoveda(CodigoError::OPERACION_INVALIDA, "La transacción ya está completada");
+        }
+        
+        // Avanzar todos los estados hasta completar
+        while (!transaccion->estaCompletada() && transaccion->getEstado() != EstadoTransaccion::CANCELADA) {
+            Resultado<void> avance = avanzarEtapaSinBloqueo(entrada);
+            if (!avance) {
+                return avance;
+            }
         }
+        lsn = lsnActual();
     }
+    esperarDiario(lsn);
+    return {};
 }
 
-void SistemaBovedas::avanzarEstadoTransaccion(const std::string& transaccionId) {
-    Transaccion* transaccion = buscarTransaccion(transaccionId);
+void SistemaBovedas::avanzarEtapaTransaccion(const std::string& transaccionId) {
+    intentarAvanzarEtapaTransaccion(transaccionId).valor();
+}
+
+Resultado<void> SistemaBovedas::intentarAvanzarEtapaTransaccion(const std::string& transaccionId) {
+    return metricas.medir(OperacionMetrica::AVANZAR, [&] { return avanzarEtapaSinMedir(transaccionId, nullptr); });
+}
+
+Resultado<void> SistemaBovedas::intentarAvanzarEtapaTransaccion(const std::string& transaccionId,
+                                                                EstadoTransaccion desde) {
+    return metricas.medir(OperacionMetrica::AVANZAR, [&] { return avanzarEtapaSinMedir(transaccionId, &desde); });
+}
+
+Resultado<void> SistemaBovedas::avanzarEtapaSinMedir(const std::string& transaccionId, const EstadoTransaccion* desde) {
+    Resultado<EntradaTransaccion> buscada = intentarBuscarEntrada(transaccionId);
+    if (!buscada) {
+        return buscada.getError();
+    }
+    const EntradaTransaccion& entrada = buscada.valor();
+    std::uint64_t lsn = 0;
+    {
+        std::lock_guard<std::mutex> bloqueo(bloqueoDe(entrada));
+        if (entrada.transaccion->estaCompletada()) {
+            return ErrorBoveda(CodigoError::OPERACION_INVALIDA, "La transacción ya está completada");
+        }
+        if (entrada.transaccion->getEstado() == EstadoTransaccion::CANCELADA) {
+            return ErrorBoveda(CodigoError::OPERACION_INVALIDA, "No se puede avanzar una transacción cancelada");
+        }
+        if (desde && entrada.transaccion->getEstado() != *desde) {
+            return ErrorBoveda::conMensaje(CodigoError::OPERACION_INVALIDA,
+                                           "La transacción ya no está en " + Transaccion::estadoToString(*desde));
+        }
+        Resultado<void> avance = avanzarEtapaSinBloqueo(entrada);
+        if (!avance) {
+            return avance;
+        }
+        lsn = lsnActual();
+    }
+    esperarDiario(lsn);
+    return {};
+}
+
+Resultado<void> SistemaBovedas::avanzarEtapaSinBloqueo(const EntradaTransaccion& entrada) {
+    Transaccion* transaccion = entrada.transaccion;
+    EstadoTransaccion anterior = transaccion->getEstado();
+    std::int64_t instante = instanteReaplicado != 0 ? instanteReaplicado : instanteActual();
+    PasoDeTransaccion paso(instante);
+    if (anterior == EstadoTransaccion::PREPARACION) {
+        // Retirar activos de la bóveda de origen
+        Resultado<void> retiro = entrada.bovedaOrigen->intentarRetirar(transaccion->getActivo());
+        if (!retiro) {
+            return retiro;
+        }
+    }
+    
+    // El registro va después del retiro y antes del abono: un retiro de otro
+    // hilo que use fondos abonados aquí siempre queda después en el diario
     transaccion->avanzarEstado();
+    RegistroDiario registroDiario = registroDeTransaccion(TipoRegistroDiario::AVANZAR, entrada);
+    registroDiario.instante = instante;
+    registrarEnDiario(registroDiario);
+    actualizarIndices(entrada, anterior);
+    
+    if (transaccion->estaCompletada()) {
+        // Agregar activos a la bóveda de destino (descontando comisión)
+        entrada.bovedaDestino->agregarActivo(transaccion->getActivoNeto());
+    }
+    return {};
+}
+
+void SistemaBovedas::avanzarEstadoTransaccion(const std::string& transaccionId) {
+    EntradaTransaccion entrada = buscarEntrada(transaccionId);
+    std::uint64_t lsn = 0;
+    {
+        std::lock_guard<std::mutex> bloqueo(bloqueoDe(entrada));
+        EstadoTransaccion anterior = entrada.transaccion->getEstado();
+        entrada.transaccion->avanzarEstado();
+        registrarEnDiario(registroDeTransaccion(TipoRegistroDiario::FORZAR_AVANCE, entrada));
+        actualizarIndices(entrada, anterior);
+        lsn = lsnActual();
+    }
+    esperarDiario(lsn);
 }
 
 void SistemaBovedas::cancelarTransaccion(const std::string& transaccionId, const std::string& razon) {
-    Transaccion* transaccion = buscarTransaccion(transaccionId);
+    metricas.medir(OperacionMetrica::CANCELAR, [&] { cancelarTransaccionSinMedir(transaccionId, razon); });
+}
+
+void SistemaBovedas::cancelarTransaccionSinMedir(const std::string& transaccionId, const std::string& razon) {
+    EntradaTransaccion entrada = buscarEntrada(transaccionId);
+    std::uint64_t lsn = 0;
+    {
+        std::lock_guard<std::mutex> bloqueo(bloqueoDe(entrada));
+        cancelarSinBloqueo(entrada, razon);
+        lsn = lsnActual();
+    }
+    esperarDiario(lsn);
+}
+
+void SistemaBovedas::cancelarSinBloqueo(const EntradaTransaccion& entrada, const std::string& razon) {
+    Transaccion* transaccion = entrada.transaccion;
+    EstadoTransaccion anterior = transaccion->getEstado();
+    if (anterior == EstadoTransaccion::COMPLETADA) {
+        throw OperacionInvalidaException("No se puede cancelar una transacción completada");
+    }
+    if (razon.size() > Diario::LONGITUD_MAXIMA_TEXTO) {
+        throw DatosInvalidosException("La razón de la cancelación es demasiado larga");
+    }
+    std::int64_t instante = instanteReaplicado != 0 ? instanteReaplicado : instanteActual();
+    PasoDeTransaccion paso(instante);
+    
+    // El registro va antes de la devolución, por la misma razón que en avanzarEtapaSinBloqueo
+    RegistroDiario registroDiario = registroDeTransaccion(TipoRegistroDiario::CANCELAR, entrada);
+    registroDiario.razon = razon;
+    registroDiario.instante = instante;
+    registrarEnDiario(registroDiario);
     
     // Si la transacción ya retiró activos, devolverlos
-    if (transaccion->getEstado() != EstadoTransaccion::PREPARACION && 
-        transaccion->getEstado() != EstadoTransaccion::CANCELADA &&
-        transaccion->getEstado() != EstadoTransaccion::COMPLETADA) {
-        
-        Banco* bancoOrigen = buscarBanco(transaccion->getBancoOrigenCodigo());
-        Boveda* bovedaOrigen = bancoOrigen->buscarBoveda(transaccion->getBovedaOrigenId());
-        bovedaOrigen->agregarActivo(transaccion->getActivo());
+    if (anterior != EstadoTransaccion::PREPARACION && anterior != EstadoTransaccion::CANCELADA) {
+        entrada.bovedaOrigen->agregarActivo(transaccion->getActivo());
     }
-    
     transaccion->cancelar(razon);
+    actualizarIndices(entrada, anterior);
 }
 
 Transaccion* SistemaBovedas::buscarTransaccion(const std::string& id) {
-    auto it = std::find_if(transacciones.begin(), transacciones.end(),
-                          [&id](const std::unique_ptr<Transaccion>& t) {
-                              return t->getId() == id;
-                          });
-    
-    if (it == transacciones.end()) {
-        throw OperacionInvalidaException("Transacción no encontrada: " + id);
+    return metricas.medir(OperacionMetrica::BUSCAR, [&] { return intentarBuscarEntrada(id); }).valor().transaccion;
+}
+
+std::unique_ptr<Transaccion> SistemaBovedas::buscarTransaccionArchivada(const std::string& id) const {
+    if (!archivo) {
+        throw OperacionInvalidaException("El archivo de transacciones no está habilitado");
+    }
+    std::size_t numero = 0;
+    TransaccionArchivada leida;
+    if (!extraerNumeroTransaccion(id, numero) || formatearIdTransaccion(numero) != id || !archivo->leer(numero, leida)) {
+        ErrorBoveda(CodigoError::TRANSACCION_NO_ENCONTRADA, id).lanzar();
+    }
+    auto transaccion = std::make_unique<Transaccion>(id, leida.bancoOrigenCodigo, leida.bovedaOrigenId,
+                                                     leida.bancoDestinoCodigo, leida.bovedaDestinoId,
+                                                     Activo(leida.tipoActivo, Monto::desdeCentesimas(leida.centesimas)),
+                                                     leida.transportadora, leida.porcentajeComision);
+    transaccion->restaurar(leida.estado, Instantanea::aFecha(leida.fechaCreacion),
+                           Instantanea::aFecha(leida.fechaCompletada), leida.observaciones);
+    transaccion->restaurarTasaADolares(leida.tasaADolares);
+    return transaccion;
+}
+
+SistemaBovedas::EntradaTransaccion SistemaBovedas::buscarEntrada(const std::string& id) const {
+    return intentarBuscarEntrada(id).valor();
+}
+
+Resultado<SistemaBovedas::EntradaTransaccion> SistemaBovedas::intentarBuscarEntrada(const std::string& id) const {
+    // Acceso directo por el número del ID; se compara el ID completo para
+    // rechazar variantes como "TXN-42" que apuntarían a la misma posición
+    std::size_t numero = 0;
+    if (extraerNumeroTransaccion(id, numero) && numero > 0 && numero <= getCantidadTransacciones()) {
+        if (numero < primeraRetenida && rezagadas.find(numero) == rezagadas.end()) {
+            if (formatearIdTransaccion(numero) == id) {
+                return ErrorBoveda(CodigoError::TRANSACCION_ARCHIVADA, id);
+            }
+        } else {
+            EntradaTransaccion entrada = entradaEn(numero);
+            if (entrada.transaccion->getId() == id) {
+                return entrada;
+            }
+        }
     }
     
-    return it->get();
+    return ErrorBoveda(CodigoError::TRANSACCION_NO_ENCONTRADA, id);
 }
 
-std::vector<Transaccion*> SistemaBovedas::getTransaccionesActivas() {
-    std::vector<Transaccion*> activas;
-    for (const auto& transaccion : transacciones) {
-        if (!transaccion->estaCompletada() && transaccion->getEstado() != EstadoTransaccion::CANCELADA) {
-            activas.push_back(transaccion.get());
+std::mutex& SistemaBovedas::bloqueoDe(const EntradaTransaccion& entrada) {
+    return bloqueosTransacciones[entrada.numero % NUM_BLOQUEOS_TRANSACCION].mutex;
+}
+
+ClaveIndice SistemaBovedas::claveDe(const EntradaTransaccion& entrada) const {
+    return {entrada.numero, entrada.origen, entrada.destino,
+            registro.getBancoDeBoveda(entrada.origen), registro.getBancoDeBoveda(entrada.destino),
+            entrada.transaccion->getTransportadora()};
+}
+
+void SistemaBovedas::actualizarIndices(const EntradaTransaccion& entrada, EstadoTransaccion anterior) {
+    EstadoTransaccion nuevo = entrada.transaccion->getEstado();
+    if (nuevo != anterior) {
+        indices.cambiarEstado(claveDe(entrada), anterior, nuevo);
+        if (publicador) {
+            publicador->estadoModificado(entrada.numero);
         }
     }
-    return activas;
+}
+
+bool SistemaBovedas::estaTerminada(EstadoTransaccion estado) {
+    return estado == EstadoTransaccion::COMPLETADA || estado == EstadoTransaccion::CANCELADA;
+}
+
+std::vector<Transaccion*> SistemaBovedas::transaccionesEnCurso(std::vector<std::size_t> numeros) const {
+    std::sort(numeros.begin(), numeros.end());
+    std::vector<Transaccion*> resultado;
+    resultado.reserve(numeros.size());
+    for (std::size_t numero : numeros) {
+        // Pudo terminar entre la copia del índice y la lectura
+        Transaccion* transaccion = transaccionEn(numero);
+        if (!estaTerminada(transaccion->getEstado())) {
+            resultado.push_back(transaccion);
+        }
+    }
+    return resultado;
+}
+
+std::vector<Transaccion*> SistemaBovedas::getTransaccionesActivas() {
+    return transaccionesEnCurso(indices.getEnCurso());
+}
+
+std::vector<Transaccion*> SistemaBovedas::getTransaccionesEnEstado(EstadoTransaccion estado) {
+    if (estaTerminada(estado)) {
+        throw OperacionInvalidaException("Solo se indexan las transacciones en curso; las terminadas se consultan por ID");
+    }
+    std::vector<Transaccion*> resultado = transaccionesEnCurso(indices.getEnEstado(estado));
+    // Las que avanzaron mientras tanto ya no están en ese estado
+    resultado.erase(std::remove_if(resultado.begin(), resultado.end(),
+                                   [estado](const Transaccion* t) { return t->getEstado() != estado; }),
+                    resultado.end());
+    return resultado;
+}
+
+std::vector<Transaccion*> SistemaBovedas::getTransaccionesEnCursoDeBoveda(const std::string& codigoBanco,
+                                                                        const std::string& idBoveda) {
+    return transaccionesEnCurso(indices.getDeBoveda(resolverBoveda(codigoBanco, idBoveda)));
+}
+
+std::vector<Transaccion*> SistemaBovedas::getTransaccionesEnCursoDeBanco(const std::string& codigoBanco) {
+    return transaccionesEnCurso(indices.getDeBanco(registro.resolverBanco(codigoBanco)));
+}
+
+std::vector<Transaccion*> SistemaBovedas::getTransaccionesEnCursoDeTransportadora(const std::string& transportadora) {
+    return transaccionesEnCurso(indices.getDeTransportadora(transportadora));
+}
+
+std::array<std::size_t, NUM_ESTADOS_TRANSACCION> SistemaBovedas::contarTransaccionesPorEstado() const {
+    return indices.getConteo();
+}
+
+template <typename Funcion>
+void SistemaBovedas::recorrerRetenidas(Funcion funcion) const {
+    std::vector<std::size_t> numerosRezagadas;
+    numerosRezagadas.reserve(rezagadas.size());
+    for (const auto& [numero, rezagada] : rezagadas) {
+        numerosRezagadas.push_back(numero);
+    }
+    std::sort(numerosRezagadas.begin(), numerosRezagadas.end());
+    for (std::size_t numero : numerosRezagadas) {
+        funcion(rezagadas.at(numero).transaccion.get());
+    }
+    
+    std::size_t total = getCantidadTransacciones();
+    for (std::size_t i = primeraRetenida; i <= total; ++i) {
+        funcion(transaccionEn(i));
+    }
 }
 
 std::vector<Transaccion*> SistemaBovedas::getTodasLasTransacciones() {
     std::vector<Transaccion*> todas;
-    for (const auto& transaccion : transacciones) {
-        todas.push_back(transaccion.get());
-    }
+    todas.reserve(rezagadas.size() + getCantidadTransacciones() + 1 - primeraRetenida);
+    recorrerRetenidas([&](Transaccion* transaccion) { todas.push_back(transaccion); });
     return todas;
 }
 
-std::string SistemaBovedas::getResumenGeneral() const {
-    std::stringstream ss;
-    ss << std::fixed << std::setprecision(2);
-    ss << "=== SISTEMA DE BÓVEDAS ===\n\n";
-    ss << "Bancos registrados: " << bancos.size() << "\n";
-    ss << "Transacciones totales: " << transacciones.size() << "\n\n";
-    
-    double valorTotal = 0.0;
+std::vector<Transaccion*> SistemaBovedas::getUltimasTransacciones(std::size_t cantidad) {
+    std::vector<Transaccion*> ultimas;
+    std::size_t total = getCantidadTransacciones();
+    for (std::size_t i = total; i >= primeraRetenida && ultimas.size() < cantidad; --i) {
+        ultimas.push_back(transaccionEn(i));
+    }
+    return ultimas;
+}
+
+std::size_t SistemaBovedas::getCantidadTransacciones() const {
+    // La posición 0 del índice está reservada
+    return ultimaEnInstantanea + indiceTransacciones.size() - 1;
+}
+
+ResumenMetricas SistemaBovedas::getMetricas() const {
+    return metricas.getResumen();
+}
+
+void SistemaBovedas::reiniciarMetricas() {
+    metricas.reiniciar();
+}
+
+const AcumuladorSaldos& SistemaBovedas::getTotales() const {
+    return totales;
+}
+
+bool SistemaBovedas::verificarTotales() const {
+    SaldosBoveda recalculado{};
     for (const auto& [codigo, banco] : bancos) {
-        valorTotal += banco->getActivosTotales();
+        for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+            TipoActivo tipo = static_cast<TipoActivo>(i);
+            Monto totalBanco = banco->recalcularTotalPorTipo(tipo);
+            if (totalBanco != banco->getTotalPorTipo(tipo)) {
+                return false;
+            }
+            recalculado[i] += totalBanco;
+        }
     }
-    ss << "Valor total en el sistema: $ " << valorTotal << "\n\n";
     
-    return ss.str();
+    if (almacenCubreTodasLasBovedas()) {
+        for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+            if (almacen->getTotalPorTipo(static_cast<TipoActivo>(i)) != recalculado[i]) {
+                return false;
+            }
+        }
+    }
+    
+    return recalculado == totales.getTotales();
+}
+
+std::string SistemaBovedas::getResumenGeneral() const {
+    return reporteEnTexto([this](EscritorReporte& escritor) { escribirResumenGeneral(escritor); });
 }
 
 std::string SistemaBovedas::getEstadoBancos() const {
-    std::stringstream ss;
+    return reporteEnTexto([this](EscritorReporte& escritor) { escribirEstadoBancos(escritor); });
+}
+
+std::string SistemaBovedas::getEstadoTransacciones() const {
+    return reporteEnTexto([this](EscritorReporte& escritor) { escribirEstadoTransacciones(escritor); });
+}
+
+void SistemaBovedas::escribirResumenGeneral(EscritorReporte& escritor) const {
+    escritor.resumen(bancos.size(), getCantidadTransacciones(), totales.getTotales());
+}
+
+void SistemaBovedas::escribirEstadoBancos(EscritorReporte& escritor) const {
     for (const auto& [codigo, banco] : bancos) {
-        ss << banco->getResumen() << "\n";
+        escritor.banco(*banco);
     }
-    return ss.str();
 }
 
-std::string SistemaBovedas::getEstadoTransacciones() const {
+void SistemaBovedas::escribirEstadoTransacciones(EscritorReporte& escritor) const {
+    escritor.inicioTransacciones(getCantidadTransacciones(), archivo != nullptr, archivo ? archivo->getCantidad() : 0);
+    recorrerRetenidas([&](const Transaccion* transaccion) { escritor.transaccion(*transaccion); });
+}
+
+void SistemaBovedas::escribirReporte(EscritorReporte& escritor) const {
+    escribirResumenGeneral(escritor);
+    escribirEstadoBancos(escritor);
+    escribirEstadoTransacciones(escritor);
+}
+
+std::string SistemaBovedas::formatearIdTransaccion(std::size_t numero) {
     std::stringstream ss;
-    ss << "=== TRANSACCIONES ===\n\n";
-    
-    for (const auto& transaccion : transacciones) {
-        ss << transaccion->getResumen() << "\n";
+    ss << "TXN-" << std::setfill('0') << std::setw(6) << numero;
+    return ss.str();
+}
+
+SistemaBovedas::EntradaTransaccion SistemaBovedas::entradaEn(std::size_t numero) const {
+    if (numero < primeraRetenida) {
+        return rezagadas.at(numero).entrada;
+    }
+    if (numero > ultimaEnInstantanea) {
+        return indiceTransacciones[numero - ultimaEnInstantanea];
+    }
+    Transaccion* transaccion = materializar(numero);
+    const TransaccionInstantanea& guardada = instantanea->getTransaccion(numero - primeraEnInstantanea);
+    HandleBoveda origen = handlesInstantanea[guardada.bovedaOrigen];
+    HandleBoveda destino = handlesInstantanea[guardada.bovedaDestino];
+    return {transaccion, numero, origen, destino, registro.getBoveda(origen), registro.getBoveda(destino)};
+}
+
+Transaccion* SistemaBovedas::transaccionEn(std::size_t numero) const {
+    if (numero < primeraRetenida) {
+        return rezagadas.at(numero).transaccion.get();
+    }
+    if (numero > ultimaEnInstantanea) {
+        return indiceTransacciones[numero - ultimaEnInstantanea].transaccion;
+    }
+    return materializar(numero);
+}
+
+Transaccion* SistemaBovedas::materializar(std::size_t numero) const {
+    std::atomic<Transaccion*>& ranura = materializadas[numero - primeraEnInstantanea];
+    Transaccion* transaccion = ranura.load(std::memory_order_acquire);
+    if (transaccion) {
+        return transaccion;
     }
     
-    if (transacciones.empty()) {
-        ss << "No hay transacciones registradas.\n";
+    std::lock_guard<std::mutex> bloqueo(mutexMaterializacion);
+    transaccion = ranura.load(std::memory_order_relaxed);
+    if (transaccion) {
+        return transaccion;
     }
     
-    return ss.str();
+    transaccion = crearDesdeInstantanea(*instantanea, instantanea->getTransaccion(numero - primeraEnInstantanea),
+                                        formatearIdTransaccion(numero),
+        [this](auto&&... datos) { return transaccionesMaterializadas->crear(datos...); });
+    ranura.store(transaccion, std::memory_order_release);
+    return transaccion;
 }
 
-std::string SistemaBovedas::generarIdTransaccion() {
-    std::stringstream ss;
-    ss << "TXN-" << std::setfill('0') << std::setw(6) << contadorTransacciones++;
-    return ss.str();
+bool SistemaBovedas::extraerNumeroTransaccion(const std::string& id, std::size_t& numero) {
+    const std::string prefijo = "TXN-";
+    if (id.size() <= prefijo.size() || id.compare(0, prefijo.size(), prefijo) != 0) {
+        return false;
+    }
+    
+    const char* inicio = id.data() + prefijo.size();
+    const char* fin = id.data() + id.size();
+    auto [ptr, ec] = std::from_chars(inicio, fin, numero);
+    return ec == std::errc() && ptr == fin;
 }
 
 double SistemaBovedas::generarCantidadAleatoria(double min, double max) {
@@ -252,26 +1577,36 @@ double SistemaBovedas::generarCantidadAleatoria(double min, double max) {
     return dist(generador);
 }
 
-void SistemaBovedas::validarTransferencia(const std::string& bancoOrigenCodigo,
-                                        const std::string& bovedaOrigenId,
-                                        const std::string& bancoDestinoCodigo,
-                                        const std::string& bovedaDestinoId,
-                                        const Activo& activo) {
-    
-    if (bancoOrigenCodigo == bancoDestinoCodigo && bovedaOrigenId == bovedaDestinoId) {
-        throw OperacionInvalidaException("La bóveda de origen no puede ser la misma que la de destino");
-    }
-    
+Resultado<std::pair<HandleBoveda, HandleBoveda>> SistemaBovedas::validarTransferencia(const std::string& bancoOrigenCodigo,
+                                                                                     const std::string& bovedaOrigenId,
+                                                                                     const std::string& bancoDestinoCodigo,
+                                                                                     const std::string& bovedaDestinoId,
+                                                                                     const Activo& activo) {
     // Verificar que los bancos existen
-    Banco* bancoOrigen = buscarBanco(bancoOrigenCodigo);
-    Banco* bancoDestino = buscarBanco(bancoDestinoCodigo);
+    Resultado<HandleBanco> bancoOrigen = registro.intentarResolverBanco(bancoOrigenCodigo);
+    if (!bancoOrigen) {
+        return bancoOrigen.getError();
+    }
+    Resultado<HandleBanco> bancoDestino = registro.intentarResolverBanco(bancoDestinoCodigo);
+    if (!bancoDestino) {
+        return bancoDestino.getError();
+    }
     
     // Verificar que las bóvedas existen
-    Boveda* bovedaOrigen = bancoOrigen->buscarBoveda(bovedaOrigenId);
-    Boveda* bovedaDestino = bancoDestino->buscarBoveda(bovedaDestinoId);
+    Resultado<HandleBoveda> origen = registro.intentarResolverBoveda(bancoOrigen.valor(), bovedaOrigenId);
+    if (!origen) {
+        return origen.getError();
+    }
+    Resultado<HandleBoveda> destino = registro.intentarResolverBoveda(bancoDestino.valor(), bovedaDestinoId);
+    if (!destino) {
+        return destino.getError();
+    }
     
     // Verificar que la bóveda de origen tiene suficientes activos
-    if (!bovedaOrigen->tieneActivo(activo)) {
-        throw SaldoInsuficienteException("La bóveda de origen no tiene suficientes activos para la transferencia");
+    if (!registro.getBoveda(origen.valor())->tieneActivo(activo)) {
+        return ErrorBoveda(CodigoError::SALDO_INSUFICIENTE,
+                           "La bóveda de origen no tiene suficientes activos para la transferencia");
     }
+    
+    return std::make_pair(origen.valor(), destino.valor());
 }
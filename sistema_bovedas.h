@@ -1,33 +1,241 @@
 #ifndef SISTEMA_BOVEDAS_H
 #define SISTEMA_BOVEDAS_H
 
+#include "almacen_saldos.h"
+#include "arena_transacciones.h"
+#include "archivo_transacciones.h"
 #include "banco.h"
+#include "diario.h"
+#include "generador_topologia.h"
+#include "historial_saldos.h"
+#include "indices_transacciones.h"
+#include "instantanea.h"
+#include "metricas.h"
+#include "publicador_cambios.h"
+#include "registro_bovedas.h"
+#include "reporte.h"
 #include "transaccion.h"
+#include "vector_segmentado.h"
+#include <array>
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <vector>
 #include <memory>
 #include <random>
+#include <string_view>
+#include <unordered_map>
 
-class SistemaBovedas {
+// Una transferencia dentro de un lote (ver iniciarTransferenciasLote)
+struct SolicitudTransferencia {
+    std::string bancoOrigenCodigo;
+    std::string bovedaOrigenId;
+    std::string bancoDestinoCodigo;
+    std::string bovedaDestinoId;
+    TipoActivo tipoActivo;
+    double cantidad;
+    std::string transportadora = "Transportes Seguros SA";
+    double porcentajeComision = 0.05;
+};
+
+// Resultado de cada solicitud del lote, en el mismo orden
+struct ResultadoTransferencia {
+    bool exito;
+    std::string transaccionId; // Vacío si no se creó
+    std::string error;         // Vacío si tuvo éxito
+};
+
+enum class ModoLote {
+    TODO_O_NADA,  // Si una solicitud falla no se crea ninguna transacción
+    POR_ELEMENTO  // Se crean las válidas y se reportan las que fallan
+};
+
+// Concurrencia: las operaciones de transferencia (iniciar, procesar, avanzar,
+// cancelar) y las consultas de transacciones pueden llamarse desde varios
+// hilos. Cada transacción se protege con un mutex de un conjunto fijo
+// (por número de transacción) y cada bóveda con el suyo; el orden global es
+// siempre transacción -> bóvedas (por dirección), así que no hay
+// interbloqueos. Los cambios de estructura (agregar bancos o bóvedas,
+// habilitar el almacén columnar, inicializar) no deben correr en paralelo
+// con otras operaciones.
+//
+// Durabilidad: con el diario habilitado cada operación se registra antes de
+// soltar sus bloqueos y la llamada no retorna hasta que su registro está en
+// disco. Cada paso de una transacción (creación, avance, cancelación) es un
+// único registro que implica sus débitos y créditos; los movimientos de
+// saldo directos van aparte.
+//
+// Archivo: con habilitarArchivo() solo las últimas 'ventana' transacciones
+// quedan en memoria; archivarTerminadas() pasa al disco las terminadas más
+// antiguas y las que siguen activas se conservan aparte (rezagadas) hasta
+// que terminen. Es un cambio de estructura más y además invalida los
+// punteros a Transaccion obtenidos antes.
+class SistemaBovedas : public ObservadorBoveda {
 private:
+    // Transacción junto con sus extremos ya resueltos en el registro
+    struct EntradaTransaccion {
+        Transaccion* transaccion;
+        std::size_t numero;
+        HandleBoveda origen;
+        HandleBoveda destino;
+        Boveda* bovedaOrigen;
+        Boveda* bovedaDestino;
+    };
+    
+    // Transacción ya validada, lista para crear (ver crearTransaccionesSinBloqueo)
+    struct TransaccionNueva {
+        std::string_view bancoOrigenCodigo;
+        std::string_view bovedaOrigenId;
+        std::string_view bancoDestinoCodigo;
+        std::string_view bovedaDestinoId;
+        Activo activo;
+        std::string_view transportadora;
+        double porcentajeComision;
+        HandleBoveda origen;
+        HandleBoveda destino;
+        double tasaADolares = 0.0; // Al reaplicar el diario, la congelada; 0: la vigente
+    };
+    
+    struct alignas(64) BloqueoTransaccion {
+        std::mutex mutex;
+    };
+    static constexpr std::size_t NUM_BLOQUEOS_TRANSACCION = 64;
+    
     std::map<std::string, std::unique_ptr<Banco>> bancos;
-    std::vector<std::unique_ptr<Transaccion>> transacciones;
+    RegistroBovedas registro;
+    std::unique_ptr<AlmacenSaldos> almacen; // Opcional, ver habilitarAlmacenColumnar()
+    AcumuladorSaldos totales; // Totales del sistema, alimentados por los de cada banco
+    ArenaTransacciones transacciones; // Propietario; las altas solo bajo mutexCreacion
+    // Índice por número de transacción: el ID "TXN-000042" ocupa la posición 42
+    // (42 - U si la instantánea llega hasta la transacción U, ver entradaEn).
+    // Se lee sin bloqueos; las altas se serializan con mutexCreacion.
+    VectorSegmentado<EntradaTransaccion> indiceTransacciones;
+    std::mutex mutexCreacion;
+    // Transacciones en curso por estado, bóveda, banco y transportadora, y
+    // conteo por estado; se actualiza bajo el bloqueo de cada transacción
+    IndicesTransacciones indices;
+    std::array<BloqueoTransaccion, NUM_BLOQUEOS_TRANSACCION> bloqueosTransacciones;
     std::mt19937 generador;
     int contadorTransacciones;
+    std::unique_ptr<Diario> diario; // Opcional, ver habilitarDiario()
+    std::int64_t instanteReaplicado; // Instante del movimiento del diario que se está reaplicando (0 fuera de la recuperación)
+    
+    std::unique_ptr<HistorialSaldos> historial; // Opcional, ver habilitarHistorial()
+    
+    // Instantánea cargada: sus transacciones (números primera..ultima) se leen
+    // del archivo proyectado y se materializan la primera vez que se consultan
+    std::unique_ptr<Instantanea> instantanea;
+    std::size_t primeraEnInstantanea;
+    std::size_t ultimaEnInstantanea; // Las posteriores están en indiceTransacciones
+    std::vector<HandleBoveda> handlesInstantanea; // Posición de bóveda en el archivo -> handle
+    std::unique_ptr<std::atomic<Transaccion*>[]> materializadas; // Indexado por número - primeraEnInstantanea
+    mutable std::mutex mutexMaterializacion;
+    mutable std::unique_ptr<ArenaTransacciones> transaccionesMaterializadas; // Altas solo bajo mutexMaterializacion
+    
+    // Archivo de transacciones terminadas (opcional, ver habilitarArchivo()).
+    // Los números menores a primeraRetenida están archivados o en rezagadas;
+    // ambos solo cambian en archivarTerminadas() y al cargar la instantánea.
+    struct TransaccionRezagada {
+        std::unique_ptr<Transaccion> transaccion;
+        EntradaTransaccion entrada;
+    };
+    std::unique_ptr<ArchivoTransacciones> archivo;
+    std::size_t ventanaArchivo;
+    std::size_t primeraRetenida;
+    std::unordered_map<std::size_t, TransaccionRezagada> rezagadas;
+    
+    MetricasNucleo metricas; // Vacía si se compila sin BOVEDAS_METRICAS
+    
+    // Notificación de cambios (opcional, ver habilitarNotificaciones()). Va
+    // última para que su hilo se detenga antes de destruir lo demás.
+    std::unique_ptr<PublicadorCambios> publicador;
 
 public:
     SistemaBovedas();
     
     // Inicialización del sistema
     void inicializarSistema();
+    // Igual, pero recupera el estado del diario en 'rutaDiario'; los activos
+    // aleatorios solo se asignan si el diario estaba vacío
+    void inicializarSistema(const std::string& rutaDiario,
+                            ModoDurabilidad modo = ModoDurabilidad::SINCRONO);
+    // Topología sintética de N bancos con M bóvedas (ver generador_topologia.h);
+    // la misma configuración da siempre el mismo sistema
+    void inicializarSistema(const ConfiguracionTopologia& topologia);
     void crearBancosIniciales();
+    // Sin semilla usa una aleatoria; con la misma semilla y los mismos bancos
+    // los saldos son idénticos
     void asignarActivosAleatorios();
+    void asignarActivosAleatorios(std::uint64_t semilla);
     
     // Manejo de bancos
     void agregarBanco(std::unique_ptr<Banco> banco);
     Banco* buscarBanco(const std::string& codigo);
     const std::map<std::string, std::unique_ptr<Banco>>& getBancos() const;
     
+    // Resolución de bóvedas a handles del registro global
+    HandleBoveda resolverBoveda(const std::string& codigoBanco, const std::string& idBoveda);
+    const RegistroBovedas& getRegistro() const;
+    
+    // Almacén columnar de saldos: conecta todas las bóvedas registradas para
+    // que las valuaciones sean reducciones sobre arreglos contiguos. Se puede
+    // volver a llamar para conectar bóvedas agregadas después.
+    void habilitarAlmacenColumnar();
+    const AlmacenSaldos* getAlmacen() const;
+    
+    // Diario de operaciones: reaplica los registros existentes sobre los
+    // bancos ya creados y desde ahí registra cada operación. Devuelve si se
+    // recuperó algún registro.
+    bool habilitarDiario(const std::string& ruta, ModoDurabilidad modo = ModoDurabilidad::SINCRONO);
+    
+    // Instantáneas binarias (ver instantanea.h). cargarInstantanea reemplaza a
+    // crearBancosIniciales y requiere un sistema vacío; si después se habilita
+    // el diario, solo se reaplican los registros posteriores a la instantánea.
+    // guardarInstantanea deja el archivo en disco y después rota el diario.
+    // Ninguna de las dos debe correr en paralelo con otras operaciones.
+    void cargarInstantanea(const std::string& ruta);
+    void guardarInstantanea(const std::string& ruta);
+    const Instantanea* getInstantanea() const;
+    
+    // Archivo en disco de transacciones terminadas: archivarTerminadas() deja
+    // en memoria las últimas 'ventana' transacciones (y las más antiguas que
+    // sigan activas) y devuelve cuántas archivó. Las archivadas se consultan
+    // con buscarTransaccionArchivada. Ambas son cambios de estructura.
+    // Acota la memoria de las transacciones, no la de todo el sistema: el
+    // historial de saldos, si está habilitado, guarda hasta su límite de
+    // eventos por bóveda, y la tabla de símbolos crece con cada banco y
+    // bóveda registrados.
+    void habilitarArchivo(const std::string& ruta, std::size_t ventana = 10000);
+    std::size_t archivarTerminadas();
+    const ArchivoTransacciones* getArchivo() const;
+    
+    // Historial de saldos para consultas a una fecha, con los últimos
+    // 'eventosPorBoveda' movimientos de cada bóveda (ver historial_saldos.h).
+    // Debe habilitarse antes de cargar la instantánea o el diario para que la
+    // recuperación conserve los instantes originales de cada movimiento; la
+    // instantánea guarda lo que conserva el historial y lo restaura al cargarla.
+    void habilitarHistorial(std::size_t eventosPorBoveda = HistorialSaldos::EVENTOS_POR_BOVEDA);
+    const HistorialSaldos* getHistorial() const;
+    
+    // Notificación de cambios: desde aquí cada movimiento de saldo, alta y
+    // cambio de estado de una transacción se publica en lotes (ver
+    // publicador_cambios.h). Es un cambio de estructura.
+    void habilitarNotificaciones(std::chrono::milliseconds intervalo = std::chrono::milliseconds(50));
+    PublicadorCambios* getPublicador();
+    
+    // Publica nuevas tasas a dólares en el proveedor global (ver
+    // tasas_cambio.h) y avisa a los suscriptores con la nueva época. Puede
+    // llamarse en cualquier momento; las lecturas no se bloquean.
+    std::uint64_t actualizarTasas(const std::array<double, NUM_TIPOS_ACTIVO>& aDolares);
+    
+    SaldosBoveda getSaldosBovedaEn(const std::string& codigoBanco, const std::string& idBoveda,
+                                   std::chrono::system_clock::time_point instante);
+    SaldosBoveda getSaldosBancoEn(const std::string& codigoBanco, std::chrono::system_clock::time_point instante);
+    
+    // ObservadorBoveda: registra los movimientos de saldo en el diario y el historial
+    void saldoModificado(const Boveda& boveda, TipoActivo tipo, Monto delta) override;
+    void observacionIniciada(const Boveda& boveda, const SaldosBoveda& saldos) override;
+    
     // Operaciones de transferencia
     std::string iniciarTransferencia(const std::string& bancoOrigenCodigo,
                                    const std::string& bovedaOrigenId,
@@ -38,28 +246,148 @@ public:
                                    const std::string& transportadora = "Transportes Seguros SA",
                                    double porcentajeComision = 0.05);
     
+    // Variantes sin excepciones: los rechazos habituales (saldo insuficiente,
+    // banco/bóveda/transacción inexistente, datos inválidos) vuelven como
+    // Resultado y el mensaje solo se arma si se pide
+    Resultado<std::string> intentarIniciarTransferencia(const std::string& bancoOrigenCodigo,
+                                                       const std::string& bovedaOrigenId,
+                                                       const std::string& bancoDestinoCodigo,
+                                                       const std::string& bovedaDestinoId,
+                                                       TipoActivo tipoActivo,
+                                                       double cantidad,
+                                                       const std::string& transportadora = "Transportes Seguros SA",
+                                                       double porcentajeComision = 0.05);
+    Resultado<void> intentarProcesarTransaccion(const std::string& transaccionId);
+    Resultado<void> intentarAvanzarEtapaTransaccion(const std::string& transaccionId);
+    // Avanza solo si la transacción sigue en 'desde' (se comprueba bajo su
+    // bloqueo); si otro la movió devuelve OPERACION_INVALIDA sin tocarla
+    Resultado<void> intentarAvanzarEtapaTransaccion(const std::string& transaccionId, EstadoTransaccion desde);
+    
+    // Valida y crea muchas transferencias en una sola llamada: cada bóveda se
+    // resuelve una vez y las salidas acumuladas por bóveda se comparan contra
+    // su saldo (no solo cada salida por separado)
+    std::vector<ResultadoTransferencia> iniciarTransferenciasLote(const std::vector<SolicitudTransferencia>& solicitudes,
+                                                                 ModoLote modo = ModoLote::POR_ELEMENTO);
+    
     void procesarTransaccion(const std::string& transaccionId);
+    // Avanza una sola etapa con sus efectos en los saldos: el retiro del origen
+    // al salir de PREPARACION y el abono al destino al completar
+    void avanzarEtapaTransaccion(const std::string& transaccionId);
     void avanzarEstadoTransaccion(const std::string& transaccionId);
     void cancelarTransaccion(const std::string& transaccionId, const std::string& razon);
     
     // Consultas
     Transaccion* buscarTransaccion(const std::string& id);
+    // Copia independiente de una transacción ya archivada (se lee del disco)
+    std::unique_ptr<Transaccion> buscarTransaccionArchivada(const std::string& id) const;
+    // En orden de número; cuesta lo que haya activo, no el historial
     std::vector<Transaccion*> getTransaccionesActivas();
+    // Las que siguen en memoria (todas si no hay archivo), en orden de número
     std::vector<Transaccion*> getTodasLasTransacciones();
+    // Las 'cantidad' más recientes que siguen en memoria, la última primero
+    std::vector<Transaccion*> getUltimasTransacciones(std::size_t cantidad);
+    
+    // Consultas sobre las transacciones en curso por índices secundarios:
+    // cuestan lo que el resultado y se devuelven en orden de número. La de
+    // bóveda y la de banco incluyen las que salen y las que llegan.
+    // getTransaccionesEnEstado solo acepta estados en curso (PREPARACION..ENTREGA).
+    std::vector<Transaccion*> getTransaccionesEnEstado(EstadoTransaccion estado);
+    std::vector<Transaccion*> getTransaccionesEnCursoDeBoveda(const std::string& codigoBanco, const std::string& idBoveda);
+    std::vector<Transaccion*> getTransaccionesEnCursoDeBanco(const std::string& codigoBanco);
+    std::vector<Transaccion*> getTransaccionesEnCursoDeTransportadora(const std::string& transportadora);
+    
+    // Cantidad de transacciones en cada EstadoTransaccion (indexado por el
+    // valor del enum), incluidas las archivadas; O(1)
+    std::array<std::size_t, NUM_ESTADOS_TRANSACCION> contarTransaccionesPorEstado() const;
+    // Todas las creadas, archivadas o no
+    std::size_t getCantidadTransacciones() const;
+    // Número de una transacción a partir de su ID ("TXN-000042" -> 42)
+    static bool extraerNumeroTransaccion(const std::string& id, std::size_t& numero);
     
-    // Información del sistema
+    // Latencias, cantidades y errores de iniciar, procesar, avanzar, cancelar
+    // y buscar transacciones (ver metricas.h)
+    ResumenMetricas getMetricas() const;
+    void reiniciarMetricas();
+    
+    // Totales incrementales del sistema y verificación contra un recálculo
+    // completo. La verificación compara fotos tomadas en momentos distintos:
+    // solo es concluyente sin movimientos en curso.
+    const AcumuladorSaldos& getTotales() const;
+    bool verificarTotales() const;
+    
+    // Información del sistema, como texto en memoria
     std::string getResumenGeneral() const;
     std::string getEstadoBancos() const;
     std::string getEstadoTransacciones() const;
     
+    // Los mismos reportes en streaming (ver reporte.h), en cualquier formato:
+    // se escriben registro por registro sin armarlos completos en memoria.
+    // El llamador termina el escritor; escribirReporte escribe los tres.
+    void escribirResumenGeneral(EscritorReporte& escritor) const;
+    void escribirEstadoBancos(EscritorReporte& escritor) const;
+    void escribirEstadoTransacciones(EscritorReporte& escritor) const;
+    void escribirReporte(EscritorReporte& escritor) const;
+    
 private:
-    std::string generarIdTransaccion();
+    static std::string formatearIdTransaccion(std::size_t numero);
+    // Entrada/transacción con ese número (1..getCantidadTransacciones(), no
+    // archivada), materializándola desde la instantánea si hace falta
+    EntradaTransaccion entradaEn(std::size_t numero) const;
+    Transaccion* transaccionEn(std::size_t numero) const;
+    Transaccion* materializar(std::size_t numero) const;
+    // Crea las transacciones todas o ninguna y devuelve el número de la
+    // primera (las demás siguen en orden). Primero se construyen y se anexa
+    // su registro al diario (un INICIAR, o un LOTE si son varias); si algo
+    // falla hasta ahí se descartan sin que nadie las haya visto. Recién
+    // después se publican en los índices. Requiere mutexCreacion tomado.
+    std::size_t crearTransaccionesSinBloqueo(const TransaccionNueva* nuevas, std::size_t cantidad);
+    EntradaTransaccion buscarEntrada(const std::string& id) const;
+    Resultado<EntradaTransaccion> intentarBuscarEntrada(const std::string& id) const;
+    std::mutex& bloqueoDe(const EntradaTransaccion& entrada);
+    ClaveIndice claveDe(const EntradaTransaccion& entrada) const;
+    // Lleva el cambio de estado a los índices; requiere el bloqueo de la transacción
+    void actualizarIndices(const EntradaTransaccion& entrada, EstadoTransaccion anterior);
+    // Números del índice -> transacciones que siguen en curso, en orden
+    std::vector<Transaccion*> transaccionesEnCurso(std::vector<std::size_t> numeros) const;
+    static bool estaTerminada(EstadoTransaccion estado);
+    // Números retenidos en memoria (rezagadas y primeraRetenida..total), en orden
+    template <typename Funcion> void recorrerRetenidas(Funcion funcion) const;
+    static TransaccionArchivada archivadaDe(const EntradaTransaccion& entrada);
+    TransaccionArchivada archivadaDeInstantanea(std::size_t numero, const TransaccionInstantanea& guardada) const;
+    static TransaccionInstantanea guardarTransaccion(EscritorInstantanea& escritor, const Transaccion& transaccion,
+                                                     std::uint32_t bovedaOrigen, std::uint32_t bovedaDestino);
+    // Requieren el bloqueo de la transacción tomado. Cada paso deja un solo
+    // registro en el diario (AVANZAR o CANCELAR) que implica sus movimientos
+    // de saldo; al reaplicarlo se vuelven a ejecutar estas mismas funciones.
+    Resultado<void> avanzarEtapaSinBloqueo(const EntradaTransaccion& entrada);
+    void cancelarSinBloqueo(const EntradaTransaccion& entrada, const std::string& razon);
+    // Cuerpos de las operaciones medidas; las públicas los envuelven en metricas.medir()
+    Resultado<std::string> iniciarTransferenciaSinMedir(const std::string& bancoOrigenCodigo,
+                                                        const std::string& bovedaOrigenId,
+                                                        const std::string& bancoDestinoCodigo,
+                                                        const std::string& bovedaDestinoId,
+                                                        TipoActivo tipoActivo,
+                                                        double cantidad,
+                                                        const std::string& transportadora,
+                                                        double porcentajeComision);
+    Resultado<void> procesarTransaccionSinMedir(const std::string& transaccionId);
+    Resultado<void> avanzarEtapaSinMedir(const std::string& transaccionId, const EstadoTransaccion* desde);
+    void cancelarTransaccionSinMedir(const std::string& transaccionId, const std::string& razon);
+    bool almacenCubreTodasLasBovedas() const;
+    void aplicarRegistroDiario(const RegistroDiario& registroDiario);
+    void restaurarHistorial(const Instantanea& cargada, const SerieHistorialInstantanea& guardada, const Boveda& boveda);
+    static RegistroDiario registroDeTransaccion(TipoRegistroDiario tipo, const EntradaTransaccion& entrada);
+    void registrarEnDiario(const RegistroDiario& registroDiario);
+    // LSN a esperar para la operación en curso (0 sin diario); se lee con los bloqueos tomados
+    std::uint64_t lsnActual();
+    void esperarDiario(std::uint64_t lsn);
     double generarCantidadAleatoria(double min, double max);
-    void validarTransferencia(const std::string& bancoOrigenCodigo,
-                             const std::string& bovedaOrigenId,
-                             const std::string& bancoDestinoCodigo,
-                             const std::string& bovedaDestinoId,
-                             const Activo& activo);
+    // Devuelve los handles de origen y destino ya validados
+    Resultado<std::pair<HandleBoveda, HandleBoveda>> validarTransferencia(const std::string& bancoOrigenCodigo,
+                                                                         const std::string& bovedaOrigenId,
+                                                                         const std::string& bancoDestinoCodigo,
+                                                                         const std::string& bovedaDestinoId,
+                                                                         const Activo& activo);
 };
 
 #endif // SISTEMA_BOVEDAS_H
@@ -0,0 +1,56 @@
+#include "tabla_simbolos.h"
+#include "exceptions.h"
+#include <mutex>
+
+TablaSimbolos::TablaSimbolos() {
+    vistas.agregar(std::string_view());
+    indice.emplace(std::string_view(), VACIO);
+}
+
+Simbolo TablaSimbolos::internar(std::string_view texto) {
+    {
+        std::shared_lock<std::shared_mutex> bloqueo(mutex);
+        auto it = indice.find(texto);
+        if (it != indice.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> bloqueo(mutex);
+    // Otro hilo pudo internarlo entre los dos bloqueos
+    auto it = indice.find(texto);
+    if (it != indice.end()) {
+        return it->second;
+    }
+    Simbolo simbolo = static_cast<Simbolo>(vistas.size());
+    std::string_view guardado = textos.emplace_back(texto);
+    vistas.agregar(guardado);
+    indice.emplace(guardado, simbolo);
+    return simbolo;
+}
+
+bool TablaSimbolos::buscar(std::string_view texto, Simbolo& simbolo) const {
+    std::shared_lock<std::shared_mutex> bloqueo(mutex);
+    auto it = indice.find(texto);
+    if (it == indice.end()) {
+        return false;
+    }
+    simbolo = it->second;
+    return true;
+}
+
+std::string_view TablaSimbolos::getTexto(Simbolo simbolo) const {
+    if (simbolo >= vistas.size()) {
+        throw ErrorInternoSistemaException("Símbolo inválido: " + std::to_string(simbolo));
+    }
+    return vistas[simbolo];
+}
+
+std::size_t TablaSimbolos::size() const {
+    return vistas.size();
+}
+
+TablaSimbolos& TablaSimbolos::global() {
+    static TablaSimbolos tabla;
+    return tabla;
+}
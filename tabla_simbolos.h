@@ -0,0 +1,50 @@
+#ifndef TABLA_SIMBOLOS_H
+#define TABLA_SIMBOLOS_H
+
+#include "vector_segmentado.h"
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Identificador compacto de una cadena internada
+using Simbolo = std::uint32_t;
+
+// Tabla de cadenas internadas para los identificadores que se repiten en
+// millones de transacciones. Cada texto distinto se guarda una sola vez y
+// nunca se mueve ni se libera, así que los string_view que devuelve getTexto()
+// valen mientras viva la tabla. Por eso solo se internan conjuntos cerrados
+// (códigos de banco, IDs de bóveda); el texto libre que llega con cada
+// transacción (transportadora, observaciones) crecería sin límite.
+// getTexto() no toma bloqueos; internar() solo toma el exclusivo la primera
+// vez que ve un texto.
+class TablaSimbolos {
+private:
+    mutable std::shared_mutex mutex;
+    std::deque<std::string> textos; // Almacenamiento estable
+    std::unordered_map<std::string_view, Simbolo> indice;
+    // Segmentos de 1024 símbolos; hasta 4M de símbolos distintos
+    VectorSegmentado<std::string_view, 10, 4096> vistas;
+
+public:
+    // El símbolo 0 es siempre la cadena vacía
+    static constexpr Simbolo VACIO = 0;
+
+    TablaSimbolos();
+
+    TablaSimbolos(const TablaSimbolos&) = delete;
+    TablaSimbolos& operator=(const TablaSimbolos&) = delete;
+
+    Simbolo internar(std::string_view texto);
+    // Como internar(), pero sin agregar: devuelve false si el texto no está
+    bool buscar(std::string_view texto, Simbolo& simbolo) const;
+    std::string_view getTexto(Simbolo simbolo) const;
+    std::size_t size() const;
+
+    // Tabla compartida por todas las transacciones del proceso
+    static TablaSimbolos& global();
+};
+
+#endif // TABLA_SIMBOLOS_H
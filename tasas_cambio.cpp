@@ -0,0 +1,68 @@
+#include "tasas_cambio.h"
+#include "exceptions.h"
+#include <cmath>
+
+double TasasCambio::valuar(const SaldosBoveda& saldos) const {
+    double total = 0.0;
+    for (std::size_t i = 0; i < NUM_TIPOS_ACTIVO; ++i) {
+        total += saldos[i].aDouble() * aDolares[i];
+    }
+    return total;
+}
+
+ValuacionSaldos::ValuacionSaldos() : saldos{}, epoca(0), valor(0.0) {}
+
+bool ValuacionSaldos::actualizar(const SaldosBoveda& saldos, const TasasCambio& tasas) {
+    if (epoca == tasas.epoca && saldos == this->saldos) {
+        return false;
+    }
+    this->saldos = saldos;
+    epoca = tasas.epoca;
+    valor = tasas.valuar(saldos);
+    return true;
+}
+
+bool ValuacionSaldos::revaluar(const TasasCambio& tasas) {
+    return actualizar(saldos, tasas);
+}
+
+ProveedorTasas::ProveedorTasas() {
+    // Tasas de referencia hasta que llegue la primera actualización
+    std::array<double, NUM_TIPOS_ACTIVO> referencia{};
+    referencia[Activo::indice(TipoActivo::SOLES)] = 0.27;  // 1 sol ≈ 0.27 USD
+    referencia[Activo::indice(TipoActivo::DOLARES)] = 1.0;
+    referencia[Activo::indice(TipoActivo::JOYAS)] = 50.0;  // 1 unidad de joya ≈ 50 USD
+    std::atomic_store(&actuales, std::make_shared<const TasasCambio>(TasasCambio{1, referencia}));
+}
+
+std::uint64_t ProveedorTasas::publicar(const std::array<double, NUM_TIPOS_ACTIVO>& aDolares) {
+    std::lock_guard<std::mutex> bloqueo(mutexPublicacion);
+    return publicarSinBloqueo(aDolares);
+}
+
+std::uint64_t ProveedorTasas::actualizarTasa(TipoActivo tipo, double aDolares) {
+    std::lock_guard<std::mutex> bloqueo(mutexPublicacion);
+    std::array<double, NUM_TIPOS_ACTIVO> tasas = getActuales()->aDolares;
+    tasas[Activo::indice(tipo)] = aDolares;
+    return publicarSinBloqueo(tasas);
+}
+
+std::uint64_t ProveedorTasas::publicarSinBloqueo(const std::array<double, NUM_TIPOS_ACTIVO>& aDolares) {
+    for (double tasa : aDolares) {
+        if (!std::isfinite(tasa) || tasa <= 0) {
+            throw DatosInvalidosException("Las tasas de cambio deben ser positivas");
+        }
+    }
+    if (aDolares[Activo::indice(TipoActivo::DOLARES)] != 1.0) {
+        throw DatosInvalidosException("La tasa del dólar debe ser 1");
+    }
+
+    std::uint64_t epoca = getActuales()->epoca + 1;
+    std::atomic_store(&actuales, std::make_shared<const TasasCambio>(TasasCambio{epoca, aDolares}));
+    return epoca;
+}
+
+ProveedorTasas& ProveedorTasas::getGlobal() {
+    static ProveedorTasas global;
+    return global;
+}
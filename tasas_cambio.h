@@ -0,0 +1,76 @@
+#ifndef TASAS_CAMBIO_H
+#define TASAS_CAMBIO_H
+
+#include "boveda.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// Tasas a dólares de una época. Inmutable una vez publicada: quien la tiene
+// valúa todo con las mismas tasas aunque se publique otra en el medio.
+struct TasasCambio {
+    std::uint64_t epoca;
+    std::array<double, NUM_TIPOS_ACTIVO> aDolares; // Indexado por TipoActivo
+
+    double getTasa(TipoActivo tipo) const { return aDolares[Activo::indice(tipo)]; }
+    double valuar(const SaldosBoveda& saldos) const;
+};
+
+// Valor en dólares de unos saldos, recordado junto con los saldos y la época
+// con que se calculó: actualizar() solo vuelve a valuar si cambió alguno de
+// los dos, y revaluar() pasa a otra época sin volver a leer los saldos. La
+// llenan Boveda::valuar, Banco::valuar y AcumuladorSaldos::valuar. No es
+// segura entre hilos: cada consumidor (una fila del dashboard) tiene la suya.
+class ValuacionSaldos {
+private:
+    SaldosBoveda saldos;
+    std::uint64_t epoca; // 0 mientras no se calculó (las épocas empiezan en 1)
+    double valor;
+
+public:
+    ValuacionSaldos();
+
+    // Devuelven true si cambiaron los saldos o la época
+    bool actualizar(const SaldosBoveda& saldos, const TasasCambio& tasas);
+    bool revaluar(const TasasCambio& tasas);
+
+    const SaldosBoveda& getSaldos() const { return saldos; }
+    double getValor() const { return valor; }
+    std::uint64_t getEpoca() const { return epoca; }
+};
+
+// Tabla de tasas versionada al estilo RCU. Leer es un std::atomic_load del
+// shared_ptr, sin esperar a los que publican; publicar copia la tabla, le
+// asigna la época siguiente y cambia el puntero con std::atomic_store. Cada
+// versión vive mientras alguien tenga su shared_ptr: la última copia en
+// soltarse la libera, así que las actualizaciones no acumulan memoria.
+//
+// Hay una tabla global (getGlobal) que es la que usan Activo::getTasaADolares
+// y todas las valuaciones; arranca con las tasas de referencia en la época 1.
+class ProveedorTasas {
+private:
+    std::shared_ptr<const TasasCambio> actuales; // Solo con std::atomic_load/atomic_store
+    std::mutex mutexPublicacion; // Serializa a los que publican
+
+    // Requiere mutexPublicacion tomado
+    std::uint64_t publicarSinBloqueo(const std::array<double, NUM_TIPOS_ACTIVO>& aDolares);
+
+public:
+    ProveedorTasas();
+    ProveedorTasas(const ProveedorTasas&) = delete;
+    ProveedorTasas& operator=(const ProveedorTasas&) = delete;
+
+    // La versión devuelta sigue valiendo aunque se publique otra
+    std::shared_ptr<const TasasCambio> getActuales() const { return std::atomic_load(&actuales); }
+    std::uint64_t getEpoca() const { return getActuales()->epoca; }
+
+    // Publican una nueva época y la devuelven. Las tasas deben ser finitas y
+    // positivas, y la del dólar siempre 1.
+    std::uint64_t publicar(const std::array<double, NUM_TIPOS_ACTIVO>& aDolares);
+    std::uint64_t actualizarTasa(TipoActivo tipo, double aDolares);
+
+    static ProveedorTasas& getGlobal();
+};
+
+#endif // TASAS_CAMBIO_H
@@ -1,49 +1,90 @@
 #include "transaccion.h"
 #include "exceptions.h"
+#include <cmath>
 #include <sstream>
 #include <iomanip>
 
 Transaccion::Transaccion(const std::string& id,
-                        const std::string& bancoOrigenCodigo,
-                        const std::string& bovedaOrigenId,
-                        const std::string& bancoDestinoCodigo,
-                        const std::string& bovedaDestinoId,
+                        std::string_view bancoOrigenCodigo,
+                        std::string_view bovedaOrigenId,
+                        std::string_view bancoDestinoCodigo,
+                        std::string_view bovedaDestinoId,
                         const Activo& activo,
-                        const std::string& transportadora,
+                        std::string_view transportadora,
                         double porcentajeComision)
-    : id(id), bancoOrigenCodigo(bancoOrigenCodigo), bovedaOrigenId(bovedaOrigenId),
-      bancoDestinoCodigo(bancoDestinoCodigo), bovedaDestinoId(bovedaDestinoId),
-      activo(activo), estado(EstadoTransaccion::PREPARACION),
-      transportadora(transportadora), porcentajeComision(porcentajeComision),
-      fechaCreacion(std::chrono::system_clock::now()) {
+    : Transaccion(nullptr, std::make_unique<DatosFriosTransaccion>(), id,
+                  bancoOrigenCodigo, bovedaOrigenId, bancoDestinoCodigo, bovedaDestinoId,
+                  activo, transportadora, porcentajeComision) {
+}
+
+Transaccion::Transaccion(DatosFriosTransaccion& frios,
+                        const std::string& id,
+                        std::string_view bancoOrigenCodigo,
+                        std::string_view bovedaOrigenId,
+                        std::string_view bancoDestinoCodigo,
+                        std::string_view bovedaDestinoId,
+                        const Activo& activo,
+                        std::string_view transportadora,
+                        double porcentajeComision)
+    : Transaccion(&frios, nullptr, id,
+                  bancoOrigenCodigo, bovedaOrigenId, bancoDestinoCodigo, bovedaDestinoId,
+                  activo, transportadora, porcentajeComision) {
+}
+
+Transaccion::Transaccion(DatosFriosTransaccion* friosExternos,
+                        std::unique_ptr<DatosFriosTransaccion> friosPropios,
+                        const std::string& id,
+                        std::string_view bancoOrigenCodigo,
+                        std::string_view bovedaOrigenId,
+                        std::string_view bancoDestinoCodigo,
+                        std::string_view bovedaDestinoId,
+                        const Activo& activo,
+                        std::string_view transportadora,
+                        double porcentajeComision)
+    : estado(EstadoTransaccion::PREPARACION), activo(activo), porcentajeComision(porcentajeComision),
+      frios(friosExternos ? friosExternos : friosPropios.get()), friosPropios(std::move(friosPropios)) {
     
     if (porcentajeComision < 0 || porcentajeComision > 1) {
         throw DatosInvalidosException("El porcentaje de comisión debe estar entre 0 y 1");
     }
     
+    TablaSimbolos& simbolos = TablaSimbolos::global();
+    this->bancoOrigenCodigo = simbolos.internar(bancoOrigenCodigo);
+    this->bovedaOrigenId = simbolos.internar(bovedaOrigenId);
+    this->bancoDestinoCodigo = simbolos.internar(bancoDestinoCodigo);
+    this->bovedaDestinoId = simbolos.internar(bovedaDestinoId);
+    
+    // Los datos fríos pueden venir de un arena que reutiliza la posición
+    frios->id = id;
+    frios->transportadora = transportadora;
+    frios->tasaADolares = Activo::getTasaADolares(activo.getTipo());
+    frios->fechaCreacion = std::chrono::system_clock::now();
+    frios->fechaCompletada = {};
+    std::atomic_store(&frios->observaciones, std::shared_ptr<const std::string>());
+    
     // Determinar el tipo de transacción
-    tipo = (bancoOrigenCodigo == bancoDestinoCodigo) ? 
+    tipo = (this->bancoOrigenCodigo == this->bancoDestinoCodigo) ? 
            TipoTransaccion::INTRABANCARIA : TipoTransaccion::INTERBANCARIA;
 }
 
-std::string Transaccion::getId() const {
-    return id;
+std::string_view Transaccion::getId() const {
+    return frios->id;
 }
 
-std::string Transaccion::getBancoOrigenCodigo() const {
-    return bancoOrigenCodigo;
+std::string_view Transaccion::getBancoOrigenCodigo() const {
+    return TablaSimbolos::global().getTexto(bancoOrigenCodigo);
 }
 
-std::string Transaccion::getBovedaOrigenId() const {
-    return bovedaOrigenId;
+std::string_view Transaccion::getBovedaOrigenId() const {
+    return TablaSimbolos::global().getTexto(bovedaOrigenId);
 }
 
-std::string Transaccion::getBancoDestinoCodigo() const {
-    return bancoDestinoCodigo;
+std::string_view Transaccion::getBancoDestinoCodigo() const {
+    return TablaSimbolos::global().getTexto(bancoDestinoCodigo);
 }
 
-std::string Transaccion::getBovedaDestinoId() const {
-    return bovedaDestinoId;
+std::string_view Transaccion::getBovedaDestinoId() const {
+    return TablaSimbolos::global().getTexto(bovedaDestinoId);
 }
 
 Activo Transaccion::getActivo() const {
@@ -58,16 +99,29 @@ TipoTransaccion Transaccion::getTipo() const {
     return tipo;
 }
 
-std::string Transaccion::getTransportadora() const {
-    return transportadora;
+std::string_view Transaccion::getTransportadora() const {
+    return frios->transportadora;
 }
 
 double Transaccion::getPorcentajeComision() const {
     return porcentajeComision;
 }
 
+double Transaccion::getTasaADolares() const {
+    return frios->tasaADolares;
+}
+
 std::string Transaccion::getObservaciones() const {
-    return observaciones;
+    std::shared_ptr<const std::string> observaciones = std::atomic_load(&frios->observaciones);
+    return observaciones ? *observaciones : std::string();
+}
+
+std::chrono::system_clock::time_point Transaccion::getFechaCreacion() const {
+    return frios->fechaCreacion;
+}
+
+std::chrono::system_clock::time_point Transaccion::getFechaCompletada() const {
+    return frios->fechaCompletada;
 }
 
 void Transaccion::avanzarEstado() {
@@ -82,8 +136,8 @@ void Transaccion::avanzarEstado() {
             estado = EstadoTransaccion::ENTREGA;
             break;
         case EstadoTransaccion::ENTREGA:
+            frios->fechaCompletada = std::chrono::system_clock::now();
             estado = EstadoTransaccion::COMPLETADA;
-            fechaCompletada = std::chrono::system_clock::now();
             break;
         case EstadoTransaccion::COMPLETADA:
             throw OperacionInvalidaException("La transacción ya está completada");
@@ -96,8 +150,26 @@ void Transaccion::cancelar(const std::string& razon) {
     if (estado == EstadoTransaccion::COMPLETADA) {
         throw OperacionInvalidaException("No se puede cancelar una transacción completada");
     }
+    std::atomic_store(&frios->observaciones, std::make_shared<const std::string>(razon));
     estado = EstadoTransaccion::CANCELADA;
-    observaciones = razon;
+}
+
+void Transaccion::restaurar(EstadoTransaccion estado,
+                            std::chrono::system_clock::time_point fechaCreacion,
+                            std::chrono::system_clock::time_point fechaCompletada,
+                            const std::string& observaciones) {
+    frios->fechaCreacion = fechaCreacion;
+    frios->fechaCompletada = fechaCompletada;
+    std::atomic_store(&frios->observaciones, observaciones.empty() ? std::shared_ptr<const std::string>()
+                                                                   : std::make_shared<const std::string>(observaciones));
+    this->estado = estado;
+}
+
+void Transaccion::restaurarTasaADolares(double tasaADolares) {
+    if (!std::isfinite(tasaADolares) || tasaADolares <= 0) {
+        throw DatosInvalidosException("La tasa de cambio guardada de la transacción no es válida");
+    }
+    frios->tasaADolares = tasaADolares;
 }
 
 bool Transaccion::esIntrabancaria() const {
@@ -108,22 +180,23 @@ bool Transaccion::estaCompletada() const {
     return estado == EstadoTransaccion::COMPLETADA;
 }
 
-double Transaccion::getComision() const {
-    // Para joyas usamos el valor estimado, para monedas el valor nominal
-    double valorParaComision = activo.getCantidad();
+Monto Transaccion::getComision() const {
+    // Para joyas usamos el valor estimado con la tasa del día en que se
+    // creó la transacción, para monedas el valor nominal
+    Monto valorParaComision = activo.getMonto();
     if (activo.getTipo() == TipoActivo::JOYAS) {
-        valorParaComision *= 50.0; // Valor estimado por unidad de joya
+        valorParaComision = Monto::desdeUnidades(valorParaComision.aDouble() * frios->tasaADolares);
     }
-    return valorParaComision * porcentajeComision;
+    return valorParaComision.aplicarPorcentaje(porcentajeComision);
 }
 
 Activo Transaccion::getActivoNeto() const {
     // La comisión se descuenta del activo original
-    double cantidadNeta = activo.getCantidad();
+    Monto cantidadNeta = activo.getMonto();
     
     if (activo.getTipo() != TipoActivo::JOYAS) {
         // Para dinero, la comisión se descuenta directamente
-        cantidadNeta -= activo.getCantidad() * porcentajeComision;
+        cantidadNeta -= activo.getMonto().aplicarPorcentaje(porcentajeComision);
     }
     // Para joyas, la comisión se maneja por separado ya que no se pueden "dividir"
     
@@ -141,14 +214,15 @@ std::string Transaccion::getTipoString() const {
 std::string Transaccion::getResumen() const {
     std::stringstream ss;
     ss << std::fixed << std::setprecision(2);
-    ss << "Transacción ID: " << id << "\n";
+    ss << "Transacción ID: " << frios->id << "\n";
     ss << "Tipo: " << getTipoString() << "\n";
     ss << "Estado: " << getEstadoString() << "\n";
-    ss << "Origen: " << bancoOrigenCodigo << " - Bóveda " << bovedaOrigenId << "\n";
-    ss << "Destino: " << bancoDestinoCodigo << " - Bóveda " << bovedaDestinoId << "\n";
-    ss << "Activo: " << activo.getCantidad() << " " << activo.getTipoString() << "\n";
-    ss << "Transportadora: " << transportadora << "\n";
-    ss << "Comisión: " << (porcentajeComision * 100) << "% ($ " << getComision() << ")\n";
+    ss << "Origen: " << getBancoOrigenCodigo() << " - Bóveda " << getBovedaOrigenId() << "\n";
+    ss << "Destino: " << getBancoDestinoCodigo() << " - Bóveda " << getBovedaDestinoId() << "\n";
+    ss << "Activo: " << activo.getMonto().toString() << " " << activo.getTipoString() << "\n";
+    ss << "Transportadora: " << getTransportadora() << "\n";
+    ss << "Comisión: " << (porcentajeComision * 100) << "% ($ " << getComision().toString() << ")\n";
+    std::string observaciones = getObservaciones();
     if (!observaciones.empty()) {
         ss << "Observaciones: " << observaciones << "\n";
     }
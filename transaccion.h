@@ -2,10 +2,15 @@
 #define TRANSACCION_H
 
 #include "activo.h"
+#include "tabla_simbolos.h"
 #include <string>
+#include <string_view>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <memory>
 
-enum class EstadoTransaccion {
+enum class EstadoTransaccion : std::uint8_t {
     PREPARACION,
     RECOJO,
     TRANSPORTE,
@@ -14,49 +19,101 @@ enum class EstadoTransaccion {
     CANCELADA
 };
 
-enum class TipoTransaccion {
+constexpr std::size_t NUM_ESTADOS_TRANSACCION = 6;
+
+enum class TipoTransaccion : std::uint8_t {
     INTRABANCARIA,  // Entre bóvedas del mismo banco
     INTERBANCARIA   // Entre bóvedas de diferentes bancos
 };
 
+// Datos de la transacción que solo se leen al mostrarla o guardarla. Viven
+// aparte para que los recorridos por estado, monto y extremos no los traigan
+// a la caché.
+struct DatosFriosTransaccion {
+    std::string id;
+    std::string transportadora; // Texto libre: no se interna
+    double tasaADolares = 0.0;  // Del activo, vigente al crear la transacción
+    std::chrono::system_clock::time_point fechaCreacion;
+    std::chrono::system_clock::time_point fechaCompletada;
+    // Se reemplaza entera (std::atomic_store) al cancelar o restaurar, así
+    // que quien la leyó antes sigue teniendo una copia válida; nulo si no hay
+    std::shared_ptr<const std::string> observaciones;
+};
+
+// Los códigos de banco y los IDs de bóveda se guardan como símbolos de
+// TablaSimbolos::global(): son un conjunto cerrado que se repite en casi
+// todas las transacciones, así que cada una ocupa unos pocos bytes por
+// identificador. La transportadora es texto libre y va con los datos fríos.
+// El objeto guarda solo los datos calientes (una línea de caché); los fríos
+// los reserva ArenaTransacciones en una tabla paralela o, si la transacción
+// se crea suelta, la propia transacción.
 class Transaccion {
 private:
-    std::string id;
-    std::string bancoOrigenCodigo;
-    std::string bovedaOrigenId;
-    std::string bancoDestinoCodigo;
-    std::string bovedaDestinoId;
-    Activo activo;
-    EstadoTransaccion estado;
+    // Atómico para que otros hilos lean el estado mientras el sistema lo avanza;
+    // las fechas y observaciones se escriben antes de publicar el nuevo estado
+    std::atomic<EstadoTransaccion> estado;
     TipoTransaccion tipo;
-    std::string transportadora;
+    Simbolo bancoOrigenCodigo;
+    Simbolo bovedaOrigenId;
+    Simbolo bancoDestinoCodigo;
+    Simbolo bovedaDestinoId;
+    Activo activo;
     double porcentajeComision;
-    std::chrono::system_clock::time_point fechaCreacion;
-    std::chrono::system_clock::time_point fechaCompletada;
-    std::string observaciones;
+    DatosFriosTransaccion* frios;
+    std::unique_ptr<DatosFriosTransaccion> friosPropios; // Nulo dentro de un arena
+
+    Transaccion(DatosFriosTransaccion* friosExternos,
+                std::unique_ptr<DatosFriosTransaccion> friosPropios,
+                const std::string& id,
+                std::string_view bancoOrigenCodigo,
+                std::string_view bovedaOrigenId,
+                std::string_view bancoDestinoCodigo,
+                std::string_view bovedaDestinoId,
+                const Activo& activo,
+                std::string_view transportadora,
+                double porcentajeComision);
 
 public:
     Transaccion(const std::string& id,
-                const std::string& bancoOrigenCodigo,
-                const std::string& bovedaOrigenId,
-                const std::string& bancoDestinoCodigo,
-                const std::string& bovedaDestinoId,
+                std::string_view bancoOrigenCodigo,
+                std::string_view bovedaOrigenId,
+                std::string_view bancoDestinoCodigo,
+                std::string_view bovedaDestinoId,
                 const Activo& activo,
-                const std::string& transportadora = "Transportes Seguros SA",
+                std::string_view transportadora = "Transportes Seguros SA",
                 double porcentajeComision = 0.05);
+    // Usa 'frios' (que debe sobrevivir a la transacción) para los datos fríos
+    Transaccion(DatosFriosTransaccion& frios,
+                const std::string& id,
+                std::string_view bancoOrigenCodigo,
+                std::string_view bovedaOrigenId,
+                std::string_view bancoDestinoCodigo,
+                std::string_view bovedaDestinoId,
+                const Activo& activo,
+                std::string_view transportadora,
+                double porcentajeComision);
 
-    // Getters
-    std::string getId() const;
-    std::string getBancoOrigenCodigo() const;
-    std::string getBovedaOrigenId() const;
-    std::string getBancoDestinoCodigo() const;
-    std::string getBovedaDestinoId() const;
+    Transaccion(const Transaccion&) = delete;
+    Transaccion& operator=(const Transaccion&) = delete;
+
+    // Getters; las vistas no se invalidan mientras exista la transacción
+    std::string_view getId() const;
+    std::string_view getBancoOrigenCodigo() const;
+    std::string_view getBovedaOrigenId() const;
+    std::string_view getBancoDestinoCodigo() const;
+    std::string_view getBovedaDestinoId() const;
     Activo getActivo() const;
     EstadoTransaccion getEstado() const;
     TipoTransaccion getTipo() const;
-    std::string getTransportadora() const;
+    std::string_view getTransportadora() const;
     double getPorcentajeComision() const;
+    // Tasa del activo a dólares congelada al crear la transacción: la comisión
+    // de las joyas no cambia aunque después se publiquen otras tasas
+    double getTasaADolares() const;
+    // Por valor: cancelar() puede reemplazarlas mientras otro hilo las lee
     std::string getObservaciones() const;
+    std::chrono::system_clock::time_point getFechaCreacion() const;
+    std::chrono::system_clock::time_point getFechaCompletada() const;
     
     // Manejo de estado
     void avanzarEstado();
@@ -64,8 +121,16 @@ public:
     bool esIntrabancaria() const;
     bool estaCompletada() const;
     
+    // Restablece el estado guardado (instantáneas); no valida la secuencia de estados
+    void restaurar(EstadoTransaccion estado,
+                   std::chrono::system_clock::time_point fechaCreacion,
+                   std::chrono::system_clock::time_point fechaCompletada,
+                   const std::string& observaciones);
+    // Reemplaza la tasa congelada por la guardada (instantáneas, diario, archivo)
+    void restaurarTasaADolares(double tasaADolares);
+    
     // Cálculos
-    double getComision() const;
+    Monto getComision() const; // Expresada en la moneda del activo (en dólares para joyas)
     Activo getActivoNeto() const; // Activo menos comisión
     
     // Información
@@ -0,0 +1,95 @@
+#ifndef VECTOR_SEGMENTADO_H
+#define VECTOR_SEGMENTADO_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+// Arreglo que crece por segmentos de tamaño fijo y nunca mueve sus elementos.
+// Un único escritor a la vez (el llamador serializa agregar()) puede crecer
+// mientras otros hilos leen sin bloqueos cualquier posición menor a size():
+// el tamaño se publica con semántica release después de escribir el elemento.
+// Los parámetros fijan el tamaño de cada segmento y la cantidad máxima de
+// segmentos; los valores por defecto son para índices de millones de elementos.
+template <typename T, std::size_t BITS_SEGMENTO = 16, std::size_t MAX_SEGMENTOS = std::size_t(1) << 16>
+class VectorSegmentado {
+private:
+    static constexpr std::size_t TAM_SEGMENTO = std::size_t(1) << BITS_SEGMENTO;
+    
+    std::unique_ptr<std::atomic<T*>[]> segmentos;
+    std::atomic<std::size_t> tamano;
+
+public:
+    VectorSegmentado() : segmentos(new std::atomic<T*>[MAX_SEGMENTOS]), tamano(0) {
+        for (std::size_t i = 0; i < MAX_SEGMENTOS; ++i) {
+            segmentos[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+    
+    ~VectorSegmentado() {
+        for (std::size_t i = 0; i < MAX_SEGMENTOS; ++i) {
+            delete[] segmentos[i].load(std::memory_order_relaxed);
+        }
+    }
+    
+    VectorSegmentado(const VectorSegmentado&) = delete;
+    VectorSegmentado& operator=(const VectorSegmentado&) = delete;
+    
+    // Solo un escritor a la vez
+    void agregar(const T& valor) {
+        std::size_t i = tamano.load(std::memory_order_relaxed);
+        std::size_t s = i >> BITS_SEGMENTO;
+        if (s >= MAX_SEGMENTOS) {
+            throw std::length_error("VectorSegmentado: capacidad máxima alcanzada");
+        }
+        T* segmento = segmentos[s].load(std::memory_order_relaxed);
+        if (!segmento) {
+            segmento = new T[TAM_SEGMENTO]();
+            segmentos[s].store(segmento, std::memory_order_release);
+        }
+        segmento[i & (TAM_SEGMENTO - 1)] = valor;
+        tamano.store(i + 1, std::memory_order_release);
+    }
+    
+    // Reserva los segmentos para que los próximos 'cantidad' agregar() no pidan
+    // memoria ni fallen por capacidad. Solo el escritor.
+    void reservar(std::size_t cantidad) {
+        std::size_t tam = tamano.load(std::memory_order_relaxed);
+        if (cantidad == 0) {
+            return;
+        }
+        std::size_t ultimo = (tam + cantidad - 1) >> BITS_SEGMENTO;
+        if (ultimo >= MAX_SEGMENTOS) {
+            throw std::length_error("VectorSegmentado: capacidad máxima alcanzada");
+        }
+        for (std::size_t s = tam >> BITS_SEGMENTO; s <= ultimo; ++s) {
+            if (!segmentos[s].load(std::memory_order_relaxed)) {
+                segmentos[s].store(new T[TAM_SEGMENTO](), std::memory_order_release);
+            }
+        }
+    }
+    
+    // Acceso de escritura a un elemento ya publicado (sincronización a cargo del llamador)
+    T& operator[](std::size_t i) {
+        return segmentos[i >> BITS_SEGMENTO].load(std::memory_order_acquire)[i & (TAM_SEGMENTO - 1)];
+    }
+    
+    const T& operator[](std::size_t i) const {
+        return segmentos[i >> BITS_SEGMENTO].load(std::memory_order_acquire)[i & (TAM_SEGMENTO - 1)];
+    }
+    
+    std::size_t size() const {
+        return tamano.load(std::memory_order_acquire);
+    }
+    
+    // Libera los segmentos que quedan enteros por debajo de 'limite'; sus
+    // posiciones no se deben volver a leer. No debe haber lectores en curso.
+    void liberarHasta(std::size_t limite) {
+        for (std::size_t s = 0; s < (limite >> BITS_SEGMENTO) && s < MAX_SEGMENTOS; ++s) {
+            delete[] segmentos[s].exchange(nullptr, std::memory_order_acq_rel);
+        }
+    }
+};
+
+#endif // VECTOR_SEGMENTADO_H